@@ -0,0 +1,2 @@
+cl spirv_codec.c -Fespirv_codec.exe -O2 -MD
+cl startup.c -Festartup.exe -O2 -MD SDL3.lib psapi.lib
@@ -0,0 +1,3 @@
+#!/bin/bash
+gcc spirv_codec.c -o spirv_codec -O2
+gcc startup.c -o startup -O2 -lSDL3
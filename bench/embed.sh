@@ -0,0 +1,39 @@
+#!/bin/bash
+# Compares how long the host compiler takes on the generated C for each --embed mode.
+#
+# Usage: embed.sh SHADERS...
+# Expects a built shad (../cli) on the PATH or in $SHAD, and uses $CC (cc by default).
+# c23 is skipped if the compiler doesn't support #embed.
+set -e
+
+SHAD=${SHAD:-shad}
+CC=${CC:-cc}
+if [ $# -eq 0 ]; then
+    echo "Usage: $0 SHADERS..." >&2
+    exit 1
+fi
+
+dir=$(mktemp -d)
+trap 'rm -rf "$dir"' EXIT
+
+printf '#embed "%s"\n' /dev/null > "$dir/probe.c"
+has_embed=0
+$CC -std=c2x -fsyntax-only "$dir/probe.c" 2>/dev/null && has_embed=1
+
+TIMEFORMAT="%R s"
+for mode in array string c23 incbin; do
+    if [ $mode = c23 ] && [ $has_embed = 0 ]; then
+        echo "$mode: skipped, $CC doesn't support #embed"
+        continue
+    fi
+    mkdir -p "$dir/$mode"
+    "$SHAD" sdl3 --embed $mode "$@" -o "$dir/$mode/shaders.h" 2>/dev/null
+    printf '#include <SDL3/SDL.h>\n#include "shaders.h"\n' > "$dir/$mode/main.c"
+    echo -n "$mode: "
+    if [ $mode = incbin ]; then
+        time ( $CC -std=c2x -O2 -c "$dir/$mode/main.c" -o "$dir/$mode/main.o" &&
+               $CC -c "$dir/$mode/shaders.S" -o "$dir/$mode/shaders.o" )
+    else
+        time $CC -std=c2x -O2 -c "$dir/$mode/main.c" -o "$dir/$mode/main.o"
+    fi
+done
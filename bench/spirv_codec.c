@@ -0,0 +1,134 @@
+/* Measures how well the SPIRV encoding compresses, and how fast it decodes.
+
+   Usage: spirv_codec FILES...
+   where each file is either a SPIRV module (.spv) or a pack from `shad sdl3 --emit pack` */
+
+#define SHAD_NO_COMPILER
+#include "../shad.h"
+#include "../shad.c"
+
+#include <time.h>
+
+typedef struct Module {
+    char *spirv;
+    int size;
+} Module;
+
+static Module modules[65536];
+static int num_modules;
+
+char* read_file(const char *path, int *size_out) {
+    FILE *f = fopen(path, "rb");
+    char *data;
+    long size;
+    if (!f) return NULL;
+    fseek(f, 0, SEEK_END);
+    size = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    data = (char*)malloc(size ? size : 1);
+    if (fread(data, 1, size, f) != (size_t)size) {
+        free(data);
+        fclose(f);
+        return NULL;
+    }
+    fclose(f);
+    *size_out = (int)size;
+    return data;
+}
+
+void add_module(const char *spirv, int size) {
+    if (!size || num_modules == sizeof(modules)/sizeof(*modules)) return;
+    modules[num_modules].spirv = (char*)malloc(size);
+    memcpy(modules[num_modules].spirv, spirv, size);
+    modules[num_modules].size = size;
+    ++num_modules;
+}
+
+double seconds(void) {
+    return (double)clock() / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char **argv) {
+    ShadArena arena;
+    ShadWriter encoded;
+    int *offsets;
+    unsigned *decoded;
+    long long raw_size = 0;
+    int max_size = 0;
+    int i, iterations;
+    double start, elapsed;
+
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s FILES...\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 1; i < argc; ++i) {
+        int size;
+        char *data = read_file(argv[i], &size);
+        ShadPack pack;
+        if (!data) {
+            fprintf(stderr, "Error: Failed to read %s\n", argv[i]);
+            return 1;
+        }
+        if (shad_pack_open_memory(data, size, &pack)) {
+            int j;
+            for (j = 0; j < pack.num_entries; ++j) {
+                ShadCompilation sc;
+                if (!shad_pack_get_index(&pack, j, &sc)) continue;
+                add_module(sc.spirv_vertex_code, sc.spirv_vertex_code_size);
+                add_module(sc.spirv_fragment_code, sc.spirv_fragment_code_size);
+                shad_compilation_free(&sc);
+            }
+        } else {
+            add_module(data, size & ~3);
+        }
+        free(data);
+    }
+    if (!num_modules) {
+        fprintf(stderr, "Error: No SPIRV found\n");
+        return 1;
+    }
+
+    /* encode */
+    memset(&arena, 0, sizeof(arena));
+    memset(&encoded, 0, sizeof(encoded));
+    encoded.arena = &arena;
+    offsets = (int*)malloc(sizeof(int) * (num_modules+1));
+    start = seconds();
+    for (i = 0; i < num_modules; ++i) {
+        offsets[i] = encoded.len;
+        shad__spirv_encode(&encoded, modules[i].spirv, modules[i].size);
+        raw_size += modules[i].size;
+        max_size = SHAD_MAX(max_size, modules[i].size);
+    }
+    offsets[num_modules] = encoded.len;
+    elapsed = seconds() - start;
+
+    printf("modules:   %i\n", num_modules);
+    printf("raw:       %lld bytes\n", raw_size);
+    printf("encoded:   %i bytes (%.1f%%)\n", encoded.len, 100.0 * encoded.len / raw_size);
+    printf("encode:    %.1f MB/s\n", raw_size / 1e6 / (elapsed > 0 ? elapsed : 1e-9));
+
+    /* decode, enough times to get a stable number */
+    decoded = (unsigned*)malloc(max_size);
+    iterations = 0;
+    start = seconds();
+    do {
+        for (i = 0; i < num_modules; ++i) {
+            if (!shad__spirv_decode(encoded.buf + offsets[i], offsets[i+1] - offsets[i], decoded)) {
+                fprintf(stderr, "Error: Failed to decode module %i\n", i);
+                return 1;
+            }
+            if (!iterations && memcmp(decoded, modules[i].spirv, modules[i].size)) {
+                fprintf(stderr, "Error: Module %i didn't decode to the original\n", i);
+                return 1;
+            }
+        }
+        ++iterations;
+        elapsed = seconds() - start;
+    } while (elapsed < 1.0);
+    printf("decode:    %.1f MB/s (of decoded SPIRV)\n", raw_size * iterations / 1e6 / elapsed);
+
+    return 0;
+}
@@ -0,0 +1,222 @@
+/* Measures what loading precompiled shaders costs at start-up: shad_compilation_deserialize() and filling
+   the SDL create infos, for a synthetic set of compilations. No GPU device is created.
+
+   Usage: startup [COUNT]
+   COUNT is the number of compilations, 10000 by default */
+
+#include <SDL3/SDL.h>
+
+#define SHAD_NO_COMPILER
+#define SHAD_NO_THREADS
+#include "../shad.h"
+#include "../shad.c"
+
+#ifdef _WIN32
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <time.h>
+#endif
+
+typedef struct Blob {
+    char *bytes;
+    int size;
+} Blob;
+
+double seconds(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq, now;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart / freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+/* peak resident set size of the process so far, in MB */
+double peak_rss(void) {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS pmc;
+    GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc));
+    return pmc.PeakWorkingSetSize / 1e6;
+#elif defined(__APPLE__)
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1e6;
+#else
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss / 1e3;
+#endif
+}
+
+unsigned rng_state = 12345;
+unsigned rng(void) {
+    rng_state = rng_state * 1664525u + 1013904223u;
+    return rng_state >> 8;
+}
+
+/* something shaped like a SPIRV module. The content doesn't matter, nothing looks inside */
+char* make_spirv(ShadArena *arena, int *size_out) {
+    int num_words = 200 + rng() % 600;
+    unsigned *words = SHAD_ALLOC(unsigned, arena, num_words);
+    int i;
+    words[0] = 0x07230203u;
+    words[1] = 0x00010000u;
+    words[2] = 0x0008000bu;
+    words[3] = 64 + rng() % 256;
+    words[4] = 0;
+    for (i = 5; i < num_words; ++i)
+        words[i] = rng() % 8 ? rng() % 64 : rng();
+    *size_out = num_words * 4;
+    return (char*)words;
+}
+
+/* a compilation with a random vertex layout and outputs, serialized */
+Blob make_blob(void) {
+    static const ShadTextureFormat formats[] = {SHAD_TEXTURE_FORMAT_RGBA8, SHAD_TEXTURE_FORMAT_RGBA16F, SHAD_TEXTURE_FORMAT_R32F, SHAD_TEXTURE_FORMAT_RG16F};
+    ShadCompilation sc;
+    ShadArena *arena;
+    Blob blob;
+    char *bytes;
+    int i;
+
+    memset(&sc, 0, sizeof(sc));
+    arena = shad__compilation_arena_get(&sc);
+
+    sc.spirv_vertex_code = make_spirv(arena, &sc.spirv_vertex_code_size);
+    sc.num_vertex_input_buffers = 1 + rng() % 2;
+    sc.vertex_input_buffers = SHAD_ALLOC(ShadVertexInputBuffer, arena, sc.num_vertex_input_buffers);
+    for (i = 0; i < sc.num_vertex_input_buffers; ++i) {
+        sc.vertex_input_buffers[i].slot = i;
+        sc.vertex_input_buffers[i].instanced = i == 1;
+    }
+    sc.num_vertex_inputs = 1 + rng() % 6;
+    sc.vertex_inputs = SHAD_ALLOC(ShadVertexInput, arena, sc.num_vertex_inputs);
+    for (i = 0; i < sc.num_vertex_inputs; ++i) {
+        ShadVertexInput *in = &sc.vertex_inputs[i];
+        ShadVertexInputBuffer *buf;
+        in->format = (ShadVertexElementFormat)(SHAD_VERTEXELEMENTFORMAT_INT + rng() % SHAD_VERTEXELEMENTFORMAT_USHORT4_NORM);
+        in->buffer_slot = rng() % sc.num_vertex_input_buffers;
+        in->size = in->align = 16;
+        buf = &sc.vertex_input_buffers[in->buffer_slot];
+        in->offset = buf->stride;
+        in->instanced = buf->instanced;
+        buf->stride += 16;
+    }
+    sc.num_vertex_outputs = rng() % 8;
+    sc.num_vertex_uniforms = rng() % 2;
+
+    sc.has_fragment_shader = 1;
+    sc.spirv_fragment_code = make_spirv(arena, &sc.spirv_fragment_code_size);
+    sc.num_fragment_outputs = 1 + rng() % 3;
+    sc.fragment_outputs = SHAD_ALLOC(ShadFragmentOutput, arena, sc.num_fragment_outputs);
+    for (i = 0; i < sc.num_fragment_outputs; ++i) {
+        ShadFragmentOutput *out = &sc.fragment_outputs[i];
+        memset(out, 0, sizeof(*out));
+        out->format = formats[rng() % 4];
+        if (rng() % 2) {
+            out->blend_src = SHAD_BLEND_FACTOR_SRC_ALPHA;
+            out->blend_dst = SHAD_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            out->blend_op = SHAD_BLEND_OP_ADD;
+        }
+    }
+    sc.num_fragment_samplers = rng() % 4;
+    sc.num_fragment_uniforms = rng() % 2;
+
+    sc.depth_cmp = rng() % 2 ? SHAD_COMPARE_OP_LESS : SHAD_COMPARE_OP_INVALID;
+    sc.depth_format = sc.depth_cmp ? SHAD_TEXTURE_FORMAT_D24 : SHAD_TEXTURE_FORMAT_INVALID;
+    sc.depth_write = sc.depth_cmp != SHAD_COMPARE_OP_INVALID;
+    sc.cull_mode = SHAD_CULL_MODE_BACK;
+    sc.primitive = SHAD_PRIMITIVE_TRIANGLE_LIST;
+    sc.multisample_count = 1;
+
+    shad_compilation_serialize(&sc, &bytes, &blob.size);
+    blob.bytes = (char*)malloc(blob.size);
+    memcpy(blob.bytes, bytes, blob.size);
+    shad_compilation_free(&sc);
+    return blob;
+}
+
+/* touch the results so nothing gets optimized away */
+unsigned long long checksum;
+
+void fill(ShadCompilation *sc) {
+    SDL_GPUShaderCreateInfo vinfo, finfo;
+    SDL_GPUGraphicsPipelineCreateInfo pinfo;
+    shad_sdl_fill_vertex_shader(&vinfo, sc);
+    shad_sdl_fill_fragment_shader(&finfo, sc);
+    shad_sdl_fill_pipeline(&pinfo, sc);
+    checksum += vinfo.code_size + finfo.code_size + pinfo.vertex_input_state.num_vertex_attributes + pinfo.target_info.color_target_descriptions[0].format;
+}
+
+void report(const char *name, int count, double elapsed) {
+    printf("%-28s %8.1f ms  %6.2f us/shader  peak rss %7.1f MB\n", name, elapsed * 1e3, elapsed * 1e6 / count, peak_rss());
+}
+
+int main(int argc, char **argv) {
+    ShadCompilation *compilations;
+    Blob *blobs;
+    long long total_size = 0;
+    int count = 10000;
+    int i;
+    double start;
+
+    if (argc > 2 || (argc == 2 && (count = atoi(argv[1])) <= 0)) {
+        fprintf(stderr, "Usage: %s [COUNT]\n", argv[0]);
+        return 1;
+    }
+
+    blobs = (Blob*)malloc(sizeof(Blob) * count);
+    compilations = (ShadCompilation*)malloc(sizeof(ShadCompilation) * count);
+    for (i = 0; i < count; ++i) {
+        blobs[i] = make_blob();
+        total_size += blobs[i].size;
+    }
+    printf("%i compilations, %.1f MB serialized, peak rss %.1f MB\n", count, total_size / 1e6, peak_rss());
+
+    /* one by one, the way you'd load a shader when it's first needed */
+    start = seconds();
+    for (i = 0; i < count; ++i) {
+        ShadCompilation sc;
+        if (!shad_compilation_deserialize(blobs[i].bytes, blobs[i].size, &sc)) {
+            fprintf(stderr, "Error: Failed to deserialize %i\n", i);
+            return 1;
+        }
+        fill(&sc);
+        shad_compilation_free(&sc);
+    }
+    report("one by one", count, seconds() - start);
+
+    start = seconds();
+    for (i = 0; i < count; ++i) {
+        ShadCompilation sc;
+        if (!shad_compilation_deserialize_view(blobs[i].bytes, blobs[i].size, &sc)) {
+            fprintf(stderr, "Error: Failed to deserialize %i\n", i);
+            return 1;
+        }
+        fill(&sc);
+        shad_compilation_free(&sc);
+    }
+    report("one by one, view", count, seconds() - start);
+
+    /* in bulk, everything deserialized up front and kept around, the way you'd load at start-up */
+    start = seconds();
+    for (i = 0; i < count; ++i)
+        if (!shad_compilation_deserialize(blobs[i].bytes, blobs[i].size, &compilations[i])) return 1;
+    report("bulk deserialize", count, seconds() - start);
+
+    start = seconds();
+    for (i = 0; i < count; ++i)
+        fill(&compilations[i]);
+    report("bulk fill", count, seconds() - start);
+
+    for (i = 0; i < count; ++i)
+        shad_compilation_free(&compilations[i]);
+
+    printf("(checksum %llu)\n", checksum);
+    return 0;
+}
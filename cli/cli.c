@@ -3,6 +3,7 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <ctype.h>
 
 int streq(const char *a, const char *b) {
     return !strcmp(a,b);
@@ -18,15 +19,44 @@ void print_usage(char **argv) {
     fprintf(stderr, "    shad sdl3 triangle.shader mesh.shader > my_shaders.h\n");
     fprintf(stderr, "    # Outputs C code to file for SDL3\n");
     fprintf(stderr, "    shad sdl3 triangle.shader mesh.shader -o my_shaders.h\n");
+    fprintf(stderr, "    # Outputs a pack file to load at runtime with shad_pack_open()\n");
+    fprintf(stderr, "    shad sdl3 --emit pack triangle.shader mesh.shader -o my_shaders.shadpack\n");
+    fprintf(stderr, "    # Outputs an object file to link with, and my_shaders.h that declares what's in it\n");
+    fprintf(stderr, "    shad sdl3 --emit elf triangle.shader mesh.shader -o my_shaders.o\n");
+    fprintf(stderr, "    # Outputs a header with declarations, and the definitions split over my_shaders_0.c ... my_shaders_7.c\n");
+    fprintf(stderr, "    shad sdl3 --shards 8 triangle.shader mesh.shader -o my_shaders.h\n");
+    fprintf(stderr, "    # Outputs C code that #embed's triangle.vert.spv etc, written next to my_shaders.h\n");
+    fprintf(stderr, "    shad sdl3 --embed c23 triangle.shader mesh.shader -o my_shaders.h\n");
+    fprintf(stderr, "    # Outputs the same C code, plus C++ types for each shader (shad::shaders::triangle etc.)\n");
+    fprintf(stderr, "    shad cpp triangle.shader mesh.shader -o my_shaders.hpp\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "FRAMEWORK:\n");
     fprintf(stderr, "    sdl3: SDL3\n");
+    fprintf(stderr, "    cpp: SDL3, with C++ types that carry each shader's structs and a constexpr pipeline create info\n");
     fprintf(stderr, "\n");
     fprintf(stderr, "OPTIONS:\n");
     fprintf(stderr, "    -h, --help: Print help\n");
     fprintf(stderr, "    -o FILE, --output FILE: Output to file (if not specified, outputs to stdout)\n");
+    fprintf(stderr, "    --emit c|pack|elf: Output C code (default), a pack file, or an ELF object file with the SPIRV and\n");
+    fprintf(stderr, "        a header with the rest (the output with a .h extension). Packs and objects need -o\n");
+    fprintf(stderr, "    --elf-machine x86_64|aarch64|riscv64: Architecture of the object file (default: same as shad)\n");
+    fprintf(stderr, "    --compress: Store SPIRV in a compact encoding (packs only)\n");
+    fprintf(stderr, "    --embed array|string|c23|incbin: How the SPIRV is put in the C code (default array).\n");
+    fprintf(stderr, "        array: integer arrays. Works everywhere, slowest to compile\n");
+    fprintf(stderr, "        string: string literals. Fast to compile, but MSVC can't handle shaders over 64KB\n");
+    fprintf(stderr, "        c23: #embed of NAME.vert.spv/NAME.frag.spv, written next to the output file. Needs -o\n");
+    fprintf(stderr, "        incbin: like c23, but also writes an assembly file (output with a .S extension) that .incbin's them. Needs -o\n");
+    fprintf(stderr, "    --split: Declare the SDL structs extern, and define them inside #ifdef SHAD_IMPLEMENTATION,\n");
+    fprintf(stderr, "        so they're only compiled once. Define SHAD_IMPLEMENTATION in one file before including the output\n");
+    fprintf(stderr, "    --shards N: Like --split, but put the definitions in N .c files (the output with _0.c, _1.c, ...) that\n");
+    fprintf(stderr, "        can be compiled in parallel. Needs -o\n");
+    fprintf(stderr, "    --registry NAME: Also output a table NAME of all shaders, and NAME_find() to look them up by name\n");
+    fprintf(stderr, "    --bind-helpers: Also output shad_bind_<shader>_per_frame() etc, which push the uniforms and bind the resources\n");
+    fprintf(stderr, "        of one update frequency, skipping what's already pushed or bound (see ShadSdlBindCache)\n");
+    fprintf(stderr, "    --embed-path PREFIX: Path prefix of the .spv files in #embed/.incbin (default: none for c23, the output directory for incbin)\n");
 }
 
+/* returns the file name without directories and extension, as a span into path */
 void get_filename(char *path, char **filename_out, int *filename_len_out) {
     char *p = path;
     char *end = path + strlen(path);
@@ -36,25 +66,147 @@ void get_filename(char *path, char **filename_out, int *filename_len_out) {
     char *f = e;
     while (f > p && *f != '/' && *f != '\\') --f;
     if (f > p) ++f;
-    int len = e-f;
-    char *result = (char*)malloc(len+1);
-    memcpy(result, f, len);
-    result[len] = 0;
-    *filename_out = result;
-    *filename_len_out = len;
+    *filename_out = f;
+    *filename_len_out = (int)(e-f);
 }
 
-int main(int argc, char **argv) {
-    typedef struct InputFile {
-        char *file;
-        ShadCompilation result;
-    } InputFile;
+/* returns a malloc'd string of a, len chars of b, and c */
+char* concat(const char *a, const char *b, int len, const char *c) {
+    int alen = (int)strlen(a), clen = (int)strlen(c);
+    char *result = (char*)malloc(alen + len + clen + 1);
+    memcpy(result, a, alen);
+    memcpy(result + alen, b, len);
+    memcpy(result + alen + len, c, clen + 1);
+    return result;
+}
 
+int is_identifier(const char *s) {
+    if (!isalpha((unsigned char)*s) && *s != '_') return 0;
+    for (++s; *s; ++s)
+        if (!isalnum((unsigned char)*s) && *s != '_') return 0;
+    return 1;
+}
+
+int write_file(const char *path, const char *data, int len) {
+    FILE *f = fopen(path, "wb");
+    if (!f) return 0;
+    fwrite(data, 1, len, f);
+    return !ferror(f) & !fclose(f);
+}
+
+/* replaces to with from, atomically where the platform allows. Returns 0 on success like rename() */
+int replace_file(const char *from, const char *to) {
+#ifdef _WIN32
+    /* rename() won't replace an existing file on windows */
+    return MoveFileExA(from, to, MOVEFILE_REPLACE_EXISTING) ? 0 : -1;
+#else
+    return rename(from, to);
+#endif
+}
+
+/* the .vert.spv/.frag.spv files for --embed c23/incbin are written as .tmp files next to them.
+   Replaces the real ones with them if keep is set, removes them otherwise. Returns 0 if a rename failed */
+int finish_spirv_files(const char *output_dir, char **files, int num_files, const char *has_fragment, int keep) {
+    int ok = 1;
+    for (int i = 0; i < num_files; ++i) {
+        for (int stage = 0; stage < 1 + has_fragment[i]; ++stage) {
+            char *fname;
+            int fname_len;
+            get_filename(files[i], &fname, &fname_len);
+            char *spirv_file = concat(output_dir, fname, fname_len, stage ? ".frag.spv" : ".vert.spv");
+            char *spirv_tmp_file = concat(spirv_file, "", 0, ".tmp");
+            if (!keep) {
+                remove(spirv_tmp_file);
+            } else if (ok && replace_file(spirv_tmp_file, spirv_file)) {
+                fprintf(stderr, "Error: Failed to rename %s to %s\n", spirv_tmp_file, spirv_file);
+                ok = 0;
+            }
+            free(spirv_file);
+            free(spirv_tmp_file);
+        }
+    }
+    return ok;
+}
+
+unsigned hash_string(const char *s, int len) {
+    /* FNV-1a */
+    unsigned h = 2166136261u;
+    for (int i = 0; i < len; ++i)
+        h = (h ^ (unsigned char)s[i]) * 16777619u;
+    return h;
+}
+
+/* checks that no two files have the same filename, since that would cause name collisions in the output */
+int check_duplicate_filenames(char **files, int num_files) {
+    int cap = 16;
+    while (cap < num_files*2) cap *= 2;
+    /* open addressing, stores file index + 1 */
+    int *slots = (int*)calloc(cap, sizeof(int));
+    if (!slots) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 0;
+    }
+
+    for (int i = 0; i < num_files; ++i) {
+        char *fname;
+        int fname_len;
+        get_filename(files[i], &fname, &fname_len);
+        for (unsigned h = hash_string(fname, fname_len) & (cap-1);; h = (h+1) & (cap-1)) {
+            if (!slots[h]) {
+                slots[h] = i+1;
+                break;
+            }
+            char *f2name;
+            int f2name_len;
+            get_filename(files[slots[h]-1], &f2name, &f2name_len);
+            if (fname_len == f2name_len && memcmp(fname, f2name, fname_len) == 0) {
+                fprintf(stderr, "Error: Duplicate filenames:\n%s\n%s\nThis will cause name collisions in output.", files[slots[h]-1], files[i]);
+                free(slots);
+                return 0;
+            }
+        }
+    }
+
+    free(slots);
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    enum {EMIT_C, EMIT_PACK, EMIT_ELF} emit = EMIT_C;
+    ShadPackWriter pack;
+    ShadElfWriter elf;
+    ShadSdlCWriter c_writer;
+    ShadElfMachine elf_machine = SHAD_ELF_MACHINE_HOST;
+    char *header_file = NULL;
+    char *header_tmp_file = NULL;
     int help = 0;
+    int compress = 0;
+    int split = 0;
+    int cpp = 0;
+    int bind_helpers = 0;
+    const char *registry = NULL;
+    int num_shards = 0;
+    FILE **shards = NULL;
+    char **shard_files = NULL;
+    char **shard_tmp_files = NULL;
+    int *shard_sizes = NULL;
+    int num_compiled = 0;
+    ShadEmbedMode embed = SHAD_EMBED_ARRAY;
+    const char *embed_path = NULL;
+    char *output_dir = NULL;
+    char *asm_file = NULL;
+    char *asm_tmp_file = NULL;
+    FILE *asm_out = NULL;
+    char *has_fragment = NULL;
+    int num_spirv_files = 0;
     char *output_file = NULL;
+    char *tmp_file = NULL;
     ShadOutputFormat output_format = SHAD_OUTPUT_FORMAT_INVALID;
-    InputFile *files = (InputFile*)malloc(sizeof(InputFile) * argc);
+    char **files = (char**)malloc(sizeof(char*) * argc);
     int num_files = 0;
+    char *name = NULL;
+    int name_cap = 0;
+    FILE *out = stdout;
 
     if (argc < 2) {
         fprintf(stderr, "Error: No framework specified\n\n");
@@ -65,6 +217,8 @@ int main(int argc, char **argv) {
     /* parse framework */
     if (streq(argv[1], "sdl3"))
         output_format = SHAD_OUTPUT_FORMAT_SDL;
+    else if (streq(argv[1], "cpp"))
+        output_format = SHAD_OUTPUT_FORMAT_SDL, cpp = 1;
     else {
         fprintf(stderr, "Error: Unknown framework: %s\n\n", argv[1]);
         print_usage(argv);
@@ -89,6 +243,70 @@ int main(int argc, char **argv) {
             output_file = argp[1];
             ++argp;
         }
+        else if (streq(arg, "--compress")) compress = 1;
+        else if (streq(arg, "--split")) split = 1;
+        else if (streq(arg, "--bind-helpers")) bind_helpers = 1;
+        else if (streq(arg, "--registry")) {
+            if (!argp[1] || !is_identifier(argp[1])) {
+                fprintf(stderr, "Error: %s must be followed by a C identifier\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            registry = argp[1];
+            ++argp;
+        }
+        else if (streq(arg, "--shards")) {
+            if (!argp[1] || (num_shards = atoi(argp[1])) <= 0) {
+                fprintf(stderr, "Error: %s must be followed by a number of files\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            split = 1;
+            ++argp;
+        }
+        else if (streq(arg, "--emit")) {
+            if      (argp[1] && streq(argp[1], "c")) emit = EMIT_C;
+            else if (argp[1] && streq(argp[1], "pack")) emit = EMIT_PACK;
+            else if (argp[1] && streq(argp[1], "elf")) emit = EMIT_ELF;
+            else {
+                fprintf(stderr, "Error: %s must be followed by c, pack or elf\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            ++argp;
+        }
+        else if (streq(arg, "--embed")) {
+            if      (argp[1] && streq(argp[1], "array")) embed = SHAD_EMBED_ARRAY;
+            else if (argp[1] && streq(argp[1], "string")) embed = SHAD_EMBED_STRING;
+            else if (argp[1] && streq(argp[1], "c23")) embed = SHAD_EMBED_C23;
+            else if (argp[1] && streq(argp[1], "incbin")) embed = SHAD_EMBED_INCBIN;
+            else {
+                fprintf(stderr, "Error: %s must be followed by array, string, c23 or incbin\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            ++argp;
+        }
+        else if (streq(arg, "--elf-machine")) {
+            if      (argp[1] && streq(argp[1], "x86_64")) elf_machine = SHAD_ELF_MACHINE_X86_64;
+            else if (argp[1] && streq(argp[1], "aarch64")) elf_machine = SHAD_ELF_MACHINE_AARCH64;
+            else if (argp[1] && streq(argp[1], "riscv64")) elf_machine = SHAD_ELF_MACHINE_RISCV64;
+            else {
+                fprintf(stderr, "Error: %s must be followed by x86_64, aarch64 or riscv64\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            ++argp;
+        }
+        else if (streq(arg, "--embed-path")) {
+            if (!argp[1]) {
+                fprintf(stderr, "Error: %s must be followed by a path\n\n", arg);
+                print_usage(argv);
+                return 1;
+            }
+            embed_path = argp[1];
+            ++argp;
+        }
         else {
             if (arg[0] == '-') {
                 fprintf(stderr, "Unknown option: '%s'\n\n", arg);
@@ -96,9 +314,7 @@ int main(int argc, char **argv) {
                 return 1;
             }
 
-            InputFile *file = &files[num_files++];
-            memset(file, 0, sizeof(*file));
-            file->file = arg;
+            files[num_files++] = arg;
         }
     }
 
@@ -122,75 +338,403 @@ int main(int argc, char **argv) {
         return 1;
     }
 
-    /* sanity check that people don't use multiple files with the same filename */
-    for (int i = 0; i < num_files; ++i) {
+    /* packs and objects are binary and written with seeking */
+    if ((emit == EMIT_PACK || emit == EMIT_ELF) && !output_file) {
+        fprintf(stderr, "Error: --emit %s needs an output file (-o)\n\n", emit == EMIT_PACK ? "pack" : "elf");
+        print_usage(argv);
+        return 1;
+    }
+
+    /* the object file comes with a header declaring its symbols */
+    if (emit == EMIT_ELF) {
         char *fname;
         int fname_len;
-        get_filename(files[i].file, &fname, &fname_len);
-        for (int j = 0; j < num_files; ++j) {
-            if (j == i) continue;
-            char *f2name;
-            int f2name_len;
-            get_filename(files[j].file, &f2name, &f2name_len);
-            if (fname_len == f2name_len && memcmp(fname, f2name, fname_len) == 0) {
-                fprintf(stderr, "Error: Duplicate filenames:\n%s\n%s\nThis will cause name collisions in output.", files[i].file, files[j].file);
+        get_filename(output_file, &fname, &fname_len);
+        header_file = concat("", output_file, (int)(fname + fname_len - output_file), ".h");
+        header_tmp_file = concat(header_file, "", 0, ".tmp");
+        if (streq(header_file, output_file)) {
+            fprintf(stderr, "Error: --emit elf writes the header to %s, so the object file needs another name\n\n", header_file);
+            print_usage(argv);
+            return 1;
+        }
+    }
+
+    if (split && emit != EMIT_C) {
+        fprintf(stderr, "Error: --split and --shards only work with --emit c\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    /* the shards are named after the output file */
+    if (num_shards && !output_file) {
+        fprintf(stderr, "Error: --shards needs an output file (-o)\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (cpp && emit == EMIT_PACK) {
+        fprintf(stderr, "Error: cpp doesn't work with --emit pack, there's no code to add C++ to\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (bind_helpers && emit == EMIT_PACK) {
+        fprintf(stderr, "Error: --bind-helpers doesn't work with --emit pack\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (registry && emit == EMIT_PACK) {
+        fprintf(stderr, "Error: --registry doesn't work with --emit pack\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (compress && emit != EMIT_PACK) {
+        fprintf(stderr, "Error: --compress only works with --emit pack\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (embed != SHAD_EMBED_ARRAY && emit != EMIT_C) {
+        fprintf(stderr, "Error: --embed only works with --emit c\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    /* the .spv files go next to the output file */
+    if ((embed == SHAD_EMBED_C23 || embed == SHAD_EMBED_INCBIN) && !output_file) {
+        fprintf(stderr, "Error: --embed c23 and --embed incbin need an output file (-o)\n\n");
+        print_usage(argv);
+        return 1;
+    }
+
+    if (embed == SHAD_EMBED_C23 || embed == SHAD_EMBED_INCBIN) {
+        char *fname;
+        int fname_len;
+        get_filename(output_file, &fname, &fname_len);
+        output_dir = concat("", output_file, (int)(fname - output_file), "");
+        /* #embed looks next to the including file like #include does, .incbin looks in the assembler's working directory */
+        if (!embed_path)
+            embed_path = embed == SHAD_EMBED_C23 ? "" : output_dir;
+        if (embed == SHAD_EMBED_INCBIN) {
+            asm_file = concat("", output_file, (int)(fname + fname_len - output_file), ".S");
+            asm_tmp_file = concat(asm_file, "", 0, ".tmp");
+            asm_out = fopen(asm_tmp_file, "wb");
+            if (!asm_out) {
+                fprintf(stderr, "Failed to open output file %s\n", asm_tmp_file);
                 return 1;
             }
         }
+        /* the SPIRV files are replaced along with the output, at the end */
+        has_fragment = (char*)calloc(num_files ? num_files : 1, 1);
     }
+    if (!embed_path)
+        embed_path = "";
 
-    /* compile */
-    for (int i = 0; i < num_files; ++i)
-        if (!shad_compile(files[i].file, output_format, &files[i].result))
-            return 1;
+    /* sanity check that people don't use multiple files with the same filename */
+    if (!check_duplicate_filenames(files, num_files))
+        return 1;
 
-    /* open output file */
-    FILE *out = stdout;
+    /* open output file.
+       We write to a temporary file and rename it when everything compiled, so a failed run doesn't leave a half-written output behind */
     if (output_file) {
-        out = fopen(output_file, "wb");
-        if (!out) {
-            fprintf(stderr, "Failed to open output file %s\n", output_file);
-            return 1;
+        int len = (int)strlen(output_file);
+        tmp_file = (char*)malloc(len + 5);
+        memcpy(tmp_file, output_file, len);
+        memcpy(tmp_file + len, ".tmp", 5);
+        if (emit == EMIT_PACK) {
+            out = NULL;
+            if (!shad_pack_writer_begin(&pack, tmp_file)) {
+                fprintf(stderr, "Failed to open output file %s\n", tmp_file);
+                return 1;
+            }
+            pack.compress_spirv = (ShadBool)compress;
+        } else if (emit == EMIT_ELF) {
+            if (!shad_elf_writer_begin(&elf, tmp_file)) {
+                fprintf(stderr, "Failed to open output file %s\n", tmp_file);
+                return 1;
+            }
+            elf.machine = elf_machine;
+            out = fopen(header_tmp_file, "wb");
+            if (!out) {
+                fprintf(stderr, "Failed to open output file %s\n", header_tmp_file);
+                shad_elf_writer_end(&elf);
+                remove(tmp_file);
+                return 1;
+            }
+        } else {
+            out = fopen(tmp_file, "wb");
+            if (!out) {
+                fprintf(stderr, "Failed to open output file %s\n", tmp_file);
+                return 1;
+            }
         }
     }
 
-    /* write out the result */
-    int num_compiled = 0;
+    /* each shard includes the header, so the declarations and definitions can't disagree */
+    if (num_shards) {
+        char *fname;
+        int fname_len;
+        get_filename(output_file, &fname, &fname_len);
+        shards = (FILE**)calloc(num_shards, sizeof(FILE*));
+        shard_files = (char**)calloc(num_shards, sizeof(char*));
+        shard_tmp_files = (char**)calloc(num_shards, sizeof(char*));
+        shard_sizes = (int*)calloc(num_shards, sizeof(int));
+        for (int i = 0; i < num_shards; ++i) {
+            char suffix[32];
+            snprintf(suffix, sizeof(suffix), "_%i.c", i);
+            shard_files[i] = concat("", output_file, (int)(fname + fname_len - output_file), suffix);
+            shard_tmp_files[i] = concat(shard_files[i], "", 0, ".tmp");
+            shards[i] = fopen(shard_tmp_files[i], "wb");
+            if (!shards[i]) {
+                fprintf(stderr, "Failed to open output file %s\n", shard_tmp_files[i]);
+                goto err;
+            }
+            fprintf(shards[i], "#include <SDL3/SDL.h>\n#include \"%s\"\n", fname);
+        }
+    }
+
+    /* identical SPIRV modules are written once, for all files */
+    shad_sdl_c_writer_begin(&c_writer);
+    c_writer.embed = emit == EMIT_ELF ? SHAD_EMBED_INCBIN : embed;
+    c_writer.spirv_path = embed_path;
+    c_writer.split = (ShadBool)split;
+    c_writer.cpp = (ShadBool)cpp;
+    c_writer.bind_helpers = (ShadBool)bind_helpers;
+
+    /* compile and write out one file at a time, so memory use doesn't grow with the number of files */
     for (int i = 0; i < num_files; ++i) {
-        char *code;
-        int len;
+        ShadCompilation result;
+        char *code, *definitions;
+        int len, definitions_len;
+
+        if (!shad_compile(files[i], output_format, &result))
+            goto err;
+
+        char *fname;
+        int fname_len;
+        get_filename(files[i], &fname, &fname_len);
+        if (fname_len+1 > name_cap) {
+            name_cap = (fname_len+1)*2;
+            name = (char*)realloc(name, name_cap);
+        }
+        memcpy(name, fname, fname_len);
+        name[fname_len] = 0;
+
+        if (emit == EMIT_PACK) {
+            ShadBool ok = shad_pack_writer_add(&pack, name, &result);
+            shad_compilation_free(&result);
+            ++num_compiled;
+            if (!ok) {
+                fprintf(stderr, "Error: Failure writing to %s\n", output_file);
+                goto err;
+            }
+            continue;
+        }
+
         switch (output_format) {
             case SHAD_OUTPUT_FORMAT_SDL: {
-                char *fname;
-                int fname_len;
-                get_filename(files[i].file, &fname, &fname_len);
-                shad_sdl_serialize_to_c(&files[i].result, fname, &code, &len);
+                shad_sdl_c_writer_add(&c_writer, name, &result, &code, &len, &definitions, &definitions_len);
                 break;
             }
             default: {
                 fprintf(stderr, "Error: Unknown output format: %i\n", output_format);
-                return 1;
+                shad_compilation_free(&result);
+                goto err;
             }
         }
         fwrite(code, 1, len, out);
+
+        if (num_shards) {
+            /* into the smallest shard so far, so they take about as long to compile */
+            int shard = 0;
+            for (int j = 1; j < num_shards; ++j)
+                if (shard_sizes[j] < shard_sizes[shard]) shard = j;
+            fwrite(definitions, 1, definitions_len, shards[shard]);
+            shard_sizes[shard] += definitions_len;
+            if (ferror(shards[shard])) {
+                fprintf(stderr, "Error: Failure writing to %s\n", shard_tmp_files[shard]);
+                shad_compilation_free(&result);
+                goto err;
+            }
+        }
+        else if (split) {
+            fprintf(out, "#ifdef SHAD_IMPLEMENTATION\n");
+            fwrite(definitions, 1, definitions_len, out);
+            fprintf(out, "#endif\n");
+        }
+
+        if (emit == EMIT_ELF && !shad_elf_writer_add(&elf, name, &result)) {
+            fprintf(stderr, "Error: Failure writing to %s\n", output_file);
+            shad_compilation_free(&result);
+            goto err;
+        }
+
+        if (embed == SHAD_EMBED_C23 || embed == SHAD_EMBED_INCBIN) {
+            char *vert_file = concat(output_dir, name, fname_len, ".vert.spv.tmp");
+            char *frag_file = concat(output_dir, name, fname_len, ".frag.spv.tmp");
+            const char *failed = NULL;
+            has_fragment[i] = (char)(result.has_fragment_shader != 0);
+            num_spirv_files = i+1;
+            if (!write_file(vert_file, result.spirv_vertex_code, result.spirv_vertex_code_size))
+                failed = vert_file;
+            else if (result.has_fragment_shader && !write_file(frag_file, result.spirv_fragment_code, result.spirv_fragment_code_size))
+                failed = frag_file;
+            else if (asm_out) {
+                shad_serialize_to_asm(&result, name, embed_path, &code, &len);
+                fwrite(code, 1, len, asm_out);
+                if (ferror(asm_out)) failed = asm_tmp_file;
+            }
+            if (failed)
+                fprintf(stderr, "Error: Failure writing to %s\n", failed);
+            free(vert_file);
+            free(frag_file);
+            if (failed) {
+                shad_compilation_free(&result);
+                goto err;
+            }
+        }
+
+        shad_compilation_free(&result);
         ++num_compiled;
+
+        if (ferror(out)) {
+            fprintf(stderr, "Error: Failure writing to %s\n", header_file ? header_file : output_file ? output_file : "stdout");
+            goto err;
+        }
+    }
+
+    if (registry) {
+        char *code;
+        int len;
+        if (!shad_sdl_c_writer_registry(&c_writer, registry, &code, &len)) {
+            fprintf(stderr, "Error: Failed to generate registry %s\n", registry);
+            goto err;
+        }
+        fwrite(code, 1, len, out);
+        if (ferror(out)) {
+            fprintf(stderr, "Error: Failure writing to %s\n", header_file ? header_file : output_file ? output_file : "stdout");
+            goto err;
+        }
     }
 
-    if (ferror(out)) {
-        fprintf(stderr, "Error: Failure writing to %s\n", output_file ? output_file : "stdout");
+    if (emit == EMIT_PACK) {
+        if (!shad_pack_writer_end(&pack)) {
+            fprintf(stderr, "Error: Failure writing to %s\n", output_file);
+            goto err;
+        }
+        if (pack.bytes_deduplicated)
+            fprintf(stderr, "Deduplicated %i bytes of SPIRV\n", pack.bytes_deduplicated);
+    }
+    else if (output_file) {
+        if (emit == EMIT_ELF && !shad_elf_writer_end(&elf)) {
+            fprintf(stderr, "Error: Failure writing to %s\n", output_file);
+            goto err;
+        }
+        if (fclose(out)) {
+            out = NULL;
+            fprintf(stderr, "Error: Failure writing to %s\n", header_file ? header_file : output_file);
+            goto err;
+        }
+        out = NULL;
+    }
+
+    shad_sdl_c_writer_end(&c_writer);
+    if (emit == EMIT_C && c_writer.bytes_deduplicated)
+        fprintf(stderr, "Deduplicated %i bytes of SPIRV\n", c_writer.bytes_deduplicated);
+    if (emit == EMIT_ELF && elf.bytes_deduplicated)
+        fprintf(stderr, "Deduplicated %i bytes of SPIRV\n", elf.bytes_deduplicated);
+
+    for (int i = 0; i < num_shards; ++i) {
+        int failed = fclose(shards[i]);
+        shards[i] = NULL;
+        if (failed) {
+            fprintf(stderr, "Error: Failure writing to %s\n", shard_tmp_files[i]);
+            goto err;
+        }
+    }
+
+    if (asm_out) {
+        int failed = fclose(asm_out);
+        asm_out = NULL;
+        if (failed) {
+            fprintf(stderr, "Error: Failure writing to %s\n", asm_tmp_file);
+            goto err;
+        }
+    }
+
+    if (num_spirv_files && !finish_spirv_files(output_dir, files, num_spirv_files, has_fragment, 1))
         goto err;
+    if (asm_tmp_file) {
+        if (replace_file(asm_tmp_file, asm_file)) {
+            fprintf(stderr, "Error: Failed to rename %s to %s\n", asm_tmp_file, asm_file);
+            goto err;
+        }
+    }
+    if (output_file) {
+        if (replace_file(tmp_file, output_file)) {
+            fprintf(stderr, "Error: Failed to rename %s to %s\n", tmp_file, output_file);
+            goto err;
+        }
+    }
+    for (int i = 0; i < num_shards; ++i) {
+        if (replace_file(shard_tmp_files[i], shard_files[i])) {
+            fprintf(stderr, "Error: Failed to rename %s to %s\n", shard_tmp_files[i], shard_files[i]);
+            goto err;
+        }
+    }
+    if (header_file) {
+        if (replace_file(header_tmp_file, header_file)) {
+            fprintf(stderr, "Error: Failed to rename %s to %s\n", header_tmp_file, header_file);
+            goto err;
+        }
     }
 
     fprintf(stderr, "Successfully compiled %i shaders\n", num_compiled);
 
-    /* this should happen when the process exits, but maybe this will free the output file a bit faster */
-    if (output_file)
-        fclose(out);
+    free(name);
+    free(tmp_file);
+    free(output_dir);
+    free(asm_file);
+    free(asm_tmp_file);
+    free(has_fragment);
+    for (int i = 0; i < num_shards; ++i) {
+        free(shard_files[i]);
+        free(shard_tmp_files[i]);
+    }
+    free(shards);
+    free(shard_files);
+    free(shard_tmp_files);
+    free(shard_sizes);
+    free(header_file);
+    free(header_tmp_file);
+    free(files);
     return 0;
 
-    /* this should happen when the process exits, but maybe this will free the output file a bit faster */
     err:
-    if (output_file)
-        fclose(out);
+    for (int i = 0; i < num_shards; ++i) {
+        if (shards[i])
+            fclose(shards[i]);
+        if (shard_tmp_files[i])
+            remove(shard_tmp_files[i]);
+    }
+    if (asm_out)
+        fclose(asm_out);
+    if (asm_tmp_file)
+        remove(asm_tmp_file);
+    if (num_spirv_files)
+        finish_spirv_files(output_dir, files, num_spirv_files, has_fragment, 0);
+    if (output_file) {
+        if (emit == EMIT_PACK)
+            shad_pack_writer_end(&pack);
+        if (emit == EMIT_ELF)
+            shad_elf_writer_end(&elf);
+        if (out)
+            fclose(out);
+        remove(tmp_file);
+        if (header_tmp_file)
+            remove(header_tmp_file);
+    }
     return 1;
 }
\ No newline at end of file
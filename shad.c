@@ -6,6 +6,39 @@
 #include <string.h>
 #include <assert.h>
 
+/* for memory mapping packs. shad.c usually gets #included, so keep windows.h's macros out of the includer's way */
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+        #define SHAD__UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+        #define SHAD__UNDEF_NOMINMAX
+    #endif
+    #include <windows.h>
+    #ifdef SHAD__UNDEF_WIN32_LEAN_AND_MEAN
+        #undef WIN32_LEAN_AND_MEAN
+        #undef SHAD__UNDEF_WIN32_LEAN_AND_MEAN
+    #endif
+    #ifdef SHAD__UNDEF_NOMINMAX
+        #undef NOMINMAX
+        #undef SHAD__UNDEF_NOMINMAX
+    #endif
+    #undef near
+    #undef far
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/* for the pack loader thread */
+#if !defined(SHAD_NO_THREADS) && !defined(_WIN32)
+    #include <pthread.h>
+#endif
+
 /******
 
     Common utilities
@@ -52,6 +85,16 @@ void* shad__alloc(ShadArena* arena, int size, int align) {
     return curr;
 }
 
+/* adds a block that fits exactly `size` more bytes, for when we know up front how much we'll allocate */
+void shad__arena_reserve(ShadArena *arena, int size) {
+    int block_size = (int)sizeof(ShadArenaBlock) + size;
+    ShadArenaBlock *block = (ShadArenaBlock*)malloc(block_size);
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->curr = &block->data;
+    arena->end = (char*)block + block_size;
+}
+
 void shad__arena_destroy(ShadArena *a) {
     ShadArenaBlock *b = a->blocks, *next = NULL;
     for (; b; b = next) {
@@ -86,6 +129,7 @@ int shad__vsnprintf(char *buffer, int size, const char *fmt, va_list args) {
         if (*fmt == 'S') {++fmt; s = va_arg(args, char*); n = (int)(va_arg(args, char*) - s); goto add_ns;}
         if (*fmt == 'i') {++fmt; i = va_arg(args, int); goto add_i;}
         if (*fmt == 'x') {++fmt; u = va_arg(args, unsigned); goto add_x;}
+        if (*fmt == '%') {++fmt; buf[0] = '%'; s = buf; n = 1; goto add_ns;}
         buf[0] = '%';
         s = buf;
         n = 1;
@@ -134,21 +178,27 @@ int shad__snprintf(char *buffer, int size, const char *fmt, ...) {
     return len;
 }
 
-void shad__writer_print(ShadWriter *w, const char *fmt, ...) {
-    va_list args;
-
-    va_start(args, fmt);
-    int len = shad__vsnprintf(NULL, 0, fmt, args);
-    va_end(args);
-
+/* makes sure len more bytes (plus a null terminator) fit without growing the buffer.
+   An empty buffer gets exactly that, so a pre-sized one isn't twice as big as it needs to be; appends grow geometrically */
+void shad__writer_reserve(ShadWriter *w, int len) {
     if (w->len + len >= w->cap) {
         char *buf = NULL;
-        w->cap = (w->cap + len + 64)*2;
+        w->cap = w->len ? (w->cap + len + 64)*2 : len + 1;
         buf = SHAD_ALLOC(char, w->arena, w->cap);
         memcpy(buf, w->buf, w->len);
         buf[w->len] = 0;
         w->buf = buf;
     }
+}
+
+void shad__writer_print(ShadWriter *w, const char *fmt, ...) {
+    va_list args;
+
+    va_start(args, fmt);
+    int len = shad__vsnprintf(NULL, 0, fmt, args);
+    va_end(args);
+
+    shad__writer_reserve(w, len);
 
     va_start(args, fmt);
     shad__vsnprintf(w->buf + w->len, len+1, fmt, args);
@@ -158,19 +208,115 @@ void shad__writer_print(ShadWriter *w, const char *fmt, ...) {
 }
 
 void shad__writer_push(ShadWriter *w, char *data, int len) {
-    if (w->len + len >= w->cap) {
-        char *buf = NULL;
-        w->cap = (w->cap + len + 64)*2;
-        buf = SHAD_ALLOC(char, w->arena, w->cap);
-        memcpy(buf, w->buf, w->len);
-        buf[w->len] = 0;
-        w->buf = buf;
-    }
+    shad__writer_reserve(w, len);
     memcpy(w->buf + w->len, data, len);
     w->len += len;
     w->buf[w->len] = 0;
 }
 
+/* little-endian reads and writes, for the binary formats */
+unsigned shad__get_u32(const char *p) {
+    const unsigned char *u = (const unsigned char*)p;
+    return (unsigned)u[0] | ((unsigned)u[1] << 8) | ((unsigned)u[2] << 16) | ((unsigned)u[3] << 24);
+}
+
+void shad__put_u32(char *p, unsigned v) {
+    p[0] = (char)v;
+    p[1] = (char)(v >> 8);
+    p[2] = (char)(v >> 16);
+    p[3] = (char)(v >> 24);
+}
+
+void shad__put_u16(char *p, unsigned v) {
+    p[0] = (char)v;
+    p[1] = (char)(v >> 8);
+}
+
+void shad__put_u64(char *p, uint64_t v) {
+    shad__put_u32(p, (unsigned)v);
+    shad__put_u32(p + 4, (unsigned)(v >> 32));
+}
+
+ShadBool shad__little_endian(void) {
+    unsigned one = 1;
+    return *(char*)&one == 1;
+}
+
+/* shad__hash64() a word at a time, for data that isn't in one buffer. size is the total in bytes, which has to be known up front */
+uint64_t shad__hash64_begin(int size, uint64_t seed) {
+    return seed ^ ((uint64_t)size * 0x9e3779b97f4a7c15ull);
+}
+
+uint64_t shad__hash64_word(uint64_t h, unsigned word) {
+    h ^= word;
+    h *= 0xff51afd7ed558ccdull;
+    return h ^ (h >> 32);
+}
+
+uint64_t shad__hash64_end(uint64_t h) {
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/* 64-bit hash of data, read as little-endian words so it's the same on every platform */
+uint64_t shad__hash64(const char *data, int size, uint64_t seed) {
+    uint64_t h = shad__hash64_begin(size, seed);
+    int i;
+    for (i = 0; i + 4 <= size; i += 4)
+        h = shad__hash64_word(h, shad__get_u32(data + i));
+    for (; i < size; ++i)
+        h = shad__hash64_word(h, (unsigned char)data[i]);
+    return shad__hash64_end(h);
+}
+
+/* the kinds of resources, 0-3 are the vertex samplers, images, buffers and uniforms, 4-7 the fragment ones */
+#define SHAD__NUM_RESOURCE_KINDS 8
+
+/* the counts per ShadFrequency of a kind of resource */
+int* shad__frequency_counts(ShadCompilation *c, int kind) {
+    ShadResourceFrequencies *f = kind < 4 ? &c->vertex_frequencies : &c->fragment_frequencies;
+    switch (kind % 4) {
+        case 0: return f->samplers;
+        case 1: return f->images;
+        case 2: return f->buffers;
+        default: return f->uniforms;
+    }
+}
+
+int shad__resource_count(const ShadCompilation *c, int kind) {
+    switch (kind) {
+        case 0: return c->num_vertex_samplers;
+        case 1: return c->num_vertex_images;
+        case 2: return c->num_vertex_buffers;
+        case 3: return c->num_vertex_uniforms;
+        case 4: return c->num_fragment_samplers;
+        case 5: return c->num_fragment_images;
+        case 6: return c->num_fragment_buffers;
+        default: return c->num_fragment_uniforms;
+    }
+}
+
+/* the first slot and the number of slots of a frequency. Anything not counted as per frame or per material is
+   per draw, so this also works for a compilation that has no frequencies filled in */
+void shad__frequency_range(ShadCompilation *c, int kind, ShadFrequency frequency, int *first_out, int *count_out) {
+    int *counts = shad__frequency_counts(c, kind);
+    int first = 0, f;
+    for (f = 0; f < (int)frequency; ++f) first += counts[f];
+    *first_out = first;
+    *count_out = frequency == SHAD_FREQUENCY_PER_DRAW ? shad__resource_count(c, kind) - first : counts[frequency];
+}
+
+/* everything per draw, for compilations from before there were frequencies */
+void shad__frequencies_default(ShadCompilation *c) {
+    int kind;
+    memset(&c->vertex_frequencies, 0, sizeof(c->vertex_frequencies));
+    memset(&c->fragment_frequencies, 0, sizeof(c->fragment_frequencies));
+    for (kind = 0; kind < SHAD__NUM_RESOURCE_KINDS; ++kind)
+        shad__frequency_counts(c, kind)[SHAD_FREQUENCY_PER_DRAW] = shad__resource_count(c, kind);
+}
+
 void shad_compilation_free(ShadCompilation *r) {
     if (r->arena)
         shad__arena_destroy((ShadArena*)r->arena);
@@ -180,8 +326,12 @@ void shad_compilation_free(ShadCompilation *r) {
 
     Compiler mode
 
+    Define SHAD_NO_COMPILER to leave this out, for builds that only load precompiled shaders
+
 ******/
 
+#ifndef SHAD_NO_COMPILER
+
 /* we use glslang to cross-compile from GLSL to SPIRV */
 #include <glslang/Include/glslang_c_interface.h>
 #include <glslang/Public/resource_limits_c.h>
@@ -534,8 +684,24 @@ ShadBlendOp shad__consume_blend_op(ShadParser *p) {
     return SHAD_BLEND_OP_INVALID;
 }
 
-char* shad__consume_texture(ShadParser *p) {
+ShadBool shad__consume_frequency_name(ShadParser *p, ShadFrequency *frequency) {
+    if (shad__match_identifier(p, "per_frame")) *frequency = SHAD_FREQUENCY_PER_FRAME;
+    else if (shad__match_identifier(p, "per_material")) *frequency = SHAD_FREQUENCY_PER_MATERIAL;
+    else if (shad__match_identifier(p, "per_draw")) *frequency = SHAD_FREQUENCY_PER_DRAW;
+    else return 0;
+    return 1;
+}
+
+/* the optional (per_frame) etc after @sampler, @buffer and @uniform. Per draw if there is none */
+ShadBool shad__consume_frequency(ShadParser *p, ShadFrequency *frequency) {
+    *frequency = SHAD_FREQUENCY_PER_DRAW;
+    if (!shad__match(p, "(")) return 1;
+    return shad__consume_frequency_name(p, frequency) && shad__match(p, ")");
+}
+
+char* shad__consume_texture(ShadParser *p, ShadFrequency *frequency) {
     char *format = NULL;
+    *frequency = SHAD_FREQUENCY_PER_DRAW;
     if (shad__match(p, "(")) {
         while (1) {
             if (shad__match(p, ",")) continue;
@@ -544,6 +710,7 @@ char* shad__consume_texture(ShadParser *p) {
                 if (!shad__match(p, "=")) return 0;
                 if (!(format = shad__consume_identifier(p))) return 0;
             }
+            else if (!shad__consume_frequency_name(p, frequency)) return 0;
         }
     }
     return format;
@@ -676,15 +843,17 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
     typedef struct ShadAstFragText      {ShadAst base; char *start; char *end;} ShadAstFragText;
     typedef struct ShadAstVertIn    {ShadAst base; ShadVertexInput attr;} ShadAstVertIn;
     typedef struct ShadAstVertOut   {ShadAst base;} ShadAstVertOut;
-    typedef struct ShadAstVertSampler   {ShadAst base;} ShadAstVertSampler;
-    typedef struct ShadAstVertBuffer    {ShadAst base; ShadBool readonly; ShadBool writeonly;} ShadAstVertBuffer;
-    typedef struct ShadAstVertTexture     {ShadAst base; char *format; ShadBool readonly; ShadBool writeonly;} ShadAstVertTexture;
-    typedef struct ShadAstVertUniform   {ShadAst base;} ShadAstVertUniform;
+    /* samplers, textures, buffers and uniforms all start like this */
+    typedef struct ShadAstResource      {ShadAst base; ShadFrequency frequency; int slot;} ShadAstResource;
+    typedef struct ShadAstVertSampler   {ShadAst base; ShadFrequency frequency; int slot;} ShadAstVertSampler;
+    typedef struct ShadAstVertBuffer    {ShadAst base; ShadFrequency frequency; int slot; ShadBool readonly; ShadBool writeonly;} ShadAstVertBuffer;
+    typedef struct ShadAstVertTexture     {ShadAst base; ShadFrequency frequency; int slot; char *format; ShadBool readonly; ShadBool writeonly;} ShadAstVertTexture;
+    typedef struct ShadAstVertUniform   {ShadAst base; ShadFrequency frequency; int slot;} ShadAstVertUniform;
     typedef struct ShadAstFragOut   {ShadAst base; ShadFragmentOutput out;} ShadAstFragOut;
-    typedef struct ShadAstFragSampler   {ShadAst base;} ShadAstFragSampler;
-    typedef struct ShadAstFragBuffer    {ShadAst base; ShadBool readonly; ShadBool writeonly;} ShadAstFragBuffer;
-    typedef struct ShadAstFragTexture     {ShadAst base; char *format; ShadBool readonly; ShadBool writeonly;} ShadAstFragTexture;
-    typedef struct ShadAstFragUniform   {ShadAst base;} ShadAstFragUniform;
+    typedef struct ShadAstFragSampler   {ShadAst base; ShadFrequency frequency; int slot;} ShadAstFragSampler;
+    typedef struct ShadAstFragBuffer    {ShadAst base; ShadFrequency frequency; int slot; ShadBool readonly; ShadBool writeonly;} ShadAstFragBuffer;
+    typedef struct ShadAstFragTexture     {ShadAst base; ShadFrequency frequency; int slot; char *format; ShadBool readonly; ShadBool writeonly;} ShadAstFragTexture;
+    typedef struct ShadAstFragUniform   {ShadAst base; ShadFrequency frequency; int slot;} ShadAstFragUniform;
 
     ShadArena tmp;
     ShadArena arena;
@@ -693,6 +862,7 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
     ShadBlendFactor curr_blend_src;
     ShadBlendFactor curr_blend_dst;
     ShadBlendOp curr_blend_op;
+    ShadFrequency frequency;
     ShadAst *ast_root;
     ShadAst **ast_ptr;
     ShadAst *ast;
@@ -701,6 +871,7 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
     int i, j, count;
     ShadWriter vertex_output;
     ShadWriter fragment_output;
+    int vertex_output_size, fragment_output_size;
 
     /* init */
     memset(&tmp, 0, sizeof(tmp));
@@ -953,22 +1124,25 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
                 SHAD_AST_PUSH(ShadAstVertIn, attr);
             }
             else if (shad__match_identifier(&p, "@sampler")) {
-                SHAD_AST_PUSH(ShadAstVertSampler);
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
+                SHAD_AST_PUSH(ShadAstVertSampler, frequency, 0);
             }
             else if (shad__match_identifier(&p, "@image")) {
-                char *format = shad__consume_texture(&p);
-                if (!format) SHAD_PARSE_ERROR("You must specify the texture format.\nExample:\n@image(format=rgba8) mytexture;\n\nValid formats are: %s", shad__texture_format_options);
+                char *format = shad__consume_texture(&p, &frequency);
+                if (!format) SHAD_PARSE_ERROR("You must specify the texture format, and optionally the update frequency.\nExample:\n@image(format=rgba8, per_frame) mytexture;\n\nValid formats are: %s", shad__texture_format_options);
                 ShadBool readonly = shad__match_identifier(&p, "readonly");
                 ShadBool writeonly = shad__match_identifier(&p, "writeonly");
-                SHAD_AST_PUSH(ShadAstVertTexture, format, readonly, writeonly);
+                SHAD_AST_PUSH(ShadAstVertTexture, frequency, 0, format, readonly, writeonly);
             }
             else if (shad__match_identifier(&p, "@buffer")) {
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
                 ShadBool readonly = shad__match_identifier(&p, "readonly");
                 ShadBool writeonly = shad__match_identifier(&p, "writeonly");
-                SHAD_AST_PUSH(ShadAstVertBuffer, readonly, writeonly);
+                SHAD_AST_PUSH(ShadAstVertBuffer, frequency, 0, readonly, writeonly);
             }
             else if (shad__match_identifier(&p, "@uniform")) {
-                SHAD_AST_PUSH(ShadAstVertUniform);
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
+                SHAD_AST_PUSH(ShadAstVertUniform, frequency, 0);
             }
             else if (shad__match_identifier(&p, "@out")) {
                 SHAD_AST_PUSH(ShadAstVertOut);
@@ -1015,22 +1189,25 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
                 SHAD_AST_PUSH(ShadAstFragOut, output);
             }
             else if (shad__match_identifier(&p, "@sampler")) {
-                SHAD_AST_PUSH(ShadAstFragSampler);
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
+                SHAD_AST_PUSH(ShadAstFragSampler, frequency, 0);
             }
             else if (shad__match_identifier(&p, "@image")) {
-                char *format = shad__consume_texture(&p);
-                if (!format) SHAD_PARSE_ERROR("You must specify the texture format.\nExample:\n@image(format=rgba8) mytexture;\n\nValid formats are: %s", shad__texture_format_options);
+                char *format = shad__consume_texture(&p, &frequency);
+                if (!format) SHAD_PARSE_ERROR("You must specify the texture format, and optionally the update frequency.\nExample:\n@image(format=rgba8, per_frame) mytexture;\n\nValid formats are: %s", shad__texture_format_options);
                 ShadBool readonly = shad__match_identifier(&p, "readonly");
                 ShadBool writeonly = shad__match_identifier(&p, "writeonly");
-                SHAD_AST_PUSH(ShadAstFragTexture, format, readonly, writeonly);
+                SHAD_AST_PUSH(ShadAstFragTexture, frequency, 0, format, readonly, writeonly);
             }
             else if (shad__match_identifier(&p, "@buffer")) {
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
                 ShadBool readonly = shad__match_identifier(&p, "readonly");
                 ShadBool writeonly = shad__match_identifier(&p, "writeonly");
-                SHAD_AST_PUSH(ShadAstFragBuffer, readonly, writeonly);
+                SHAD_AST_PUSH(ShadAstFragBuffer, frequency, 0, readonly, writeonly);
             }
             else if (shad__match_identifier(&p, "@uniform")) {
-                SHAD_AST_PUSH(ShadAstFragUniform);
+                if (!shad__consume_frequency(&p, &frequency)) SHAD_PARSE_ERROR("Invalid update frequency. Options are: per_frame, per_material, per_draw\nExample:\n@uniform(per_frame) {mat4 view;};");
+                SHAD_AST_PUSH(ShadAstFragUniform, frequency, 0);
             }
             else if (shad__match_identifier(&p, "@end")) {
                 state = END;
@@ -1060,6 +1237,27 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
         result->num_fragment_uniforms += ast->type == ShadAstFragUniformType;
     }
 
+    /* the slots of each kind of resource go by update frequency, then by the order they're declared in */
+    {
+        /* in the order of shad__frequency_counts() */
+        static const int resource_types[SHAD__NUM_RESOURCE_KINDS] = {
+            ShadAstVertSamplerType, ShadAstVertTextureType, ShadAstVertBufferType, ShadAstVertUniformType,
+            ShadAstFragSamplerType, ShadAstFragTextureType, ShadAstFragBufferType, ShadAstFragUniformType
+        };
+        for (i = 0; i < SHAD__NUM_RESOURCE_KINDS; ++i) {
+            int *counts = shad__frequency_counts(result, i);
+            int slot = 0, f;
+            for (f = 0; f < SHAD_FREQUENCY_COUNT; ++f) {
+                for (ast = ast_root; ast; ast = ast->next) {
+                    ShadAstResource *res = (ShadAstResource*)ast;
+                    if (ast->type != resource_types[i] || (int)res->frequency != f) continue;
+                    res->slot = slot++;
+                    ++counts[f];
+                }
+            }
+        }
+    }
+
     /* gather all the vertex inputs */
     result->vertex_inputs = SHAD_ALLOC(ShadVertexInput, &arena, result->num_vertex_inputs);
     for (i = 0, ast = ast_root; ast; ast = ast->next)
@@ -1085,14 +1283,15 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
             SHAD_ERROR(in->code_location, "All attributes for buffer %i must be specified as instanced", in->buffer_slot);
     }
 
-    /* calculate stride of vertex input buffers */
+    /* calculate offsets of vertex inputs, and stride of vertex input buffers */
     for (i = 0; i < result->num_vertex_input_buffers; ++i) {
         int size = 0, align = 0;
         ShadVertexInputBuffer *bi = result->vertex_input_buffers + i;
         for (j = 0; j < result->num_vertex_inputs; ++j) {
             ShadVertexInput *vi = &result->vertex_inputs[j];
             if (vi->buffer_slot != bi->slot) continue;
-            size = ((size + vi->align - 1) & ~(vi->align - 1)) + vi->size;
+            vi->offset = (size + vi->align - 1) & ~(vi->align - 1);
+            size = vi->offset + vi->size;
             align = SHAD_MAX(align, vi->align);
         }
         size = (size + align - 1) & ~(align - 1);
@@ -1110,6 +1309,22 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
     memset(&fragment_output, 0, sizeof(fragment_output));
     vertex_output.arena = &arena;
     fragment_output.arena = &arena;
+
+    /* size the outputs up front, so the source text is copied straight into its final place.
+       The annotations turn into short layout(...) prefixes, 128 bytes is plenty for those */
+    vertex_output_size = fragment_output_size = 64;
+    for (ast = ast_root; ast; ast = ast->next) {
+        if (ast->type == ShadAstTextType || ast->type == ShadAstVertTextType || ast->type == ShadAstFragTextType) {
+            ShadAstText *text = (ShadAstText*)ast;
+            if (ast->type != ShadAstFragTextType) vertex_output_size += (int)(text->end - text->start);
+            if (ast->type != ShadAstVertTextType) fragment_output_size += (int)(text->end - text->start);
+        }
+        else
+            vertex_output_size += 128, fragment_output_size += 128;
+    }
+    shad__writer_reserve(&vertex_output, vertex_output_size);
+    shad__writer_reserve(&fragment_output, fragment_output_size);
+
     shad__writer_print(&vertex_output, "#version 450\n");
     shad__writer_print(&fragment_output, "#version 450\n");
 
@@ -1117,15 +1332,11 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
         case SHAD_OUTPUT_FORMAT_SDL: {
             int vertex_input_index = 0;
             int vertex_output_index = 0;
-            int vertex_sampler_index = 0;
-            int vertex_image_index = result->num_vertex_samplers;
-            int vertex_buffer_index = result->num_vertex_samplers + result->num_vertex_images;
-            int vertex_uniform_index = 0;
+            int vertex_first_image = result->num_vertex_samplers;
+            int vertex_first_buffer = result->num_vertex_samplers + result->num_vertex_images;
             int fragment_output_index = 0;
-            int fragment_sampler_index = 0;
-            int fragment_image_index = result->num_fragment_samplers;
-            int fragment_buffer_index = result->num_fragment_samplers + result->num_fragment_images;
-            int fragment_uniform_index = 0;
+            int fragment_first_image = result->num_fragment_samplers;
+            int fragment_first_buffer = result->num_fragment_samplers + result->num_fragment_images;
             for (ast = ast_root; ast; ast = ast->next) {
                 switch (ast->type) {
                     case ShadAstTextType:
@@ -1133,9 +1344,9 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
                     case ShadAstFragTextType: {
                         ShadAstText *text = (ShadAstText*)ast;
                         if (ast->type == ShadAstVertTextType || ast->type == ShadAstTextType)
-                            shad__writer_print(&vertex_output, "%S", text->start, text->end);
+                            shad__writer_push(&vertex_output, text->start, (int)(text->end - text->start));
                         if (ast->type == ShadAstFragTextType || ast->type == ShadAstTextType)
-                            shad__writer_print(&fragment_output, "%S", text->start, text->end);
+                            shad__writer_push(&fragment_output, text->start, (int)(text->end - text->start));
                         break;
                     }
                     case ShadAstVertInType: {
@@ -1154,33 +1365,31 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
                         ++vertex_output_index;
                         break;
                     }
-                    case ShadAstVertSamplerType: shad__writer_print(&vertex_output, "layout(set = 0, binding = %i) uniform", vertex_sampler_index), ++vertex_sampler_index; break;
+                    case ShadAstVertSamplerType: shad__writer_print(&vertex_output, "layout(set = 0, binding = %i) uniform", ((ShadAstResource*)ast)->slot); break;
                     case ShadAstVertTextureType: {
                         ShadAstVertTexture *tex = (ShadAstVertTexture*)ast;
-                        shad__writer_print(&vertex_output, "layout(set = 0, binding = %i, %s) uniform%s", vertex_image_index, tex->format, tex->readonly ? " readonly" : tex->writeonly ? " writeonly" : ""), ++vertex_image_index; break;
+                        shad__writer_print(&vertex_output, "layout(set = 0, binding = %i, %s) uniform%s", vertex_first_image + tex->slot, tex->format, tex->readonly ? " readonly" : tex->writeonly ? " writeonly" : "");
                         break;
                     }
                     case ShadAstVertBufferType: {
                         ShadAstVertBuffer *buf = (ShadAstVertBuffer*)ast;
-                        shad__writer_print(&vertex_output, "layout(std140, set = 0, binding = %i) buffer%s Buffer%i", vertex_buffer_index, buf->readonly ? " readonly" : buf->writeonly ? " writeonly" : "", vertex_buffer_index);
-                        ++vertex_buffer_index;
+                        shad__writer_print(&vertex_output, "layout(std140, set = 0, binding = %i) buffer%s Buffer%i", vertex_first_buffer + buf->slot, buf->readonly ? " readonly" : buf->writeonly ? " writeonly" : "", vertex_first_buffer + buf->slot);
                         break;
                     }
-                    case ShadAstVertUniformType: shad__writer_print(&vertex_output, "layout(std140, set = 1, binding = %i) uniform Uniform%i", vertex_uniform_index, vertex_uniform_index), ++vertex_uniform_index; break;
+                    case ShadAstVertUniformType: shad__writer_print(&vertex_output, "layout(std140, set = 1, binding = %i) uniform Uniform%i", ((ShadAstResource*)ast)->slot, ((ShadAstResource*)ast)->slot); break;
                     case ShadAstFragOutType:     shad__writer_print(&fragment_output, "layout(location = %i) out", fragment_output_index), ++fragment_output_index; break;
-                    case ShadAstFragSamplerType: shad__writer_print(&fragment_output, "layout(set = 2, binding = %i) uniform", fragment_sampler_index), ++fragment_sampler_index; break;
+                    case ShadAstFragSamplerType: shad__writer_print(&fragment_output, "layout(set = 2, binding = %i) uniform", ((ShadAstResource*)ast)->slot); break;
                     case ShadAstFragTextureType: {
                         ShadAstFragTexture *tex = (ShadAstFragTexture*)ast;
-                        shad__writer_print(&fragment_output, "layout(set = 2, binding = %i, %s) uniform%s", fragment_image_index, tex->format, tex->readonly ? " readonly" : tex->writeonly ? " writeonly" : ""), ++fragment_image_index; break;
+                        shad__writer_print(&fragment_output, "layout(set = 2, binding = %i, %s) uniform%s", fragment_first_image + tex->slot, tex->format, tex->readonly ? " readonly" : tex->writeonly ? " writeonly" : "");
                         break;
                     }
                     case ShadAstFragBufferType: {
                         ShadAstFragBuffer *buf = (ShadAstFragBuffer*)ast;
-                        shad__writer_print(&fragment_output, "layout(std140, set = 2, binding = %i) buffer%s Buffer%i", fragment_buffer_index, buf->readonly ? " readonly" : buf->writeonly ? " writeonly" : "", fragment_buffer_index);
-                        ++fragment_buffer_index;
+                        shad__writer_print(&fragment_output, "layout(std140, set = 2, binding = %i) buffer%s Buffer%i", fragment_first_buffer + buf->slot, buf->readonly ? " readonly" : buf->writeonly ? " writeonly" : "", fragment_first_buffer + buf->slot);
                         break;
                     }
-                    case ShadAstFragUniformType: shad__writer_print(&fragment_output, "layout(std140, set = 3, binding = %i) uniform Uniform%i", fragment_uniform_index, fragment_uniform_index), ++fragment_uniform_index; break;
+                    case ShadAstFragUniformType: shad__writer_print(&fragment_output, "layout(std140, set = 3, binding = %i) uniform Uniform%i", ((ShadAstResource*)ast)->slot, ((ShadAstResource*)ast)->slot); break;
                 }
             }
             break;
@@ -1219,6 +1428,8 @@ ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadComp
     #undef SHAD_PARSE_ERROR
 }
 
+#endif /* SHAD_NO_COMPILER */
+
 ShadArena* shad__compilation_arena_get(ShadCompilation *compiled) {
     if (!compiled->arena) {
         ShadArena arena;
@@ -1229,83 +1440,779 @@ ShadArena* shad__compilation_arena_get(ShadCompilation *compiled) {
     return (ShadArena*)compiled->arena;
 }
 
+#define SHAD__SPIRV_WORDS_PER_LINE 8
+
+/* writes the words as 0x%08x, SHAD__SPIRV_WORDS_PER_LINE to a line. This is most of the generated code,
+   so we reserve the space up front and convert nibbles straight into the buffer instead of going through shad__writer_print() */
 void shad__serialize_spirv_to_code(ShadWriter *w, char *spirv, int spirv_size) {
-    while (spirv_size) shad__writer_print(w, "%x,", *(unsigned*)spirv), spirv += 4, spirv_size -= 4;
+    static const char hex[] = "0123456789abcdef";
+    int num_words = spirv_size / 4;
+    int num_lines = (num_words + SHAD__SPIRV_WORDS_PER_LINE - 1) / SHAD__SPIRV_WORDS_PER_LINE;
+    char *out;
+    int i;
+
+    shad__writer_reserve(w, num_words * 11 + num_lines * 5 + 1);
+    out = w->buf + w->len;
+    for (i = 0; i < num_words; ++i, spirv += 4) {
+        unsigned word;
+        memcpy(&word, spirv, 4);
+        if (i % SHAD__SPIRV_WORDS_PER_LINE == 0) memcpy(out, "\n    ", 5), out += 5;
+        out[0] = '0';
+        out[1] = 'x';
+        out[2] = hex[(word >> 28) & 15];
+        out[3] = hex[(word >> 24) & 15];
+        out[4] = hex[(word >> 20) & 15];
+        out[5] = hex[(word >> 16) & 15];
+        out[6] = hex[(word >> 12) & 15];
+        out[7] = hex[(word >> 8) & 15];
+        out[8] = hex[(word >> 4) & 15];
+        out[9] = hex[word & 15];
+        out[10] = ',';
+        out += 11;
+    }
+    if (num_words) *out++ = '\n';
+    *out = 0;
+    w->len = (int)(out - w->buf);
+}
+
+#define SHAD__SPIRV_BYTES_PER_LINE 32
+
+/* writes the bytes as string literal pieces, "\x03\x02...", SHAD__SPIRV_BYTES_PER_LINE to a line */
+void shad__serialize_spirv_to_string(ShadWriter *w, char *spirv, int spirv_size) {
+    static const char hex[] = "0123456789abcdef";
+    int num_lines = (spirv_size + SHAD__SPIRV_BYTES_PER_LINE - 1) / SHAD__SPIRV_BYTES_PER_LINE;
+    char *out;
+    int i;
+
+    shad__writer_reserve(w, spirv_size * 4 + num_lines * 7 + 1);
+    out = w->buf + w->len;
+    for (i = 0; i < spirv_size; ++i) {
+        unsigned char c = (unsigned char)spirv[i];
+        if (i % SHAD__SPIRV_BYTES_PER_LINE == 0) memcpy(out, "\n    \"", 6), out += 6;
+        out[0] = '\\';
+        out[1] = 'x';
+        out[2] = hex[c >> 4];
+        out[3] = hex[c & 15];
+        out += 4;
+        if (i % SHAD__SPIRV_BYTES_PER_LINE == SHAD__SPIRV_BYTES_PER_LINE - 1 || i == spirv_size - 1) *out++ = '"';
+    }
+    if (spirv_size) *out++ = '\n';
+    *out = 0;
+    w->len = (int)(out - w->buf);
+}
+
+/* SPIRV encoding
+
+    A compact, lossless encoding of SPIRV in the spirit of smol-v, for when size on disk matters.
+    varint(number of words), then a mode byte:
+        0: the words as they are, little-endian. Used if the input doesn't look like SPIRV
+        1: the 5 header words as varints, then for each instruction varint(word count), varint(opcode)
+           and the operands. Instructions with string operands keep their operands as little-endian words,
+           all other operands are stored as a zigzag varint of the difference to the same operand of the
+           last instruction with that opcode. That turns most ids and literals into 1-byte numbers.
+    Varints are 7 bits per byte, least significant first, high bit set on all but the last byte.
+*/
+
+#define SHAD__SPIRV_MAGIC 0x07230203u
+#define SHAD__SPIRV_DELTA_SLOTS 1024
+
+char* shad__varint_put(char *p, unsigned v) {
+    while (v >= 0x80) *p++ = (char)(v | 0x80), v >>= 7;
+    *p++ = (char)v;
+    return p;
+}
+
+/* returns NULL if the varint is malformed or runs past end */
+const char* shad__varint_get(const char *p, const char *end, unsigned *v_out) {
+    unsigned v = 0;
+    int shift;
+    for (shift = 0; p < end && shift < 35; shift += 7) {
+        unsigned char c = (unsigned char)*p++;
+        v |= (unsigned)(c & 0x7f) << shift;
+        if (!(c & 0x80)) {
+            *v_out = v;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+ShadBool shad__spirv_has_strings(unsigned op) {
+    switch (op) {
+        case 3:    /* OpSource */
+        case 4:    /* OpSourceExtension */
+        case 5:    /* OpName */
+        case 6:    /* OpMemberName */
+        case 7:    /* OpString */
+        case 10:   /* OpExtension */
+        case 11:   /* OpExtInstImport */
+        case 15:   /* OpEntryPoint */
+        case 330:  /* OpModuleProcessed */
+        case 5632: /* OpDecorateString */
+        case 5633: /* OpMemberDecorateString */
+            return 1;
+    }
+    return 0;
+}
+
+/* appends the encoding of spirv (native words) to w */
+void shad__spirv_encode(ShadWriter *w, const char *spirv, int size) {
+    unsigned prev[SHAD__SPIRV_DELTA_SLOTS];
+    unsigned num_words = (unsigned)size/4, i, j, word, wc;
+    ShadBool valid;
+    char *p;
+
+    shad__writer_reserve(w, 6);
+    p = shad__varint_put(w->buf + w->len, num_words);
+
+    /* only encode well-formed instruction streams */
+    valid = num_words >= 5;
+    if (valid) {
+        memcpy(&word, spirv, 4);
+        valid = word == SHAD__SPIRV_MAGIC;
+    }
+    for (i = 5; valid && i < num_words; i += wc) {
+        memcpy(&word, spirv + i*4, 4);
+        wc = word >> 16;
+        if (!wc || wc > num_words - i) valid = 0;
+    }
+
+    if (!valid) {
+        *p++ = 0;
+        w->len = (int)(p - w->buf);
+        shad__writer_reserve(w, (int)num_words*4);
+        for (i = 0, p = w->buf + w->len; i < num_words; ++i, p += 4) {
+            memcpy(&word, spirv + i*4, 4);
+            shad__put_u32(p, word);
+        }
+    } else {
+        *p++ = 1;
+        w->len = (int)(p - w->buf);
+        shad__writer_reserve(w, 5*5);
+        p = w->buf + w->len;
+        memset(prev, 0, sizeof(prev));
+        for (i = 0; i < 5; ++i) {
+            memcpy(&word, spirv + i*4, 4);
+            p = shad__varint_put(p, word);
+        }
+        for (i = 5; i < num_words; i += wc) {
+            unsigned op;
+            memcpy(&word, spirv + i*4, 4);
+            wc = word >> 16;
+            op = word & 0xffff;
+            /* reserved per instruction: word count and opcode are 16 bits, so at most 3 bytes each,
+               operands at most 5 bytes */
+            w->len = (int)(p - w->buf);
+            shad__writer_reserve(w, 6 + (int)(wc-1)*5);
+            p = w->buf + w->len;
+            p = shad__varint_put(p, wc);
+            p = shad__varint_put(p, op);
+            for (j = 1; j < wc; ++j) {
+                memcpy(&word, spirv + (i+j)*4, 4);
+                if (shad__spirv_has_strings(op)) {
+                    shad__put_u32(p, word);
+                    p += 4;
+                } else {
+                    unsigned *slot = &prev[(op*8 + (j < 8 ? j : 7)) & (SHAD__SPIRV_DELTA_SLOTS-1)];
+                    unsigned delta = word - *slot;
+                    *slot = word;
+                    p = shad__varint_put(p, (delta << 1) ^ (0u - (delta >> 31)));
+                }
+            }
+        }
+    }
+
+    w->len = (int)(p - w->buf);
+    w->buf[w->len] = 0;
+}
+
+/* returns how many words encoded SPIRV decodes to, or -1 if it's malformed or claims more words than
+   the data can hold (4 bytes per word when stored as is, at least 1 byte per word when encoded) */
+int shad__spirv_decoded_words(const char *in, int size) {
+    const char *end = in + size;
+    unsigned num_words, available;
+    if (!(in = shad__varint_get(in, end, &num_words)) || in >= end || num_words > 0x7fffffff/4) return -1;
+    available = (unsigned)(end - in - 1);
+    if (*in == 0) available /= 4;
+    else if (*in != 1) return -1;
+    if (num_words > available) return -1;
+    return (int)num_words;
+}
+
+/* decodes into out, which must fit shad__spirv_decoded_words() words. Returns false if the data is malformed */
+ShadBool shad__spirv_decode(const char *in, int size, unsigned *out) {
+    const char *end = in + size;
+    unsigned prev[SHAD__SPIRV_DELTA_SLOTS];
+    unsigned num_words, mode, i, j, v;
+
+    if (!(in = shad__varint_get(in, end, &num_words)) || in >= end) return 0;
+    mode = (unsigned char)*in++;
+
+    if (mode == 0) {
+        if ((unsigned)(end - in) / 4 < num_words) return 0;
+        for (i = 0; i < num_words; ++i)
+            out[i] = shad__get_u32(in + i*4);
+        return 1;
+    }
+
+    if (mode != 1 || num_words < 5) return 0;
+    for (i = 0; i < 5; ++i)
+        if (!(in = shad__varint_get(in, end, &out[i]))) return 0;
+
+    memset(prev, 0, sizeof(prev));
+    for (i = 5; i < num_words;) {
+        unsigned wc, op;
+        if (!(in = shad__varint_get(in, end, &wc)) || !(in = shad__varint_get(in, end, &op))) return 0;
+        if (!wc || wc > num_words - i || op > 0xffff) return 0;
+        out[i] = (wc << 16) | op;
+        if (shad__spirv_has_strings(op)) {
+            if ((unsigned)(end - in) / 4 < wc-1) return 0;
+            for (j = 1; j < wc; ++j, in += 4)
+                out[i+j] = shad__get_u32(in);
+        } else {
+            for (j = 1; j < wc; ++j) {
+                unsigned *slot = &prev[(op*8 + (j < 8 ? j : 7)) & (SHAD__SPIRV_DELTA_SLOTS-1)];
+                if (!(in = shad__varint_get(in, end, &v))) return 0;
+                *slot += (v >> 1) ^ (0u - (v & 1));
+                out[i+j] = *slot;
+            }
+        }
+        i += wc;
+    }
+    return 1;
+}
+
+/* returns the SPIRV as native words. In place if we're borrowing the data, otherwise decoded or copied into the arena */
+char* shad__load_spirv(ShadArena *arena, const char *raw, const char *encoded, int encoded_size, int size, ShadBool borrow) {
+    unsigned *words;
+    int i;
+    if (!size) return NULL;
+    if (!encoded && borrow) return (char*)raw;
+    words = (unsigned*)shad__alloc(arena, size, 4);
+    if (encoded) {
+        if (!shad__spirv_decode(encoded, encoded_size, words)) return NULL;
+    } else {
+        for (i = 0; i < size/4; ++i) words[i] = shad__get_u32(raw + i*4);
+    }
+    return (char*)words;
+}
+
+/* Binary format, version 2
+
+    Everything is a little-endian u32 and 4-byte aligned, so a buffer can be used in place
+    (see shad_compilation_deserialize_view()).
+
+    header, SHAD__V2_HEADER_SIZE bytes:
+         0  "SHAD"
+         1  version (2)
+         2  total size in bytes
+         3  checksum, shad__hash64() of everything after this word, folded to 32 bits
+         4  flags, SHAD__V2_FLAG_*
+         5  number of sections
+         6  has_fragment_shader
+         7  num_vertex_outputs
+         8  num_vertex_samplers, num_vertex_images, num_vertex_buffers, num_vertex_uniforms
+        12  num_fragment_samplers, num_fragment_images, num_fragment_buffers, num_fragment_uniforms
+        16  depth_write, depth_cmp, depth_format, depth_clip
+        20  cull_mode
+        21  primitive
+        22  multisample_count
+        23  reserved (0)
+
+    section table, one 16 byte entry per section:
+        tag (fourcc), offset from start of buffer, size in bytes, number of records
+
+    sections:
+        VSPV, FSPV  vertex/fragment SPIRV, one record per word
+        VSPZ, FSPZ  vertex/fragment SPIRV, encoded (see shad__spirv_encode()), one record per decoded word.
+                    Written instead of VSPV/FSPV by shad_compilation_serialize_compressed()
+        VINP        vertex inputs: format, buffer_slot, size, align, offset, flags (1 = flat, 2 = instanced)
+        VBUF        vertex input buffers: slot, instanced, stride
+        FOUT        fragment outputs: format, blend_src, blend_dst, blend_op
+        FREQ        the resource counts per ShadFrequency, SHAD_FREQUENCY_COUNT each for the vertex samplers, images,
+                    buffers and uniforms, then the fragment ones. One record. Left out if everything is per draw
+        SDLP        the pipeline arrays already translated to SDL3, laid out exactly like the SDL structs so
+                    shad_sdl_fill_pipeline() can memcpy them. One record:
+                        number of vertex buffers, vertex attributes and color targets, reserved (0)
+                        SDL_GPUVertexBufferDescription[]: slot, pitch, input_rate, instance_step_rate
+                        SDL_GPUVertexAttribute[]: location, buffer_slot, format, offset
+                        SDL_GPUColorTargetDescription[]: format, src/dst color blendfactor, color_blend_op,
+                            src/dst alpha blendfactor, alpha_blend_op, then the bytes color_write_mask,
+                            enable_blend, enable_color_write_mask and padding
+
+    Readers skip sections they don't know about.
+*/
+
+#define SHAD__V2_HEADER_SIZE 96
+#define SHAD__V2_SECTION_ENTRY_SIZE 16
+
+/* one past the last value of each enum, for range checking what we read */
+#define SHAD__NUM_VERTEX_ELEMENT_FORMATS (SHAD_VERTEXELEMENTFORMAT_USHORT4_NORM + 1)
+#define SHAD__NUM_BLEND_FACTORS (SHAD_BLEND_FACTOR_SRC_ALPHA_SATURATE + 1)
+#define SHAD__NUM_BLEND_OPS (SHAD_BLEND_OP_MAX + 1)
+#define SHAD__NUM_CULL_MODES (SHAD_CULL_MODE_BACK + 1)
+#define SHAD__NUM_COMPARE_OPS (SHAD_COMPARE_OP_ALWAYS + 1)
+#define SHAD__NUM_TEXTURE_FORMATS (SHAD_TEXTURE_FORMAT_D32F_S8 + 1)
+#define SHAD__NUM_PRIMITIVES (SHAD_PRIMITIVE_POINT_LIST + 1)
+#define SHAD__MAX_MULTISAMPLE_COUNT 8
+
+/* the SPIRV sections are left out because they're stored elsewhere, e.g. deduplicated in a pack */
+#define SHAD__V2_FLAG_EXTERNAL_SPIRV 1
+
+#define SHAD__FREQ_SIZE (SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_COUNT * 4)
+
+#define SHAD__SDLP_SIZE(num_buffers, num_attributes, num_targets) (16 + (num_buffers)*16 + (num_attributes)*16 + (num_targets)*32)
+
+/* SDL_GPUTextureFormat values for ShadTextureFormat. The SDLP section is written without the SDL headers,
+   so we rely on SDL3's stable ABI here (checked against the real enums in the SDL API section).
+   The vertex element formats, blend factors and blend ops have the same values in SDL3 as in shad */
+static const unsigned shad__sdl_texture_format_value[] = {
+    0,  /* SHAD_TEXTURE_FORMAT_INVALID */
+    2,  /* SHAD_TEXTURE_FORMAT_R8 */
+    3,  /* SHAD_TEXTURE_FORMAT_RG8 */
+    4,  /* SHAD_TEXTURE_FORMAT_RGBA8 */
+    5,  /* SHAD_TEXTURE_FORMAT_R16 */
+    6,  /* SHAD_TEXTURE_FORMAT_RG16 */
+    7,  /* SHAD_TEXTURE_FORMAT_RGBA16 */
+    27, /* SHAD_TEXTURE_FORMAT_R16F */
+    28, /* SHAD_TEXTURE_FORMAT_RG16F */
+    29, /* SHAD_TEXTURE_FORMAT_RGBA16F */
+    30, /* SHAD_TEXTURE_FORMAT_R32F */
+    31, /* SHAD_TEXTURE_FORMAT_RG32F */
+    32, /* SHAD_TEXTURE_FORMAT_RGBA32F */
+    33, /* SHAD_TEXTURE_FORMAT_R11G11B10F */
+    58, /* SHAD_TEXTURE_FORMAT_D16 */
+    59, /* SHAD_TEXTURE_FORMAT_D24 */
+    60, /* SHAD_TEXTURE_FORMAT_D32F */
+    61, /* SHAD_TEXTURE_FORMAT_D24_S8 */
+    62, /* SHAD_TEXTURE_FORMAT_D32F_S8 */
+};
+
+typedef struct ShadV2Writer {
+    char *buf; /* NULL when we're just measuring */
+    int size;
+    int num_sections;
+    /* encoded SPIRV, if we're compressing */
+    ShadWriter vertex_spirv;
+    ShadWriter fragment_spirv;
+} ShadV2Writer;
+
+/* adds a section to the table and returns where to write its data, or NULL when measuring */
+char* shad__v2_section(ShadV2Writer *w, const char *tag, int size, int count) {
+    char *data = NULL;
+    if (w->buf) {
+        char *entry = w->buf + SHAD__V2_HEADER_SIZE + w->num_sections * SHAD__V2_SECTION_ENTRY_SIZE;
+        memcpy(entry, tag, 4);
+        shad__put_u32(entry + 4, (unsigned)w->size);
+        shad__put_u32(entry + 8, (unsigned)size);
+        shad__put_u32(entry + 12, (unsigned)count);
+        data = w->buf + w->size;
+    }
+    w->size += (size + 3) & ~3;
+    ++w->num_sections;
+    return data;
+}
+
+void shad__v2_put_spirv(char *dst, const char *spirv, int size) {
+    unsigned word;
+    for (; size >= 4; dst += 4, spirv += 4, size -= 4) {
+        memcpy(&word, spirv, 4);
+        shad__put_u32(dst, word);
+    }
+}
+
+void shad__v2_write_sections(ShadV2Writer *w, ShadCompilation *compiled, unsigned flags) {
+    char *p;
+    int i;
+
+    if (flags & SHAD__V2_FLAG_EXTERNAL_SPIRV) {}
+    else if (w->vertex_spirv.buf) {
+        p = shad__v2_section(w, "VSPZ", w->vertex_spirv.len, compiled->spirv_vertex_code_size/4);
+        if (p) memcpy(p, w->vertex_spirv.buf, w->vertex_spirv.len);
+    } else {
+        p = shad__v2_section(w, "VSPV", compiled->spirv_vertex_code_size, compiled->spirv_vertex_code_size/4);
+        if (p) shad__v2_put_spirv(p, compiled->spirv_vertex_code, compiled->spirv_vertex_code_size);
+    }
+
+    if (!compiled->has_fragment_shader || (flags & SHAD__V2_FLAG_EXTERNAL_SPIRV)) {}
+    else if (w->fragment_spirv.buf) {
+        p = shad__v2_section(w, "FSPZ", w->fragment_spirv.len, compiled->spirv_fragment_code_size/4);
+        if (p) memcpy(p, w->fragment_spirv.buf, w->fragment_spirv.len);
+    } else {
+        p = shad__v2_section(w, "FSPV", compiled->spirv_fragment_code_size, compiled->spirv_fragment_code_size/4);
+        if (p) shad__v2_put_spirv(p, compiled->spirv_fragment_code, compiled->spirv_fragment_code_size);
+    }
+
+    p = shad__v2_section(w, "VINP", compiled->num_vertex_inputs * 24, compiled->num_vertex_inputs);
+    for (i = 0; p && i < compiled->num_vertex_inputs; ++i, p += 24) {
+        ShadVertexInput *in = &compiled->vertex_inputs[i];
+        shad__put_u32(p + 0, (unsigned)in->format);
+        shad__put_u32(p + 4, (unsigned)in->buffer_slot);
+        shad__put_u32(p + 8, (unsigned)in->size);
+        shad__put_u32(p + 12, (unsigned)in->align);
+        shad__put_u32(p + 16, (unsigned)in->offset);
+        shad__put_u32(p + 20, (in->is_flat ? 1u : 0u) | (in->instanced ? 2u : 0u));
+    }
+
+    p = shad__v2_section(w, "VBUF", compiled->num_vertex_input_buffers * 12, compiled->num_vertex_input_buffers);
+    for (i = 0; p && i < compiled->num_vertex_input_buffers; ++i, p += 12) {
+        ShadVertexInputBuffer *buf = &compiled->vertex_input_buffers[i];
+        shad__put_u32(p + 0, (unsigned)buf->slot);
+        shad__put_u32(p + 4, (unsigned)buf->instanced);
+        shad__put_u32(p + 8, (unsigned)buf->stride);
+    }
+
+    p = shad__v2_section(w, "FOUT", compiled->num_fragment_outputs * 16, compiled->num_fragment_outputs);
+    for (i = 0; p && i < compiled->num_fragment_outputs; ++i, p += 16) {
+        ShadFragmentOutput *out = &compiled->fragment_outputs[i];
+        shad__put_u32(p + 0, (unsigned)out->format);
+        shad__put_u32(p + 4, (unsigned)out->blend_src);
+        shad__put_u32(p + 8, (unsigned)out->blend_dst);
+        shad__put_u32(p + 12, (unsigned)out->blend_op);
+    }
+
+    for (i = 0; i < SHAD__NUM_RESOURCE_KINDS; ++i)
+        if (shad__frequency_counts(compiled, i)[SHAD_FREQUENCY_PER_DRAW] != shad__resource_count(compiled, i)) break;
+    if (i < SHAD__NUM_RESOURCE_KINDS) {
+        p = shad__v2_section(w, "FREQ", SHAD__FREQ_SIZE, 1);
+        for (i = 0; p && i < SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_COUNT; ++i, p += 4)
+            shad__put_u32(p, (unsigned)shad__frequency_counts(compiled, i / SHAD_FREQUENCY_COUNT)[i % SHAD_FREQUENCY_COUNT]);
+    }
+
+    p = shad__v2_section(w, "SDLP", SHAD__SDLP_SIZE(compiled->num_vertex_input_buffers, compiled->num_vertex_inputs, compiled->num_fragment_outputs), 1);
+    if (p) {
+        shad__put_u32(p + 0, (unsigned)compiled->num_vertex_input_buffers);
+        shad__put_u32(p + 4, (unsigned)compiled->num_vertex_inputs);
+        shad__put_u32(p + 8, (unsigned)compiled->num_fragment_outputs);
+        p += 16;
+        for (i = 0; i < compiled->num_vertex_input_buffers; ++i, p += 16) {
+            ShadVertexInputBuffer *buf = &compiled->vertex_input_buffers[i];
+            shad__put_u32(p + 0, (unsigned)buf->slot);
+            shad__put_u32(p + 4, (unsigned)buf->stride);
+            shad__put_u32(p + 8, buf->instanced ? 1u : 0u); /* SDL_GPU_VERTEXINPUTRATE_INSTANCE : SDL_GPU_VERTEXINPUTRATE_VERTEX */
+        }
+        for (i = 0; i < compiled->num_vertex_inputs; ++i, p += 16) {
+            ShadVertexInput *in = &compiled->vertex_inputs[i];
+            shad__put_u32(p + 0, (unsigned)i);
+            shad__put_u32(p + 4, (unsigned)in->buffer_slot);
+            shad__put_u32(p + 8, (unsigned)in->format);
+            shad__put_u32(p + 12, (unsigned)in->offset);
+        }
+        for (i = 0; i < compiled->num_fragment_outputs; ++i, p += 32) {
+            ShadFragmentOutput *out = &compiled->fragment_outputs[i];
+            shad__put_u32(p + 0, shad__sdl_texture_format_value[out->format]);
+            shad__put_u32(p + 4, (unsigned)out->blend_src);
+            shad__put_u32(p + 8, (unsigned)out->blend_dst);
+            shad__put_u32(p + 12, (unsigned)out->blend_op);
+            shad__put_u32(p + 16, (unsigned)out->blend_src);
+            shad__put_u32(p + 20, (unsigned)out->blend_dst);
+            shad__put_u32(p + 24, (unsigned)out->blend_op);
+            p[29] = out->blend_op != SHAD_BLEND_OP_INVALID; /* enable_blend */
+        }
+    }
+}
+
+unsigned shad__v2_checksum(const char *bytes, int num_bytes) {
+    uint64_t h = shad__hash64(bytes + 16, num_bytes - 16, 0);
+    return (unsigned)(h ^ (h >> 32));
+}
+
+/* serializes into memory allocated from arena, returns the size */
+int shad__v2_serialize(ShadCompilation *compiled, ShadArena *arena, unsigned flags, ShadBool compress, char **bytes_out) {
+    ShadV2Writer w;
+    char *h;
+    int size;
+
+    memset(&w, 0, sizeof(w));
+    if (compress && !(flags & SHAD__V2_FLAG_EXTERNAL_SPIRV)) {
+        w.vertex_spirv.arena = arena;
+        w.fragment_spirv.arena = arena;
+        shad__spirv_encode(&w.vertex_spirv, compiled->spirv_vertex_code, compiled->spirv_vertex_code_size);
+        if (compiled->has_fragment_shader)
+            shad__spirv_encode(&w.fragment_spirv, compiled->spirv_fragment_code, compiled->spirv_fragment_code_size);
+    }
+
+    /* measure */
+    shad__v2_write_sections(&w, compiled, flags);
+    size = SHAD__V2_HEADER_SIZE + w.num_sections * SHAD__V2_SECTION_ENTRY_SIZE + w.size;
+
+    /* write sections */
+    h = (char*)memset(shad__alloc(arena, size, 4), 0, size);
+    w.buf = h;
+    w.size = SHAD__V2_HEADER_SIZE + w.num_sections * SHAD__V2_SECTION_ENTRY_SIZE;
+    w.num_sections = 0;
+    shad__v2_write_sections(&w, compiled, flags);
+
+    /* header */
+    memcpy(h, "SHAD", 4);
+    shad__put_u32(h + 4*1, 2);
+    shad__put_u32(h + 4*2, (unsigned)size);
+    shad__put_u32(h + 4*4, flags);
+    shad__put_u32(h + 4*5, (unsigned)w.num_sections);
+    shad__put_u32(h + 4*6, (unsigned)compiled->has_fragment_shader);
+    shad__put_u32(h + 4*7, (unsigned)compiled->num_vertex_outputs);
+    shad__put_u32(h + 4*8, (unsigned)compiled->num_vertex_samplers);
+    shad__put_u32(h + 4*9, (unsigned)compiled->num_vertex_images);
+    shad__put_u32(h + 4*10, (unsigned)compiled->num_vertex_buffers);
+    shad__put_u32(h + 4*11, (unsigned)compiled->num_vertex_uniforms);
+    shad__put_u32(h + 4*12, (unsigned)compiled->num_fragment_samplers);
+    shad__put_u32(h + 4*13, (unsigned)compiled->num_fragment_images);
+    shad__put_u32(h + 4*14, (unsigned)compiled->num_fragment_buffers);
+    shad__put_u32(h + 4*15, (unsigned)compiled->num_fragment_uniforms);
+    shad__put_u32(h + 4*16, (unsigned)compiled->depth_write);
+    shad__put_u32(h + 4*17, (unsigned)compiled->depth_cmp);
+    shad__put_u32(h + 4*18, (unsigned)compiled->depth_format);
+    shad__put_u32(h + 4*19, (unsigned)compiled->depth_clip);
+    shad__put_u32(h + 4*20, (unsigned)compiled->cull_mode);
+    shad__put_u32(h + 4*21, (unsigned)compiled->primitive);
+    shad__put_u32(h + 4*22, (unsigned)compiled->multisample_count);
+    shad__put_u32(h + 4*3, shad__v2_checksum(h, size));
+
+    *bytes_out = h;
+    return size;
 }
 
 void shad_compilation_serialize(ShadCompilation *compiled, char **bytes_out, int *num_bytes_out) {
-    ShadArena *arena = shad__compilation_arena_get(compiled);
-    ShadWriter writer = {arena, NULL, 0, 0};
-    int version = 1;
+    *num_bytes_out = shad__v2_serialize(compiled, shad__compilation_arena_get(compiled), 0, 0, bytes_out);
+}
+
+void shad_compilation_serialize_compressed(ShadCompilation *compiled, char **bytes_out, int *num_bytes_out) {
+    *num_bytes_out = shad__v2_serialize(compiled, shad__compilation_arena_get(compiled), 0, 1, bytes_out);
+}
+
+/* checks that a buffer is a well-formed v2 compilation. The checksum is optional since it reads
+   the whole buffer, the structure alone is enough to read it safely */
+ShadBool shad__v2_validate(const char *bytes, int num_bytes, ShadBool verify_checksum) {
+    int num_sections, table_end, i;
+
+    if (num_bytes < SHAD__V2_HEADER_SIZE || num_bytes % 4) return 0;
+    if (memcmp(bytes, "SHAD", 4) != 0 || shad__get_u32(bytes + 4) != 2) return 0;
+    if (shad__get_u32(bytes + 8) != (unsigned)num_bytes) return 0;
+    if (verify_checksum && shad__get_u32(bytes + 12) != shad__v2_checksum(bytes, num_bytes)) return 0;
+
+    num_sections = (int)shad__get_u32(bytes + 20);
+    if (num_sections < 0 || num_sections > (num_bytes - SHAD__V2_HEADER_SIZE) / SHAD__V2_SECTION_ENTRY_SIZE) return 0;
+    table_end = SHAD__V2_HEADER_SIZE + num_sections * SHAD__V2_SECTION_ENTRY_SIZE;
+
+    for (i = 0; i < num_sections; ++i) {
+        const char *entry = bytes + SHAD__V2_HEADER_SIZE + i * SHAD__V2_SECTION_ENTRY_SIZE;
+        unsigned offset = shad__get_u32(entry + 4);
+        unsigned size = shad__get_u32(entry + 8);
+        unsigned count = shad__get_u32(entry + 12);
+        unsigned record_size = 0;
+        if (offset % 4 || offset < (unsigned)table_end || offset > (unsigned)num_bytes || size > (unsigned)num_bytes - offset) return 0;
+        if      (!memcmp(entry, "VSPV", 4) || !memcmp(entry, "FSPV", 4)) record_size = 4;
+        else if (!memcmp(entry, "VINP", 4)) record_size = 24;
+        else if (!memcmp(entry, "VBUF", 4)) record_size = 12;
+        else if (!memcmp(entry, "FOUT", 4)) record_size = 16;
+        else if (!memcmp(entry, "FREQ", 4)) record_size = SHAD__FREQ_SIZE;
+        if (record_size && (unsigned long long)count * record_size != size) return 0;
+    }
+    return 1;
+}
+
+/* finds a section in a validated v2 buffer */
+const char* shad__v2_find(const char *bytes, const char *tag, int *size_out, int *count_out) {
+    int num_sections = (int)shad__get_u32(bytes + 20);
+    int i;
+    for (i = 0; i < num_sections; ++i) {
+        const char *entry = bytes + SHAD__V2_HEADER_SIZE + i * SHAD__V2_SECTION_ENTRY_SIZE;
+        if (memcmp(entry, tag, 4)) continue;
+        if (size_out) *size_out = (int)shad__get_u32(entry + 8);
+        if (count_out) *count_out = (int)shad__get_u32(entry + 12);
+        return bytes + shad__get_u32(entry + 4);
+    }
+    if (size_out) *size_out = 0;
+    if (count_out) *count_out = 0;
+    return NULL;
+}
+
+/* the enums index lookup tables later on, so anything out of range is rejected */
+ShadBool shad__v2_enums_valid(const char *h, const char *vinp, int num_vertex_inputs, const char *fout, int num_fragment_outputs) {
     int i;
+    if (shad__get_u32(h + 4*17) >= SHAD__NUM_COMPARE_OPS || shad__get_u32(h + 4*18) >= SHAD__NUM_TEXTURE_FORMATS ||
+        shad__get_u32(h + 4*20) >= SHAD__NUM_CULL_MODES || shad__get_u32(h + 4*21) >= SHAD__NUM_PRIMITIVES ||
+        shad__get_u32(h + 4*22) > SHAD__MAX_MULTISAMPLE_COUNT)
+        return 0;
+    for (i = 0; i < num_vertex_inputs; ++i)
+        if (shad__get_u32(vinp + i*24) >= SHAD__NUM_VERTEX_ELEMENT_FORMATS) return 0;
+    for (i = 0; i < num_fragment_outputs; ++i) {
+        const char *out = fout + i*16;
+        if (shad__get_u32(out + 0) >= SHAD__NUM_TEXTURE_FORMATS ||
+            shad__get_u32(out + 4) >= SHAD__NUM_BLEND_FACTORS || shad__get_u32(out + 8) >= SHAD__NUM_BLEND_FACTORS ||
+            shad__get_u32(out + 12) >= SHAD__NUM_BLEND_OPS)
+            return 0;
+    }
+    return 1;
+}
 
-    #define SHAD_WRITE_N(ptr, size) shad__writer_push(&writer, (char*)(ptr), size);
-    #define SHAD_WRITE(ptr) SHAD_WRITE_N(ptr, sizeof(*(ptr)))
+/* the SDLP arrays go to the driver as they are, so they get the same checks. The counts must already match */
+ShadBool shad__v2_sdlp_valid(const char *sdlp, int num_buffers, int num_attributes, int num_targets) {
+    const char *p = sdlp + 16;
+    int i, f;
+    for (i = 0; i < num_buffers; ++i, p += 16)
+        if (shad__get_u32(p + 8) > 1) return 0; /* input_rate */
+    for (i = 0; i < num_attributes; ++i, p += 16)
+        if (shad__get_u32(p + 8) >= SHAD__NUM_VERTEX_ELEMENT_FORMATS) return 0;
+    for (i = 0; i < num_targets; ++i, p += 32) {
+        for (f = 0; f < SHAD__NUM_TEXTURE_FORMATS && shad__sdl_texture_format_value[f] != shad__get_u32(p); ++f) {}
+        if (f == SHAD__NUM_TEXTURE_FORMATS) return 0;
+        if (shad__get_u32(p + 4) >= SHAD__NUM_BLEND_FACTORS || shad__get_u32(p + 8) >= SHAD__NUM_BLEND_FACTORS ||
+            shad__get_u32(p + 16) >= SHAD__NUM_BLEND_FACTORS || shad__get_u32(p + 20) >= SHAD__NUM_BLEND_FACTORS ||
+            shad__get_u32(p + 12) >= SHAD__NUM_BLEND_OPS || shad__get_u32(p + 24) >= SHAD__NUM_BLEND_OPS)
+            return 0;
+        /* enable_blend, enable_color_write_mask */
+        if ((unsigned char)p[29] > 1 || (unsigned char)p[30] > 1) return 0;
+    }
+    return 1;
+}
 
-    /* magic number */
-    SHAD_WRITE_N("SHAD", 4);
+/* if borrow is set, the SPIRV is used in place and the checksum isn't verified (see shad_compilation_verify()),
+   otherwise it's copied into the compilation. flags must match the flags the data was serialized with */
+ShadBool shad__v2_deserialize(const char *bytes, int num_bytes, ShadCompilation *compiled, ShadBool borrow, unsigned flags) {
+    ShadArena arena;
+    const char *h = bytes;
+    const char *vspv, *fspv, *vspz, *fspz, *vinp, *vbuf, *fout, *freq, *sdlp;
+    int vspv_size, fspv_size, vspz_size, fspz_size, sdlp_size;
+    long long size;
+    int i;
 
-    /* version */
-    SHAD_WRITE(&version);
+    memset(&arena, 0, sizeof(arena));
+    memset(compiled, 0, sizeof(*compiled));
 
-    /* vertex shader info */
-    SHAD_WRITE(&compiled->spirv_vertex_code_size);
-    SHAD_WRITE_N(compiled->spirv_vertex_code, compiled->spirv_vertex_code_size);
-    SHAD_WRITE(&compiled->num_vertex_inputs);
-    for (i = 0; i < compiled->num_vertex_inputs; ++i) {
-        SHAD_WRITE(&compiled->vertex_inputs[i].format);
-        SHAD_WRITE(&compiled->vertex_inputs[i].buffer_slot);
-        SHAD_WRITE(&compiled->vertex_inputs[i].offset);
-        SHAD_WRITE(&compiled->vertex_inputs[i].instanced);
+    if (!shad__v2_validate(bytes, num_bytes, !borrow)) return 0;
+    if (shad__get_u32(bytes + 16) != flags) return 0;
+    /* SPIRV is consumed as native words */
+    if (borrow && (!shad__little_endian() || ((size_t)bytes & 3))) return 0;
+
+    vspv = shad__v2_find(bytes, "VSPV", &vspv_size, NULL);
+    fspv = shad__v2_find(bytes, "FSPV", &fspv_size, NULL);
+    vspz = shad__v2_find(bytes, "VSPZ", &vspz_size, NULL);
+    fspz = shad__v2_find(bytes, "FSPZ", &fspz_size, NULL);
+    if (vspz) vspv_size = shad__spirv_decoded_words(vspz, vspz_size)*4;
+    if (fspz) fspv_size = shad__spirv_decoded_words(fspz, fspz_size)*4;
+    if (vspv_size < 0 || fspv_size < 0) return 0;
+    vinp = shad__v2_find(bytes, "VINP", NULL, &compiled->num_vertex_inputs);
+    vbuf = shad__v2_find(bytes, "VBUF", NULL, &compiled->num_vertex_input_buffers);
+    fout = shad__v2_find(bytes, "FOUT", NULL, &compiled->num_fragment_outputs);
+    freq = shad__v2_find(bytes, "FREQ", NULL, NULL);
+    sdlp = shad__v2_find(bytes, "SDLP", &sdlp_size, NULL);
+    if (!shad__v2_enums_valid(h, vinp, compiled->num_vertex_inputs, fout, compiled->num_fragment_outputs) ||
+        (sdlp && (sdlp_size != SHAD__SDLP_SIZE(compiled->num_vertex_input_buffers, compiled->num_vertex_inputs, compiled->num_fragment_outputs) ||
+                 shad__get_u32(sdlp + 0) != (unsigned)compiled->num_vertex_input_buffers ||
+                 shad__get_u32(sdlp + 4) != (unsigned)compiled->num_vertex_inputs ||
+                 shad__get_u32(sdlp + 8) != (unsigned)compiled->num_fragment_outputs ||
+                 !shad__v2_sdlp_valid(sdlp, compiled->num_vertex_input_buffers, compiled->num_vertex_inputs, compiled->num_fragment_outputs)))) {
+        memset(compiled, 0, sizeof(*compiled));
+        return 0;
     }
-    SHAD_WRITE(&compiled->num_vertex_input_buffers);
-    for (i = 0; i < compiled->num_vertex_input_buffers; ++i) {
-        SHAD_WRITE(&compiled->vertex_input_buffers[i].slot);
-        SHAD_WRITE(&compiled->vertex_input_buffers[i].instanced);
-        SHAD_WRITE(&compiled->vertex_input_buffers[i].stride);
+
+    /* everything goes in one allocation */
+    size = (long long)sizeof(ShadArena) + SHAD_ALIGNOF(ShadArena);
+    size += (long long)compiled->num_vertex_inputs * sizeof(ShadVertexInput) + SHAD_ALIGNOF(ShadVertexInput);
+    size += (long long)compiled->num_vertex_input_buffers * sizeof(ShadVertexInputBuffer) + SHAD_ALIGNOF(ShadVertexInputBuffer);
+    size += (long long)compiled->num_fragment_outputs * sizeof(ShadFragmentOutput) + SHAD_ALIGNOF(ShadFragmentOutput);
+    if (!borrow || vspz) size += (long long)vspv_size + 4;
+    if (!borrow || fspz) size += (long long)fspv_size + 4;
+    if (!borrow && sdlp) size += (long long)sdlp_size + 4;
+    if (size > 0x7fffffff) {
+        memset(compiled, 0, sizeof(*compiled));
+        return 0;
+    }
+    shad__arena_reserve(&arena, (int)size);
+
+    compiled->has_fragment_shader = (ShadBool)shad__get_u32(h + 4*6);
+    compiled->num_vertex_outputs = (int)shad__get_u32(h + 4*7);
+    compiled->num_vertex_samplers = (int)shad__get_u32(h + 4*8);
+    compiled->num_vertex_images = (int)shad__get_u32(h + 4*9);
+    compiled->num_vertex_buffers = (int)shad__get_u32(h + 4*10);
+    compiled->num_vertex_uniforms = (int)shad__get_u32(h + 4*11);
+    compiled->num_fragment_samplers = (int)shad__get_u32(h + 4*12);
+    compiled->num_fragment_images = (int)shad__get_u32(h + 4*13);
+    compiled->num_fragment_buffers = (int)shad__get_u32(h + 4*14);
+    compiled->num_fragment_uniforms = (int)shad__get_u32(h + 4*15);
+    compiled->depth_write = (ShadBool)shad__get_u32(h + 4*16);
+    compiled->depth_cmp = (ShadCompareOp)shad__get_u32(h + 4*17);
+    compiled->depth_format = (ShadTextureFormat)shad__get_u32(h + 4*18);
+    compiled->depth_clip = (ShadBool)shad__get_u32(h + 4*19);
+    compiled->cull_mode = (ShadCullMode)shad__get_u32(h + 4*20);
+    compiled->primitive = (ShadPrimitive)shad__get_u32(h + 4*21);
+    compiled->multisample_count = (int)shad__get_u32(h + 4*22);
+
+    shad__frequencies_default(compiled);
+    for (i = 0; freq && i < SHAD__NUM_RESOURCE_KINDS; ++i) {
+        int *counts = shad__frequency_counts(compiled, i);
+        int f, total = 0, num_resources = shad__resource_count(compiled, i);
+        /* checking each count first keeps the sum from overflowing */
+        for (f = 0; f < SHAD_FREQUENCY_COUNT; ++f) {
+            unsigned count = shad__get_u32(freq + (i*SHAD_FREQUENCY_COUNT + f)*4);
+            if (num_resources < 0 || count > (unsigned)num_resources) break;
+            total += counts[f] = (int)count;
+        }
+        if (f < SHAD_FREQUENCY_COUNT || total != num_resources) {
+            shad__arena_destroy(&arena);
+            memset(compiled, 0, sizeof(*compiled));
+            return 0;
+        }
     }
-    SHAD_WRITE(&compiled->num_vertex_input_buffers);
-    SHAD_WRITE(&compiled->num_vertex_outputs);
-    SHAD_WRITE(&compiled->num_vertex_samplers);
-    SHAD_WRITE(&compiled->num_vertex_images);
-    SHAD_WRITE(&compiled->num_vertex_buffers);
-    SHAD_WRITE(&compiled->num_vertex_uniforms);
 
-    /* fragment shader info */
-    SHAD_WRITE(&compiled->has_fragment_shader);
-    SHAD_WRITE(&compiled->spirv_fragment_code_size);
-    SHAD_WRITE_N(compiled->spirv_fragment_code, compiled->spirv_fragment_code_size);
-    SHAD_WRITE(&compiled->num_fragment_outputs);
-    for (i = 0; i < compiled->num_fragment_outputs; ++i) {
-        SHAD_WRITE(&compiled->fragment_outputs[i].format);
-        SHAD_WRITE(&compiled->fragment_outputs[i].blend_src);
-        SHAD_WRITE(&compiled->fragment_outputs[i].blend_dst);
-        SHAD_WRITE(&compiled->fragment_outputs[i].blend_op);
+    compiled->vertex_inputs = SHAD_ALLOC(ShadVertexInput, &arena, compiled->num_vertex_inputs);
+    for (i = 0; i < compiled->num_vertex_inputs; ++i, vinp += 24) {
+        ShadVertexInput *in = &compiled->vertex_inputs[i];
+        unsigned flags = shad__get_u32(vinp + 20);
+        in->format = (ShadVertexElementFormat)shad__get_u32(vinp + 0);
+        in->buffer_slot = (int)shad__get_u32(vinp + 4);
+        in->size = (int)shad__get_u32(vinp + 8);
+        in->align = (int)shad__get_u32(vinp + 12);
+        in->offset = (int)shad__get_u32(vinp + 16);
+        in->is_flat = (flags & 1) != 0;
+        in->instanced = (flags & 2) != 0;
     }
-    SHAD_WRITE(&compiled->num_fragment_samplers);
-    SHAD_WRITE(&compiled->num_fragment_images);
-    SHAD_WRITE(&compiled->num_fragment_buffers);
-    SHAD_WRITE(&compiled->num_fragment_uniforms);
 
-    /* depth */
-    SHAD_WRITE(&compiled->depth_write);
-    SHAD_WRITE(&compiled->depth_cmp);
-    SHAD_WRITE(&compiled->depth_format);
-    SHAD_WRITE(&compiled->depth_clip);
+    compiled->vertex_input_buffers = SHAD_ALLOC(ShadVertexInputBuffer, &arena, compiled->num_vertex_input_buffers);
+    for (i = 0; i < compiled->num_vertex_input_buffers; ++i, vbuf += 12) {
+        ShadVertexInputBuffer *buf = &compiled->vertex_input_buffers[i];
+        buf->slot = (int)shad__get_u32(vbuf + 0);
+        buf->instanced = (ShadBool)shad__get_u32(vbuf + 4);
+        buf->stride = (int)shad__get_u32(vbuf + 8);
+    }
 
-    /* culling */
-    SHAD_WRITE(&compiled->cull_mode);
+    compiled->fragment_outputs = SHAD_ALLOC(ShadFragmentOutput, &arena, compiled->num_fragment_outputs);
+    for (i = 0; i < compiled->num_fragment_outputs; ++i, fout += 16) {
+        ShadFragmentOutput *out = &compiled->fragment_outputs[i];
+        out->format = (ShadTextureFormat)shad__get_u32(fout + 0);
+        out->blend_src = (ShadBlendFactor)shad__get_u32(fout + 4);
+        out->blend_dst = (ShadBlendFactor)shad__get_u32(fout + 8);
+        out->blend_op = (ShadBlendOp)shad__get_u32(fout + 12);
+    }
 
-    /* primitive */
-    SHAD_WRITE(&compiled->primitive);
+    compiled->spirv_vertex_code_size = vspv_size;
+    compiled->spirv_fragment_code_size = fspv_size;
+    compiled->spirv_vertex_code = shad__load_spirv(&arena, vspv, vspz, vspz_size, vspv_size, borrow);
+    compiled->spirv_fragment_code = shad__load_spirv(&arena, fspv, fspz, fspz_size, fspv_size, borrow);
+    if ((vspv_size && !compiled->spirv_vertex_code) || (fspv_size && !compiled->spirv_fragment_code)) {
+        shad__arena_destroy(&arena);
+        memset(compiled, 0, sizeof(*compiled));
+        return 0;
+    }
 
-    /* multisampling. Valid values are 1,2,4,8 */
-    SHAD_WRITE(&compiled->multisample_count);
+    /* the pretranslated SDL arrays are memcpy'd as is, so they have to be in native byte order */
+    if (sdlp && shad__little_endian()) {
+        if (!borrow) sdlp = (const char*)memcpy(shad__alloc(&arena, sdlp_size, 4), sdlp, sdlp_size);
+        compiled->sdl_pipeline = sdlp;
+    }
+
+    compiled->arena = SHAD_ALLOC(ShadArena, &arena, 1);
+    memcpy(compiled->arena, &arena, sizeof(arena));
+    return 1;
+}
+
+ShadBool shad_compilation_deserialize_view(const char *bytes, int num_bytes, ShadCompilation *compiled) {
+    return shad__v2_deserialize(bytes, num_bytes, compiled, 1, 0);
+}
 
-    /* copy out result */
-    *bytes_out = writer.buf;
-    *num_bytes_out = writer.len;
-    return;
+ShadBool shad_compilation_verify(const char *bytes, int num_bytes) {
+    return shad__v2_validate(bytes, num_bytes, 1);
 }
 
 ShadBool shad_compilation_deserialize(char *bytes, int num_bytes, ShadCompilation *compiled) {
@@ -1325,12 +2232,16 @@ ShadBool shad_compilation_deserialize(char *bytes, int num_bytes, ShadCompilatio
     } while (0)
     #define SHAD_READ(ptr) SHAD_READ_N(ptr, sizeof(*(ptr)))
 
+    /* version 2 has a fixed byte order */
+    if (num_bytes >= 8 && shad__get_u32(bytes + 4) == 2)
+        return shad__v2_deserialize(bytes, num_bytes, compiled, 0, 0);
+
     /* magic number */
     char magic[4];
     SHAD_READ_N(magic, 4);
     if (memcmp(magic, "SHAD", 4) != 0) goto err;
 
-    /* version */
+    /* version 1 is the fields in native byte order, one after the other */
     int version;
     SHAD_READ(&version);
     if (version != 1) goto err;
@@ -1395,6 +2306,7 @@ ShadBool shad_compilation_deserialize(char *bytes, int num_bytes, ShadCompilatio
     SHAD_READ(&compiled->multisample_count);
 
     if (num_bytes_remaining) goto err;
+    shad__frequencies_default(compiled);
 
     compiled->arena = SHAD_ALLOC(ShadArena, &arena, 1);
     memcpy(compiled->arena, &arena, sizeof(arena));
@@ -1408,32 +2320,1158 @@ ShadBool shad_compilation_deserialize(char *bytes, int num_bytes, ShadCompilatio
     #undef SHAD_READ_N
 }
 
-/* SDL API */
+void shad_compilation_compact(ShadCompilation *compiled) {
+    ShadCompilation result;
+    ShadArena arena;
+    int size;
+    int i;
 
-#ifdef SDL_VERSION
+    result = *compiled;
+    memset(&arena, 0, sizeof(arena));
 
-static const SDL_GPUCullMode shad_to_sdl_cull_mode[] = {
-    SDL_GPU_CULLMODE_NONE, /* SDL_GPU_CULLMODE_INVALID */
-    SDL_GPU_CULLMODE_NONE, /* SDL_GPU_CULLMODE_NONE */
-    SDL_GPU_CULLMODE_FRONT, /* SDL_GPU_CULLMODE_FRONT */
-    SDL_GPU_CULLMODE_BACK, /* SDL_GPU_CULLMODE_BACK */
-};
+    /* size of everything we keep, including worst case alignment padding */
+    size = (int)sizeof(ShadArena) + (int)SHAD_ALIGNOF(ShadArena);
+    size += compiled->num_vertex_inputs * (int)sizeof(ShadVertexInput) + (int)SHAD_ALIGNOF(ShadVertexInput);
+    size += compiled->num_vertex_input_buffers * (int)sizeof(ShadVertexInputBuffer) + (int)SHAD_ALIGNOF(ShadVertexInputBuffer);
+    size += compiled->num_fragment_outputs * (int)sizeof(ShadFragmentOutput) + (int)SHAD_ALIGNOF(ShadFragmentOutput);
+    size += compiled->spirv_vertex_code_size + 4;
+    size += compiled->spirv_fragment_code_size + 4;
+    if (compiled->sdl_pipeline) size += SHAD__SDLP_SIZE(compiled->num_vertex_input_buffers, compiled->num_vertex_inputs, compiled->num_fragment_outputs) + 4;
+    shad__arena_reserve(&arena, size);
+
+    /* the GLSL is only needed for compiling */
+    result.vertex_code = NULL;
+    result.vertex_code_size = 0;
+    result.fragment_code = NULL;
+    result.fragment_code_size = 0;
+
+    /* code locations point into the source files, which are long gone at this point */
+    memset(&result.depth_code_location, 0, sizeof(result.depth_code_location));
+    memset(&result.cull_code_location, 0, sizeof(result.cull_code_location));
+
+    result.vertex_inputs = SHAD_ALLOC(ShadVertexInput, &arena, compiled->num_vertex_inputs);
+    for (i = 0; i < compiled->num_vertex_inputs; ++i) {
+        ShadVertexInput *in = &result.vertex_inputs[i];
+        *in = compiled->vertex_inputs[i];
+        memset(&in->code_location, 0, sizeof(in->code_location));
+        in->component_type = NULL;
+        in->data_type = NULL;
+        in->name = NULL;
+    }
 
-static const SDL_GPUVertexElementFormat shad_to_sdl_vertex_element_format[] = {
-    SDL_GPU_VERTEXELEMENTFORMAT_INVALID, /* SHAD_VERTEXELEMENTFORMAT_INVALID */
-    SDL_GPU_VERTEXELEMENTFORMAT_INT, /* SHAD_VERTEXELEMENTFORMAT_INT */
-    SDL_GPU_VERTEXELEMENTFORMAT_INT2, /* SHAD_VERTEXELEMENTFORMAT_INT2 */
-    SDL_GPU_VERTEXELEMENTFORMAT_INT3, /* SHAD_VERTEXELEMENTFORMAT_INT3 */
-    SDL_GPU_VERTEXELEMENTFORMAT_INT4, /* SHAD_VERTEXELEMENTFORMAT_INT4 */
-    SDL_GPU_VERTEXELEMENTFORMAT_UINT, /* SHAD_VERTEXELEMENTFORMAT_UINT */
-    SDL_GPU_VERTEXELEMENTFORMAT_UINT2, /* SHAD_VERTEXELEMENTFORMAT_UINT2 */
-    SDL_GPU_VERTEXELEMENTFORMAT_UINT3, /* SHAD_VERTEXELEMENTFORMAT_UINT3 */
-    SDL_GPU_VERTEXELEMENTFORMAT_UINT4, /* SHAD_VERTEXELEMENTFORMAT_UINT4 */
-    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT, /* SHAD_VERTEXELEMENTFORMAT_FLOAT */
-    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, /* SHAD_VERTEXELEMENTFORMAT_FLOAT2 */
-    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, /* SHAD_VERTEXELEMENTFORMAT_FLOAT3 */
-    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, /* SHAD_VERTEXELEMENTFORMAT_FLOAT4 */
-    SDL_GPU_VERTEXELEMENTFORMAT_BYTE2, /* SHAD_VERTEXELEMENTFORMAT_BYTE2 */
+    result.vertex_input_buffers = SHAD_ALLOC(ShadVertexInputBuffer, &arena, compiled->num_vertex_input_buffers);
+    if (compiled->num_vertex_input_buffers)
+        memcpy(result.vertex_input_buffers, compiled->vertex_input_buffers, compiled->num_vertex_input_buffers * sizeof(ShadVertexInputBuffer));
+
+    result.fragment_outputs = SHAD_ALLOC(ShadFragmentOutput, &arena, compiled->num_fragment_outputs);
+    for (i = 0; i < compiled->num_fragment_outputs; ++i) {
+        ShadFragmentOutput *out = &result.fragment_outputs[i];
+        *out = compiled->fragment_outputs[i];
+        memset(&out->code_location, 0, sizeof(out->code_location));
+        memset(&out->blend_code_location, 0, sizeof(out->blend_code_location));
+    }
+
+    result.spirv_vertex_code = (char*)shad__alloc(&arena, compiled->spirv_vertex_code_size, 4);
+    if (compiled->spirv_vertex_code_size)
+        memcpy(result.spirv_vertex_code, compiled->spirv_vertex_code, compiled->spirv_vertex_code_size);
+    result.spirv_fragment_code = (char*)shad__alloc(&arena, compiled->spirv_fragment_code_size, 4);
+    if (compiled->spirv_fragment_code_size)
+        memcpy(result.spirv_fragment_code, compiled->spirv_fragment_code, compiled->spirv_fragment_code_size);
+    if (compiled->sdl_pipeline) {
+        int sdlp_size = SHAD__SDLP_SIZE(compiled->num_vertex_input_buffers, compiled->num_vertex_inputs, compiled->num_fragment_outputs);
+        result.sdl_pipeline = (const char*)memcpy(shad__alloc(&arena, sdlp_size, 4), compiled->sdl_pipeline, sdlp_size);
+    }
+
+    /* swap in the new arena */
+    result.arena = SHAD_ALLOC(ShadArena, &arena, 1);
+    memcpy(result.arena, &arena, sizeof(arena));
+    shad_compilation_free(compiled);
+    *compiled = result;
+}
+
+/* SPIRV is hashed as words, so the hash doesn't depend on the byte order of the host */
+uint64_t shad__hash_spirv(const char *spirv, int size, uint64_t seed) {
+    uint64_t h;
+    unsigned word;
+    int i;
+    if (shad__little_endian()) return shad__hash64(spirv, size, seed);
+    h = shad__hash64_begin(size, seed);
+    for (i = 0; i + 4 <= size; i += 4) {
+        memcpy(&word, spirv + i, 4);
+        h = shad__hash64_word(h, word);
+    }
+    for (; i < size; ++i)
+        h = shad__hash64_word(h, (unsigned char)spirv[i]);
+    return shad__hash64_end(h);
+}
+
+uint64_t shad_compilation_hash(const ShadCompilation *compiled, ShadCompilationHash *hash_out) {
+    ShadCompilationHash hash;
+    char *p;
+    char all[64 + SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_PER_DRAW * 4];
+    uint64_t h;
+    int i;
+
+    hash.vertex_spirv = shad__hash_spirv(compiled->spirv_vertex_code, compiled->spirv_vertex_code_size, 1);
+    hash.fragment_spirv = compiled->has_fragment_shader ? shad__hash_spirv(compiled->spirv_fragment_code, compiled->spirv_fragment_code_size, 2) : 0;
+
+    /* pipeline state, as words in a fixed order. Hashed as it's read so looking up a compilation doesn't allocate */
+    h = shad__hash64_begin(4 * (10 + compiled->num_vertex_input_buffers*3 + compiled->num_vertex_inputs*3 + compiled->num_fragment_outputs*4), 3);
+    h = shad__hash64_word(h, (unsigned)compiled->depth_write);
+    h = shad__hash64_word(h, (unsigned)compiled->depth_cmp);
+    h = shad__hash64_word(h, (unsigned)compiled->depth_format);
+    h = shad__hash64_word(h, (unsigned)compiled->depth_clip);
+    h = shad__hash64_word(h, (unsigned)compiled->cull_mode);
+    h = shad__hash64_word(h, (unsigned)compiled->primitive);
+    h = shad__hash64_word(h, (unsigned)compiled->multisample_count);
+    h = shad__hash64_word(h, (unsigned)compiled->num_vertex_input_buffers);
+    for (i = 0; i < compiled->num_vertex_input_buffers; ++i) {
+        ShadVertexInputBuffer *vb = &compiled->vertex_input_buffers[i];
+        h = shad__hash64_word(h, (unsigned)vb->slot);
+        h = shad__hash64_word(h, (unsigned)vb->instanced);
+        h = shad__hash64_word(h, (unsigned)vb->stride);
+    }
+    h = shad__hash64_word(h, (unsigned)compiled->num_vertex_inputs);
+    for (i = 0; i < compiled->num_vertex_inputs; ++i) {
+        ShadVertexInput *in = &compiled->vertex_inputs[i];
+        h = shad__hash64_word(h, (unsigned)in->format);
+        h = shad__hash64_word(h, (unsigned)in->buffer_slot);
+        h = shad__hash64_word(h, (unsigned)in->offset);
+    }
+    h = shad__hash64_word(h, (unsigned)compiled->num_fragment_outputs);
+    for (i = 0; i < compiled->num_fragment_outputs; ++i) {
+        ShadFragmentOutput *out = &compiled->fragment_outputs[i];
+        h = shad__hash64_word(h, (unsigned)out->format);
+        h = shad__hash64_word(h, (unsigned)out->blend_src);
+        h = shad__hash64_word(h, (unsigned)out->blend_dst);
+        h = shad__hash64_word(h, (unsigned)out->blend_op);
+    }
+    hash.pipeline = shad__hash64_end(h);
+
+    /* everything, including the shader resource counts */
+    p = all;
+    shad__put_u32(p, (unsigned)hash.vertex_spirv), p += 4;
+    shad__put_u32(p, (unsigned)(hash.vertex_spirv >> 32)), p += 4;
+    shad__put_u32(p, (unsigned)hash.fragment_spirv), p += 4;
+    shad__put_u32(p, (unsigned)(hash.fragment_spirv >> 32)), p += 4;
+    shad__put_u32(p, (unsigned)hash.pipeline), p += 4;
+    shad__put_u32(p, (unsigned)(hash.pipeline >> 32)), p += 4;
+    shad__put_u32(p, (unsigned)compiled->has_fragment_shader), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_vertex_outputs), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_vertex_samplers), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_vertex_images), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_vertex_buffers), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_vertex_uniforms), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_fragment_samplers), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_fragment_images), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_fragment_buffers), p += 4;
+    shad__put_u32(p, (unsigned)compiled->num_fragment_uniforms), p += 4;
+    /* the update frequencies decide the generated bind helpers. Everything else is per draw, so they're only
+       hashed if something isn't, which keeps the hash of untagged compilations as it was */
+    for (i = 0; i < SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_PER_DRAW; ++i)
+        if (shad__frequency_counts((ShadCompilation*)compiled, i / SHAD_FREQUENCY_PER_DRAW)[i % SHAD_FREQUENCY_PER_DRAW]) break;
+    if (i < SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_PER_DRAW) {
+        for (i = 0; i < SHAD__NUM_RESOURCE_KINDS * SHAD_FREQUENCY_PER_DRAW; ++i)
+            shad__put_u32(p, (unsigned)shad__frequency_counts((ShadCompilation*)compiled, i / SHAD_FREQUENCY_PER_DRAW)[i % SHAD_FREQUENCY_PER_DRAW]), p += 4;
+    }
+    hash.all = shad__hash64(all, (int)(p - all), 4);
+
+    if (hash_out) *hash_out = hash;
+    return hash.all;
+}
+
+/******
+
+    Packs
+
+    Many compilations in one file. Layout, everything a little-endian u32 and 4-byte aligned:
+
+    header, SHAD__PACK_HEADER_SIZE bytes:
+        "SPAK", version (1), total size in bytes, number of entries,
+        offset of the entry table, offset of the name index, number of index slots, offset of the name strings
+    data:
+        SPIRV modules, each stored once no matter how many entries use it. Encoded if the writer had compress_spirv set
+        one compilation per entry, in binary format v2 without the SPIRV sections (SHAD__V2_FLAG_EXTERNAL_SPIRV)
+    entry table, SHAD__PACK_ENTRY_SIZE bytes per entry:
+        name offset (into the name strings), name length, name hash,
+        compilation offset, compilation size,
+        vertex SPIRV offset, vertex SPIRV size, fragment SPIRV offset, fragment SPIRV size,
+        flags (1 = vertex SPIRV is encoded, 2 = fragment SPIRV is encoded, see shad__spirv_encode())
+    name index:
+        open addressing hash table keyed by name hash, each slot is entry index + 1, or 0 if empty
+    name strings:
+        null terminated names
+
+******/
+
+#define SHAD__PACK_HEADER_SIZE 32
+#define SHAD__PACK_ENTRY_SIZE 40
+
+typedef struct ShadPackWriterEntry {
+    int name_offset;
+    int name_len;
+    unsigned name_hash;
+    int offset, size;
+    int vertex_offset, vertex_size;
+    int fragment_offset, fragment_size;
+    unsigned flags;
+} ShadPackWriterEntry;
+
+typedef struct ShadPackWriterModule {
+    uint64_t hash;
+    int offset;
+    int size;
+} ShadPackWriterModule;
+
+unsigned shad__pack_name_hash(const char *name, int len) {
+    return (unsigned)shad__hash64(name, len, 0);
+}
+
+void shad__pack_write(ShadPackWriter *w, const void *data, int size) {
+    static const char zero[4] = {0};
+    int pad = -size & 3;
+    if (size && fwrite(data, 1, size, (FILE*)w->file) != (size_t)size) w->failed = 1;
+    if (pad && fwrite(zero, 1, pad, (FILE*)w->file) != (size_t)pad) w->failed = 1;
+    w->size += size + pad;
+}
+
+/* writes a SPIRV module unless an identical one is already in the pack, returns its offset.
+   size is updated to the stored size, which differs if we're compressing */
+int shad__pack_write_module(ShadPackWriter *w, const char *spirv, int *size_inout) {
+    ShadPackWriterModule *modules = (ShadPackWriterModule*)w->modules;
+    int size = *size_inout;
+    uint64_t hash;
+    int i, slot, offset;
+    char *le, *existing;
+    ShadArena tmp;
+
+    if (!size) return 0;
+
+    /* the pack stores little-endian words, or their encoding */
+    memset(&tmp, 0, sizeof(tmp));
+    if (w->compress_spirv) {
+        ShadWriter encoded = {&tmp, NULL, 0, 0};
+        shad__spirv_encode(&encoded, spirv, size);
+        le = encoded.buf;
+        size = *size_inout = encoded.len;
+    } else {
+        le = (char*)shad__alloc(&tmp, size, 4);
+        shad__v2_put_spirv(le, spirv, size);
+    }
+    hash = shad__hash64(le, size, 0);
+
+    /* grow the lookup table so it stays at most half full */
+    if ((w->num_modules+1)*2 > w->module_slots_cap) {
+        int cap = w->module_slots_cap ? w->module_slots_cap*2 : 64;
+        int *slots = (int*)calloc(cap, sizeof(int));
+        for (i = 0; i < w->num_modules; ++i) {
+            for (slot = (int)(modules[i].hash & (cap-1)); slots[slot]; slot = (slot+1) & (cap-1));
+            slots[slot] = i+1;
+        }
+        free(w->module_slots);
+        w->module_slots = slots;
+        w->module_slots_cap = cap;
+        w->modules = modules = (ShadPackWriterModule*)realloc(modules, cap/2 * sizeof(*modules));
+    }
+
+    /* look for an identical module, comparing the bytes in case of hash collisions */
+    for (slot = (int)(hash & (w->module_slots_cap-1)); w->module_slots[slot]; slot = (slot+1) & (w->module_slots_cap-1)) {
+        ShadPackWriterModule *m = &modules[w->module_slots[slot]-1];
+        ShadBool same;
+        if (m->hash != hash || m->size != size) continue;
+        existing = (char*)malloc(size);
+        fflush((FILE*)w->file);
+        fseek((FILE*)w->file, m->offset, SEEK_SET);
+        same = fread(existing, 1, size, (FILE*)w->file) == (size_t)size && !memcmp(existing, le, size);
+        fseek((FILE*)w->file, 0, SEEK_END);
+        free(existing);
+        if (same) {
+            shad__arena_destroy(&tmp);
+            w->bytes_deduplicated += size;
+            return m->offset;
+        }
+    }
+
+    offset = w->size;
+    shad__pack_write(w, le, size);
+    shad__arena_destroy(&tmp);
+    modules[w->num_modules].hash = hash;
+    modules[w->num_modules].offset = offset;
+    modules[w->num_modules].size = size;
+    w->module_slots[slot] = ++w->num_modules;
+    return offset;
+}
+
+ShadBool shad_pack_writer_begin(ShadPackWriter *w, const char *path) {
+    char header[SHAD__PACK_HEADER_SIZE] = {0};
+    memset(w, 0, sizeof(*w));
+    /* we read modules back to compare them, hence w+ */
+    w->file = fopen(path, "w+b");
+    if (!w->file) return 0;
+    w->arena = memset(malloc(sizeof(ShadArena)), 0, sizeof(ShadArena));
+    shad__pack_write(w, header, sizeof(header));
+    return !w->failed;
+}
+
+ShadBool shad_pack_writer_add(ShadPackWriter *w, const char *name, ShadCompilation *compiled) {
+    ShadPackWriterEntry *e;
+    ShadArena tmp;
+    ShadWriter names;
+    char *bytes;
+
+    if (w->failed) return 0;
+
+    if (w->num_entries == w->entries_cap) {
+        w->entries_cap = w->entries_cap ? w->entries_cap*2 : 64;
+        w->entries = realloc(w->entries, w->entries_cap * sizeof(ShadPackWriterEntry));
+    }
+    e = (ShadPackWriterEntry*)w->entries + w->num_entries++;
+    memset(e, 0, sizeof(*e));
+
+    /* name, stored with its null terminator */
+    names.arena = (ShadArena*)w->arena;
+    names.buf = w->names;
+    names.len = w->names_len;
+    names.cap = w->names_cap;
+    e->name_offset = names.len;
+    e->name_len = (int)strlen(name);
+    e->name_hash = shad__pack_name_hash(name, e->name_len);
+    shad__writer_push(&names, (char*)name, e->name_len + 1);
+    w->names = names.buf;
+    w->names_len = names.len;
+    w->names_cap = names.cap;
+
+    /* modules */
+    e->flags = w->compress_spirv ? 3 : 0;
+    e->vertex_size = compiled->spirv_vertex_code_size;
+    e->vertex_offset = shad__pack_write_module(w, compiled->spirv_vertex_code, &e->vertex_size);
+    if (compiled->has_fragment_shader) {
+        e->fragment_size = compiled->spirv_fragment_code_size;
+        e->fragment_offset = shad__pack_write_module(w, compiled->spirv_fragment_code, &e->fragment_size);
+    }
+
+    /* everything else */
+    memset(&tmp, 0, sizeof(tmp));
+    e->offset = w->size;
+    e->size = shad__v2_serialize(compiled, &tmp, SHAD__V2_FLAG_EXTERNAL_SPIRV, 0, &bytes);
+    shad__pack_write(w, bytes, e->size);
+    shad__arena_destroy(&tmp);
+
+    return !w->failed;
+}
+
+ShadBool shad_pack_writer_end(ShadPackWriter *w) {
+    ShadPackWriterEntry *entries = (ShadPackWriterEntry*)w->entries;
+    char header[SHAD__PACK_HEADER_SIZE];
+    char entry[SHAD__PACK_ENTRY_SIZE];
+    int toc_offset, index_offset, names_offset, num_slots;
+    unsigned *slots;
+    int i, slot;
+
+    if (!w->file) return 0;
+
+    /* entry table */
+    toc_offset = w->size;
+    for (i = 0; i < w->num_entries; ++i) {
+        ShadPackWriterEntry *e = &entries[i];
+        shad__put_u32(entry + 0, (unsigned)e->name_offset);
+        shad__put_u32(entry + 4, (unsigned)e->name_len);
+        shad__put_u32(entry + 8, e->name_hash);
+        shad__put_u32(entry + 12, (unsigned)e->offset);
+        shad__put_u32(entry + 16, (unsigned)e->size);
+        shad__put_u32(entry + 20, (unsigned)e->vertex_offset);
+        shad__put_u32(entry + 24, (unsigned)e->vertex_size);
+        shad__put_u32(entry + 28, (unsigned)e->fragment_offset);
+        shad__put_u32(entry + 32, (unsigned)e->fragment_size);
+        shad__put_u32(entry + 36, e->flags);
+        shad__pack_write(w, entry, sizeof(entry));
+    }
+
+    /* name index */
+    for (num_slots = 2; num_slots < w->num_entries*2; num_slots *= 2);
+    slots = (unsigned*)calloc(num_slots, sizeof(unsigned));
+    for (i = 0; i < w->num_entries; ++i) {
+        ShadPackWriterEntry *e = &entries[i];
+        for (slot = (int)(e->name_hash & (num_slots-1)); slots[slot]; slot = (slot+1) & (num_slots-1)) {
+            ShadPackWriterEntry *other = &entries[slots[slot]-1];
+            if (other->name_len == e->name_len && !memcmp(w->names + other->name_offset, w->names + e->name_offset, e->name_len)) {
+                fprintf(stderr, "Error: Duplicate name in pack: %s\n", w->names + e->name_offset);
+                w->failed = 1;
+            }
+        }
+        slots[slot] = i+1;
+    }
+    index_offset = w->size;
+    for (i = 0; i < num_slots; ++i) {
+        char s[4];
+        shad__put_u32(s, slots[i]);
+        shad__pack_write(w, s, 4);
+    }
+    free(slots);
+
+    /* names */
+    names_offset = w->size;
+    shad__pack_write(w, w->names, w->names_len);
+
+    /* header */
+    memcpy(header, "SPAK", 4);
+    shad__put_u32(header + 4, 1);
+    shad__put_u32(header + 8, (unsigned)w->size);
+    shad__put_u32(header + 12, (unsigned)w->num_entries);
+    shad__put_u32(header + 16, (unsigned)toc_offset);
+    shad__put_u32(header + 20, (unsigned)index_offset);
+    shad__put_u32(header + 24, (unsigned)num_slots);
+    shad__put_u32(header + 28, (unsigned)names_offset);
+    if (fseek((FILE*)w->file, 0, SEEK_SET) || fwrite(header, 1, sizeof(header), (FILE*)w->file) != sizeof(header))
+        w->failed = 1;
+
+    if (fclose((FILE*)w->file)) w->failed = 1;
+    w->file = NULL;
+    shad__arena_destroy((ShadArena*)w->arena);
+    free(w->arena);
+    free(w->entries);
+    free(w->modules);
+    free(w->module_slots);
+    w->arena = w->entries = w->modules = NULL;
+    w->module_slots = NULL;
+    return !w->failed;
+}
+
+/* checks that the pack is well-formed, so lookups don't have to */
+ShadBool shad__pack_init(ShadPack *pack, const char *data, int size) {
+    unsigned num_entries, toc_offset, index_offset, num_slots, names_offset, num_empty = 0, i;
+
+    memset(pack, 0, sizeof(*pack));
+    if (size < SHAD__PACK_HEADER_SIZE || size % 4) return 0;
+    if (memcmp(data, "SPAK", 4) || shad__get_u32(data + 4) != 1 || shad__get_u32(data + 8) != (unsigned)size) return 0;
+
+    num_entries = shad__get_u32(data + 12);
+    toc_offset = shad__get_u32(data + 16);
+    index_offset = shad__get_u32(data + 20);
+    num_slots = shad__get_u32(data + 24);
+    names_offset = shad__get_u32(data + 28);
+    if (toc_offset > (unsigned)size || num_entries > ((unsigned)size - toc_offset) / SHAD__PACK_ENTRY_SIZE) return 0;
+    if (index_offset > (unsigned)size || num_slots > ((unsigned)size - index_offset) / 4) return 0;
+    if (!num_slots || (num_slots & (num_slots-1)) || num_slots <= num_entries) return 0;
+    if (names_offset > (unsigned)size) return 0;
+
+    for (i = 0; i < num_entries; ++i) {
+        const char *e = data + toc_offset + i*SHAD__PACK_ENTRY_SIZE;
+        unsigned name_offset = shad__get_u32(e + 0), name_len = shad__get_u32(e + 4);
+        unsigned j;
+        if (name_offset > (unsigned)size - names_offset || name_len >= (unsigned)size - names_offset - name_offset) return 0;
+        if (data[names_offset + name_offset + name_len] != 0) return 0;
+        /* compilation, vertex and fragment SPIRV */
+        for (j = 12; j < 36; j += 8) {
+            unsigned offset = shad__get_u32(e + j), len = shad__get_u32(e + j + 4);
+            if (offset % 4 || offset > (unsigned)size || len > (unsigned)size - offset) return 0;
+        }
+    }
+    /* probing stops at an empty slot, so there has to be one */
+    for (i = 0; i < num_slots; ++i) {
+        unsigned slot = shad__get_u32(data + index_offset + i*4);
+        if (slot > num_entries) return 0;
+        num_empty += !slot;
+    }
+    if (!num_empty) return 0;
+
+    pack->num_entries = (int)num_entries;
+    pack->data = data;
+    pack->size = size;
+    return 1;
+}
+
+ShadBool shad_pack_open_memory(const char *bytes, int num_bytes, ShadPack *pack) {
+    return shad__pack_init(pack, bytes, num_bytes);
+}
+
+ShadBool shad_pack_open(const char *path, ShadPack *pack) {
+    memset(pack, 0, sizeof(*pack));
+    #ifdef _WIN32
+    {
+        HANDLE file, mapping;
+        LARGE_INTEGER size;
+        const char *data;
+        file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (file == INVALID_HANDLE_VALUE) return 0;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart <= 0 || size.QuadPart > 0x7fffffff) {
+            CloseHandle(file);
+            return 0;
+        }
+        mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        /* the mapping keeps the file open */
+        CloseHandle(file);
+        if (!mapping) return 0;
+        data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        if (!data) return 0;
+        if (!shad__pack_init(pack, data, (int)size.QuadPart)) {
+            UnmapViewOfFile(data);
+            return 0;
+        }
+    }
+    #else
+    {
+        struct stat st;
+        void *data;
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) return 0;
+        if (fstat(fd, &st) || st.st_size <= 0 || st.st_size > 0x7fffffff) {
+            close(fd);
+            return 0;
+        }
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (data == MAP_FAILED) return 0;
+        if (!shad__pack_init(pack, (const char*)data, (int)st.st_size)) {
+            munmap(data, (size_t)st.st_size);
+            return 0;
+        }
+    }
+    #endif
+    pack->mapped = 1;
+    return 1;
+}
+
+void shad_pack_close(ShadPack *pack) {
+    if (pack->mapped) {
+        #ifdef _WIN32
+        UnmapViewOfFile(pack->data);
+        #else
+        munmap((void*)pack->data, (size_t)pack->size);
+        #endif
+    }
+    memset(pack, 0, sizeof(*pack));
+}
+
+const char* shad_pack_name(ShadPack *pack, int index) {
+    const char *e = pack->data + shad__get_u32(pack->data + 16) + index*SHAD__PACK_ENTRY_SIZE;
+    return pack->data + shad__get_u32(pack->data + 28) + shad__get_u32(e);
+}
+
+int shad_pack_find(ShadPack *pack, const char *name) {
+    const char *index;
+    unsigned num_slots;
+    int len = (int)strlen(name);
+    unsigned hash = shad__pack_name_hash(name, len);
+    unsigned slot, i;
+
+    if (!pack->data) return -1;
+    index = pack->data + shad__get_u32(pack->data + 20);
+    num_slots = shad__get_u32(pack->data + 24);
+    for (slot = hash & (num_slots-1); (i = shad__get_u32(index + slot*4)) != 0; slot = (slot+1) & (num_slots-1)) {
+        const char *e = pack->data + shad__get_u32(pack->data + 16) + (i-1)*SHAD__PACK_ENTRY_SIZE;
+        if (shad__get_u32(e + 8) == hash && shad__get_u32(e + 4) == (unsigned)len && !memcmp(shad_pack_name(pack, (int)i-1), name, len))
+            return (int)i-1;
+    }
+    return -1;
+}
+
+ShadBool shad_pack_get_index(ShadPack *pack, int index, ShadCompilation *compiled) {
+    const char *e;
+    const char *vspv, *fspv, *vspz = NULL, *fspz = NULL;
+    int vspv_size, fspv_size, vspz_size = 0, fspz_size = 0;
+    unsigned flags;
+    /* SPIRV is consumed as native words */
+    ShadBool borrow = shad__little_endian() && !((size_t)pack->data & 3);
+
+    memset(compiled, 0, sizeof(*compiled));
+    if (index < 0 || index >= pack->num_entries) return 0;
+
+    e = pack->data + shad__get_u32(pack->data + 16) + index*SHAD__PACK_ENTRY_SIZE;
+    if (!shad__v2_deserialize(pack->data + shad__get_u32(e + 12), (int)shad__get_u32(e + 16), compiled, borrow, SHAD__V2_FLAG_EXTERNAL_SPIRV))
+        return 0;
+
+    vspv = pack->data + shad__get_u32(e + 20);
+    vspv_size = (int)shad__get_u32(e + 24);
+    fspv = pack->data + shad__get_u32(e + 28);
+    fspv_size = (int)shad__get_u32(e + 32);
+    flags = shad__get_u32(e + 36);
+    if ((flags & 1) && vspv_size) vspz = vspv, vspz_size = vspv_size, vspv_size = shad__spirv_decoded_words(vspz, vspz_size)*4;
+    if ((flags & 2) && fspv_size) fspz = fspv, fspz_size = fspv_size, fspv_size = shad__spirv_decoded_words(fspz, fspz_size)*4;
+    compiled->spirv_vertex_code_size = vspv_size;
+    compiled->spirv_fragment_code_size = fspv_size;
+    if (vspv_size >= 0 && fspv_size >= 0) {
+        ShadArena *arena = shad__compilation_arena_get(compiled);
+        compiled->spirv_vertex_code = shad__load_spirv(arena, vspv, vspz, vspz_size, vspv_size, borrow);
+        compiled->spirv_fragment_code = shad__load_spirv(arena, fspv, fspz, fspz_size, fspv_size, borrow);
+    }
+    if (vspv_size < 0 || fspv_size < 0 || (vspv_size && !compiled->spirv_vertex_code) || (fspv_size && !compiled->spirv_fragment_code)) {
+        shad_compilation_free(compiled);
+        memset(compiled, 0, sizeof(*compiled));
+        return 0;
+    }
+    return 1;
+}
+
+ShadBool shad_pack_get(ShadPack *pack, const char *name, ShadCompilation *compiled) {
+    int index = shad_pack_find(pack, name);
+    if (index < 0) {
+        memset(compiled, 0, sizeof(*compiled));
+        return 0;
+    }
+    return shad_pack_get_index(pack, index, compiled);
+}
+
+/******
+
+    Pack loader
+
+    Decodes pack entries on a worker thread. Requests go into a priority queue behind a mutex,
+    finished entries come back through a lock-free stack that only the worker pushes to and only
+    the polling thread pops from. Define SHAD_NO_THREADS to leave this out.
+
+******/
+
+#ifndef SHAD_NO_THREADS
+
+typedef struct ShadPackLoaderRequest {
+    int priority;
+    unsigned seq;
+    int index;
+    void *userdata;
+} ShadPackLoaderRequest;
+
+typedef struct ShadPackLoaderNode {
+    struct ShadPackLoaderNode *next;
+    ShadPackLoadResult result;
+} ShadPackLoaderNode;
+
+typedef struct ShadPackLoaderSync {
+    #ifdef _WIN32
+    HANDLE thread;
+    CRITICAL_SECTION mutex;
+    CONDITION_VARIABLE has_requests;
+    CONDITION_VARIABLE has_results;
+    #else
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t has_requests;
+    pthread_cond_t has_results;
+    #endif
+} ShadPackLoaderSync;
+
+#ifdef _WIN32
+    #define SHAD__LOCK(s) EnterCriticalSection(&(s)->mutex)
+    #define SHAD__UNLOCK(s) LeaveCriticalSection(&(s)->mutex)
+    #define SHAD__WAIT(s, cond) SleepConditionVariableCS(&(s)->cond, &(s)->mutex, INFINITE)
+    #define SHAD__SIGNAL(s, cond) WakeConditionVariable(&(s)->cond)
+    #define SHAD__BROADCAST(s, cond) WakeAllConditionVariable(&(s)->cond)
+#else
+    #define SHAD__LOCK(s) pthread_mutex_lock(&(s)->mutex)
+    #define SHAD__UNLOCK(s) pthread_mutex_unlock(&(s)->mutex)
+    #define SHAD__WAIT(s, cond) pthread_cond_wait(&(s)->cond, &(s)->mutex)
+    #define SHAD__SIGNAL(s, cond) pthread_cond_signal(&(s)->cond)
+    #define SHAD__BROADCAST(s, cond) pthread_cond_broadcast(&(s)->cond)
+#endif
+
+/* completion stack. The worker pushes one node at a time, the poller takes the whole stack at once */
+void shad__loader_push_completed(ShadPackLoader *loader, ShadPackLoaderNode *node) {
+    #ifdef _WIN32
+    void *head;
+    do {
+        head = loader->completed;
+        node->next = (ShadPackLoaderNode*)head;
+    } while (InterlockedCompareExchangePointer(&loader->completed, node, head) != head);
+    #else
+    void *head = __atomic_load_n(&loader->completed, __ATOMIC_RELAXED);
+    do node->next = (ShadPackLoaderNode*)head;
+    while (!__atomic_compare_exchange_n(&loader->completed, &head, (void*)node, 1, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+    #endif
+}
+
+ShadPackLoaderNode* shad__loader_take_completed(ShadPackLoader *loader) {
+    #ifdef _WIN32
+    return (ShadPackLoaderNode*)InterlockedExchangePointer(&loader->completed, NULL);
+    #else
+    return (ShadPackLoaderNode*)__atomic_exchange_n(&loader->completed, (void*)NULL, __ATOMIC_ACQUIRE);
+    #endif
+}
+
+/* max-heap on priority, oldest first among equal priorities */
+ShadBool shad__loader_before(ShadPackLoaderRequest *a, ShadPackLoaderRequest *b) {
+    return a->priority != b->priority ? a->priority > b->priority : (int)(a->seq - b->seq) < 0;
+}
+
+void shad__loader_heap_push(ShadPackLoader *loader, ShadPackLoaderRequest r) {
+    ShadPackLoaderRequest *heap;
+    int i;
+    if (loader->num_requests == loader->requests_cap) {
+        loader->requests_cap = loader->requests_cap ? loader->requests_cap*2 : 64;
+        loader->requests = realloc(loader->requests, loader->requests_cap * sizeof(ShadPackLoaderRequest));
+    }
+    heap = (ShadPackLoaderRequest*)loader->requests;
+    for (i = loader->num_requests++; i > 0 && shad__loader_before(&r, &heap[(i-1)/2]); i = (i-1)/2)
+        heap[i] = heap[(i-1)/2];
+    heap[i] = r;
+}
+
+ShadPackLoaderRequest shad__loader_heap_pop(ShadPackLoader *loader) {
+    ShadPackLoaderRequest *heap = (ShadPackLoaderRequest*)loader->requests;
+    ShadPackLoaderRequest top = heap[0];
+    ShadPackLoaderRequest last = heap[--loader->num_requests];
+    int i = 0, child;
+    for (; (child = i*2+1) < loader->num_requests; i = child) {
+        if (child+1 < loader->num_requests && shad__loader_before(&heap[child+1], &heap[child])) ++child;
+        if (!shad__loader_before(&heap[child], &last)) break;
+        heap[i] = heap[child];
+    }
+    heap[i] = last;
+    return top;
+}
+
+#ifdef _WIN32
+DWORD WINAPI shad__loader_thread(void *arg)
+#else
+void* shad__loader_thread(void *arg)
+#endif
+{
+    ShadPackLoader *loader = (ShadPackLoader*)arg;
+    ShadPackLoaderSync *sync = (ShadPackLoaderSync*)loader->sync;
+
+    for (;;) {
+        ShadPackLoaderRequest r;
+        ShadPackLoaderNode *node;
+
+        SHAD__LOCK(sync);
+        while (!loader->num_requests && !loader->quit)
+            SHAD__WAIT(sync, has_requests);
+        if (loader->quit) {
+            SHAD__UNLOCK(sync);
+            break;
+        }
+        r = shad__loader_heap_pop(loader);
+        SHAD__UNLOCK(sync);
+
+        node = (ShadPackLoaderNode*)malloc(sizeof(*node));
+        node->result.index = r.index;
+        node->result.userdata = r.userdata;
+        node->result.ok = shad_pack_get_index(loader->pack, r.index, &node->result.compilation);
+        shad__loader_push_completed(loader, node);
+
+        /* only needed for shad_pack_loader_wait() */
+        SHAD__LOCK(sync);
+        SHAD__BROADCAST(sync, has_results);
+        SHAD__UNLOCK(sync);
+    }
+    return 0;
+}
+
+ShadBool shad_pack_loader_start(ShadPackLoader *loader, ShadPack *pack) {
+    ShadPackLoaderSync *sync;
+    memset(loader, 0, sizeof(*loader));
+    loader->pack = pack;
+    sync = (ShadPackLoaderSync*)calloc(1, sizeof(*sync));
+    loader->sync = sync;
+    #ifdef _WIN32
+    InitializeCriticalSection(&sync->mutex);
+    InitializeConditionVariable(&sync->has_requests);
+    InitializeConditionVariable(&sync->has_results);
+    sync->thread = CreateThread(NULL, 0, shad__loader_thread, loader, 0, NULL);
+    if (!sync->thread) {
+        DeleteCriticalSection(&sync->mutex);
+        free(sync);
+        loader->sync = NULL;
+        return 0;
+    }
+    #else
+    pthread_mutex_init(&sync->mutex, NULL);
+    pthread_cond_init(&sync->has_requests, NULL);
+    pthread_cond_init(&sync->has_results, NULL);
+    if (pthread_create(&sync->thread, NULL, shad__loader_thread, loader)) {
+        pthread_mutex_destroy(&sync->mutex);
+        pthread_cond_destroy(&sync->has_requests);
+        pthread_cond_destroy(&sync->has_results);
+        free(sync);
+        loader->sync = NULL;
+        return 0;
+    }
+    #endif
+    return 1;
+}
+
+ShadBool shad_pack_loader_request(ShadPackLoader *loader, const char *name, int priority, void *userdata) {
+    ShadPackLoaderSync *sync = (ShadPackLoaderSync*)loader->sync;
+    ShadPackLoaderRequest r;
+
+    r.index = shad_pack_find(loader->pack, name);
+    if (r.index < 0) return 0;
+    r.priority = priority;
+    r.userdata = userdata;
+
+    SHAD__LOCK(sync);
+    r.seq = loader->seq++;
+    shad__loader_heap_push(loader, r);
+    SHAD__SIGNAL(sync, has_requests);
+    SHAD__UNLOCK(sync);
+
+    ++loader->num_outstanding;
+    return 1;
+}
+
+ShadBool shad_pack_loader_poll(ShadPackLoader *loader, ShadPackLoadResult *result) {
+    ShadPackLoaderNode *node;
+
+    /* refill our queue from the completion stack, reversing it into completion order */
+    if (!loader->delivered) {
+        ShadPackLoaderNode *stack = shad__loader_take_completed(loader);
+        while (stack) {
+            ShadPackLoaderNode *next = stack->next;
+            stack->next = (ShadPackLoaderNode*)loader->delivered;
+            loader->delivered = stack;
+            stack = next;
+        }
+    }
+
+    node = (ShadPackLoaderNode*)loader->delivered;
+    if (!node) return 0;
+    loader->delivered = node->next;
+    *result = node->result;
+    free(node);
+    --loader->num_outstanding;
+    return 1;
+}
+
+ShadBool shad_pack_loader_wait(ShadPackLoader *loader, ShadPackLoadResult *result) {
+    ShadPackLoaderSync *sync = (ShadPackLoaderSync*)loader->sync;
+    while (loader->num_outstanding) {
+        if (shad_pack_loader_poll(loader, result)) return 1;
+        SHAD__LOCK(sync);
+        #ifdef _WIN32
+        while (!loader->completed)
+        #else
+        while (!__atomic_load_n(&loader->completed, __ATOMIC_ACQUIRE))
+        #endif
+            SHAD__WAIT(sync, has_results);
+        SHAD__UNLOCK(sync);
+    }
+    return 0;
+}
+
+void shad_pack_loader_stop(ShadPackLoader *loader) {
+    ShadPackLoaderSync *sync = (ShadPackLoaderSync*)loader->sync;
+    ShadPackLoadResult result;
+
+    if (!sync) return;
+
+    SHAD__LOCK(sync);
+    loader->quit = 1;
+    SHAD__SIGNAL(sync, has_requests);
+    SHAD__UNLOCK(sync);
+
+    #ifdef _WIN32
+    WaitForSingleObject(sync->thread, INFINITE);
+    CloseHandle(sync->thread);
+    DeleteCriticalSection(&sync->mutex);
+    #else
+    pthread_join(sync->thread, NULL);
+    pthread_mutex_destroy(&sync->mutex);
+    pthread_cond_destroy(&sync->has_requests);
+    pthread_cond_destroy(&sync->has_results);
+    #endif
+
+    /* free results nobody picked up */
+    while (shad_pack_loader_poll(loader, &result))
+        shad_compilation_free(&result.compilation);
+
+    free(loader->requests);
+    free(sync);
+    memset(loader, 0, sizeof(*loader));
+}
+
+#undef SHAD__LOCK
+#undef SHAD__UNLOCK
+#undef SHAD__WAIT
+#undef SHAD__SIGNAL
+#undef SHAD__BROADCAST
+
+#endif /* SHAD_NO_THREADS */
+
+/* SPIRV modules by content, for writers that store each unique module once.
+   Only hashes are kept, not the bytes, so a writer's memory doesn't grow with what it has written. A module
+   is the same as an earlier one if its size and two unrelated 64-bit hashes (128 bits together) all match */
+typedef struct ShadModuleTableEntry {
+    uint64_t hash;
+    uint64_t check;
+    int size;
+    /* filled in by the writer when the module is added */
+    const char *name;
+    int offset;
+} ShadModuleTableEntry;
+
+typedef struct ShadModuleTable {
+    ShadArena arena;
+    ShadModuleTableEntry *entries;
+    int num_entries;
+    int *slots;
+    int slots_cap;
+} ShadModuleTable;
+
+/* returns the entry with the same bytes, or adds one. found_out tells which */
+ShadModuleTableEntry* shad__module_table_get(ShadModuleTable *t, const char *data, int size, ShadBool *found_out) {
+    uint64_t hash = shad__hash64(data, size, 0);
+    uint64_t check = 0xcbf29ce484222325ull;
+    ShadModuleTableEntry *e;
+    int i, slot;
+
+    /* FNV-1a, nothing in common with shad__hash64() */
+    for (i = 0; i < size; ++i)
+        check = (check ^ (unsigned char)data[i]) * 0x100000001b3ull;
+
+    /* grow the lookup table so it stays at most half full */
+    if ((t->num_entries+1)*2 > t->slots_cap) {
+        int cap = t->slots_cap ? t->slots_cap*2 : 64;
+        int *slots = (int*)calloc(cap, sizeof(int));
+        for (i = 0; i < t->num_entries; ++i) {
+            for (slot = (int)(t->entries[i].hash & (cap-1)); slots[slot]; slot = (slot+1) & (cap-1));
+            slots[slot] = i+1;
+        }
+        free(t->slots);
+        t->slots = slots;
+        t->slots_cap = cap;
+        t->entries = (ShadModuleTableEntry*)realloc(t->entries, cap/2 * sizeof(*t->entries));
+    }
+
+    for (slot = (int)(hash & (t->slots_cap-1)); t->slots[slot]; slot = (slot+1) & (t->slots_cap-1)) {
+        e = &t->entries[t->slots[slot]-1];
+        if (e->hash == hash && e->check == check && e->size == size) {
+            *found_out = 1;
+            return e;
+        }
+    }
+
+    e = &t->entries[t->num_entries];
+    memset(e, 0, sizeof(*e));
+    e->hash = hash;
+    e->check = check;
+    e->size = size;
+    t->slots[slot] = ++t->num_entries;
+    *found_out = 0;
+    return e;
+}
+
+void shad__module_table_free(ShadModuleTable *t) {
+    if (!t) return;
+    shad__arena_destroy(&t->arena);
+    free(t->entries);
+    free(t->slots);
+    free(t);
+}
+
+/******
+
+    ELF objects
+
+    A relocatable ELF64 object with nothing but data, so it links without any relocations:
+
+    header, 64 bytes
+    .rodata: the SPIRV modules, little-endian and 4-byte aligned, written as they're added
+    .symtab: a null symbol, a section symbol for .rodata, then one global object symbol per module.
+             Identical modules are only stored once, their symbols point at the same bytes
+    .strtab, .shstrtab: symbol and section names
+    .note.GNU-stack: empty, so linkers don't make the stack executable
+    section headers, SHAD__ELF_NUM_SECTIONS of them
+
+******/
+
+#define SHAD__ELF_HEADER_SIZE 64
+#define SHAD__ELF_SECTION_SIZE 64
+#define SHAD__ELF_SYMBOL_SIZE 24
+#define SHAD__ELF_NUM_SECTIONS 6
+
+void shad__elf_write(ShadElfWriter *w, const void *data, int size, int align) {
+    static const char zero[8] = {0};
+    int pad = -w->size & (align-1);
+    if (pad && fwrite(zero, 1, pad, (FILE*)w->file) != (size_t)pad) w->failed = 1;
+    if (size && fwrite(data, 1, size, (FILE*)w->file) != (size_t)size) w->failed = 1;
+    w->size += pad + size;
+}
+
+void shad__elf_add_symbol(ShadElfWriter *w, const char *prefix, const char *name, const char *spirv, int size) {
+    ShadWriter names = {(ShadArena*)w->arena, w->names, w->names_len, w->names_cap};
+    ShadWriter symbols = {(ShadArena*)w->arena, w->symbols, w->symbols_len, w->symbols_cap};
+    char sym[SHAD__ELF_SYMBOL_SIZE] = {0};
+    ShadModuleTableEntry *module;
+    ShadBool found;
+    char *le;
+    ShadArena tmp;
+
+    memset(&tmp, 0, sizeof(tmp));
+    le = (char*)shad__alloc(&tmp, size, 4);
+    shad__v2_put_spirv(le, spirv, size);
+    module = shad__module_table_get((ShadModuleTable*)w->modules, le, size, &found);
+    if (found) {
+        w->bytes_deduplicated += size;
+    } else {
+        shad__elf_write(w, NULL, 0, 4);
+        module->offset = w->size - SHAD__ELF_HEADER_SIZE;
+        shad__elf_write(w, le, size, 4);
+    }
+    shad__arena_destroy(&tmp);
+
+    shad__put_u32(sym + 0, (unsigned)names.len);
+    sym[4] = 0x11; /* STB_GLOBAL, STT_OBJECT */
+    shad__put_u16(sym + 6, 1);
+    shad__put_u64(sym + 8, (uint64_t)module->offset);
+    shad__put_u64(sym + 16, (uint64_t)size);
+    shad__writer_push(&symbols, sym, sizeof(sym));
+    shad__writer_print(&names, "%s%s", prefix, name);
+    shad__writer_push(&names, (char*)"", 1);
+
+    w->names = names.buf;
+    w->names_len = names.len;
+    w->names_cap = names.cap;
+    w->symbols = symbols.buf;
+    w->symbols_len = symbols.len;
+    w->symbols_cap = symbols.cap;
+    ++w->num_symbols;
+}
+
+ShadBool shad_elf_writer_begin(ShadElfWriter *w, const char *path) {
+    char header[SHAD__ELF_HEADER_SIZE] = {0};
+    char sym[SHAD__ELF_SYMBOL_SIZE*2] = {0};
+    ShadWriter symbols, names;
+
+    memset(w, 0, sizeof(*w));
+    w->file = fopen(path, "wb");
+    if (!w->file) return 0;
+    w->arena = memset(malloc(sizeof(ShadArena)), 0, sizeof(ShadArena));
+    w->modules = memset(malloc(sizeof(ShadModuleTable)), 0, sizeof(ShadModuleTable));
+
+    /* null symbol, and the section symbol */
+    sym[SHAD__ELF_SYMBOL_SIZE + 4] = 3; /* STB_LOCAL, STT_SECTION */
+    shad__put_u16(sym + SHAD__ELF_SYMBOL_SIZE + 6, 1);
+    symbols.arena = names.arena = (ShadArena*)w->arena;
+    symbols.buf = names.buf = NULL;
+    symbols.len = names.len = symbols.cap = names.cap = 0;
+    shad__writer_push(&symbols, sym, sizeof(sym));
+    shad__writer_push(&names, (char*)"", 1);
+    w->symbols = symbols.buf;
+    w->symbols_len = symbols.len;
+    w->symbols_cap = symbols.cap;
+    w->names = names.buf;
+    w->names_len = names.len;
+    w->names_cap = names.cap;
+
+    /* the header is filled in by shad_elf_writer_end() */
+    shad__elf_write(w, header, sizeof(header), 1);
+    return !w->failed;
+}
+
+ShadBool shad_elf_writer_add(ShadElfWriter *w, const char *name, ShadCompilation *compiled) {
+    if (w->failed) return 0;
+    shad__elf_add_symbol(w, "shad__spirv_vertex_code_", name, compiled->spirv_vertex_code, compiled->spirv_vertex_code_size);
+    if (compiled->has_fragment_shader)
+        shad__elf_add_symbol(w, "shad__spirv_fragment_code_", name, compiled->spirv_fragment_code, compiled->spirv_fragment_code_size);
+    return !w->failed;
+}
+
+ShadBool shad_elf_writer_end(ShadElfWriter *w) {
+    /* section names, at offsets 1, 9, 17, 25 and 35 */
+    static const char shstrtab[] = "\0.rodata\0.symtab\0.strtab\0.shstrtab\0.note.GNU-stack";
+    char header[SHAD__ELF_HEADER_SIZE] = {0};
+    char sections[SHAD__ELF_NUM_SECTIONS][SHAD__ELF_SECTION_SIZE];
+    int rodata_size, symtab_offset, strtab_offset, shstrtab_offset, sections_offset;
+    unsigned machine = 62, flags = 0;
+    ShadBool ok;
+    int i;
+
+    if (!w->file) return 0;
+
+    rodata_size = w->size - SHAD__ELF_HEADER_SIZE;
+    shad__elf_write(w, w->symbols, w->symbols_len, 8);
+    symtab_offset = w->size - w->symbols_len;
+    strtab_offset = w->size;
+    shad__elf_write(w, w->names, w->names_len, 1);
+    shad__elf_write(w, shstrtab, sizeof(shstrtab), 1);
+    shstrtab_offset = w->size - (int)sizeof(shstrtab);
+
+    /* section headers: name, type, flags, addr, offset, size, link, info, addralign, entsize */
+    memset(sections, 0, sizeof(sections));
+    #define SHAD__ELF_SECTION(i, name, type, flags, offset, size, link, info, align, entsize) \
+        shad__put_u32(sections[i] + 0, name), \
+        shad__put_u32(sections[i] + 4, type), \
+        shad__put_u64(sections[i] + 8, flags), \
+        shad__put_u64(sections[i] + 24, (uint64_t)(offset)), \
+        shad__put_u64(sections[i] + 32, (uint64_t)(size)), \
+        shad__put_u32(sections[i] + 40, link), \
+        shad__put_u32(sections[i] + 44, info), \
+        shad__put_u64(sections[i] + 48, align), \
+        shad__put_u64(sections[i] + 56, entsize)
+    SHAD__ELF_SECTION(1, 1, 1 /* SHT_PROGBITS */, 2 /* SHF_ALLOC */, SHAD__ELF_HEADER_SIZE, rodata_size, 0, 0, 4, 0);
+    SHAD__ELF_SECTION(2, 9, 2 /* SHT_SYMTAB */, 0, symtab_offset, w->symbols_len, 3, 2 /* first global symbol */, 8, SHAD__ELF_SYMBOL_SIZE);
+    SHAD__ELF_SECTION(3, 17, 3 /* SHT_STRTAB */, 0, strtab_offset, w->names_len, 0, 0, 1, 0);
+    SHAD__ELF_SECTION(4, 25, 3 /* SHT_STRTAB */, 0, shstrtab_offset, sizeof(shstrtab), 0, 0, 1, 0);
+    SHAD__ELF_SECTION(5, 35, 1 /* SHT_PROGBITS */, 0, shstrtab_offset, 0, 0, 0, 1, 0);
+    #undef SHAD__ELF_SECTION
+    for (i = 0; i < SHAD__ELF_NUM_SECTIONS; ++i)
+        shad__elf_write(w, sections[i], SHAD__ELF_SECTION_SIZE, i ? 1 : 8);
+    sections_offset = w->size - SHAD__ELF_NUM_SECTIONS*SHAD__ELF_SECTION_SIZE;
+
+    switch (w->machine) {
+        case SHAD_ELF_MACHINE_X86_64: machine = 62; break;
+        case SHAD_ELF_MACHINE_AARCH64: machine = 183; break;
+        /* RVC, double-float ABI, which is what 64-bit riscv linux uses */
+        case SHAD_ELF_MACHINE_RISCV64: machine = 243, flags = 5; break;
+        default:
+            #if defined(__aarch64__) || defined(_M_ARM64)
+            machine = 183;
+            #elif defined(__riscv) && __riscv_xlen == 64
+            machine = 243, flags = 5;
+            #endif
+            break;
+    }
+
+    /* ELFCLASS64, ELFDATA2LSB, EV_CURRENT, ET_REL */
+    memcpy(header, "\x7f" "ELF\x02\x01\x01", 7);
+    shad__put_u16(header + 16, 1);
+    shad__put_u16(header + 18, machine);
+    shad__put_u32(header + 20, 1);
+    shad__put_u64(header + 40, (uint64_t)sections_offset);
+    shad__put_u32(header + 48, flags);
+    shad__put_u16(header + 52, SHAD__ELF_HEADER_SIZE);
+    shad__put_u16(header + 58, SHAD__ELF_SECTION_SIZE);
+    shad__put_u16(header + 60, SHAD__ELF_NUM_SECTIONS);
+    shad__put_u16(header + 62, 4);
+    if (fseek((FILE*)w->file, 0, SEEK_SET) || fwrite(header, 1, sizeof(header), (FILE*)w->file) != sizeof(header))
+        w->failed = 1;
+
+    ok = !fclose((FILE*)w->file) && !w->failed;
+    shad__arena_destroy((ShadArena*)w->arena);
+    free(w->arena);
+    shad__module_table_free((ShadModuleTable*)w->modules);
+    w->file = NULL;
+    w->arena = NULL;
+    w->modules = NULL;
+    return ok;
+}
+
+/* SDL API */
+
+#ifdef SDL_VERSION
+
+static const SDL_GPUCullMode shad_to_sdl_cull_mode[] = {
+    SDL_GPU_CULLMODE_NONE, /* SDL_GPU_CULLMODE_INVALID */
+    SDL_GPU_CULLMODE_NONE, /* SDL_GPU_CULLMODE_NONE */
+    SDL_GPU_CULLMODE_FRONT, /* SDL_GPU_CULLMODE_FRONT */
+    SDL_GPU_CULLMODE_BACK, /* SDL_GPU_CULLMODE_BACK */
+};
+
+static const SDL_GPUVertexElementFormat shad_to_sdl_vertex_element_format[] = {
+    SDL_GPU_VERTEXELEMENTFORMAT_INVALID, /* SHAD_VERTEXELEMENTFORMAT_INVALID */
+    SDL_GPU_VERTEXELEMENTFORMAT_INT, /* SHAD_VERTEXELEMENTFORMAT_INT */
+    SDL_GPU_VERTEXELEMENTFORMAT_INT2, /* SHAD_VERTEXELEMENTFORMAT_INT2 */
+    SDL_GPU_VERTEXELEMENTFORMAT_INT3, /* SHAD_VERTEXELEMENTFORMAT_INT3 */
+    SDL_GPU_VERTEXELEMENTFORMAT_INT4, /* SHAD_VERTEXELEMENTFORMAT_INT4 */
+    SDL_GPU_VERTEXELEMENTFORMAT_UINT, /* SHAD_VERTEXELEMENTFORMAT_UINT */
+    SDL_GPU_VERTEXELEMENTFORMAT_UINT2, /* SHAD_VERTEXELEMENTFORMAT_UINT2 */
+    SDL_GPU_VERTEXELEMENTFORMAT_UINT3, /* SHAD_VERTEXELEMENTFORMAT_UINT3 */
+    SDL_GPU_VERTEXELEMENTFORMAT_UINT4, /* SHAD_VERTEXELEMENTFORMAT_UINT4 */
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT, /* SHAD_VERTEXELEMENTFORMAT_FLOAT */
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT2, /* SHAD_VERTEXELEMENTFORMAT_FLOAT2 */
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3, /* SHAD_VERTEXELEMENTFORMAT_FLOAT3 */
+    SDL_GPU_VERTEXELEMENTFORMAT_FLOAT4, /* SHAD_VERTEXELEMENTFORMAT_FLOAT4 */
+    SDL_GPU_VERTEXELEMENTFORMAT_BYTE2, /* SHAD_VERTEXELEMENTFORMAT_BYTE2 */
     SDL_GPU_VERTEXELEMENTFORMAT_BYTE4, /* SHAD_VERTEXELEMENTFORMAT_BYTE4 */
     SDL_GPU_VERTEXELEMENTFORMAT_UBYTE2, /* SHAD_VERTEXELEMENTFORMAT_UBYTE2 */
     SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4, /* SHAD_VERTEXELEMENTFORMAT_UBYTE4 */
@@ -1532,6 +3570,22 @@ static const SDL_GPUPrimitiveType shad_to_sdl_primitive[] = {
     SDL_GPU_PRIMITIVETYPE_POINTLIST,      /* SHAD_PRIMITIVE_POINT_LIST */
 };
 
+/* the SDLP section is written without the SDL headers, so make sure the values it assumes are right */
+typedef char shad__sdlp_abi_check[(
+    SDL_GPU_VERTEXELEMENTFORMAT_INT == (int)SHAD_VERTEXELEMENTFORMAT_INT &&
+    SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM == (int)SHAD_VERTEXELEMENTFORMAT_USHORT4_NORM &&
+    SDL_GPU_BLENDFACTOR_ZERO == (int)SHAD_BLEND_FACTOR_ZERO &&
+    SDL_GPU_BLENDFACTOR_SRC_ALPHA_SATURATE == (int)SHAD_BLEND_FACTOR_SRC_ALPHA_SATURATE &&
+    SDL_GPU_BLENDOP_ADD == (int)SHAD_BLEND_OP_ADD &&
+    SDL_GPU_BLENDOP_MAX == (int)SHAD_BLEND_OP_MAX &&
+    SDL_GPU_VERTEXINPUTRATE_INSTANCE == 1 &&
+    SDL_GPU_TEXTUREFORMAT_R8_UNORM == 2 &&
+    SDL_GPU_TEXTUREFORMAT_R16G16B16A16_UNORM == 7 &&
+    SDL_GPU_TEXTUREFORMAT_R16_FLOAT == 27 &&
+    SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT == 33 &&
+    SDL_GPU_TEXTUREFORMAT_D16_UNORM == 58 &&
+    SDL_GPU_TEXTUREFORMAT_D32_FLOAT_S8_UINT == 62) ? 1 : -1];
+
 void shad_sdl_fill_vertex_shader(SDL_GPUShaderCreateInfo *info, ShadCompilation *compiled) {
     memset(info, 0, sizeof(*info));
     info->code = (Uint8*)compiled->spirv_vertex_code;
@@ -1561,37 +3615,54 @@ void shad_sdl_fill_fragment_shader(SDL_GPUShaderCreateInfo *info, ShadCompilatio
     /* TODO: set name property */
 }
 
-void shad_sdl_fill_pipeline(SDL_GPUGraphicsPipelineCreateInfo *info, ShadCompilation *compiled) {
-    ShadArena *arena = shad__compilation_arena_get(compiled);
+/* fills the pipeline info, pointing it at arrays provided by the caller. They must fit the compilation's vertex inputs/buffers and fragment outputs */
+void shad__sdl_fill_pipeline(SDL_GPUGraphicsPipelineCreateInfo *info, const ShadCompilation *compiled, SDL_GPUVertexBufferDescription *vertex_buffer_descriptions, SDL_GPUVertexAttribute *vertex_attributes, SDL_GPUColorTargetDescription *color_target_descriptions) {
+    const char *sdlp = compiled->sdl_pipeline;
     int i;
 
     memset(info, 0, sizeof(*info));
 
+    /* pretranslated arrays from the SDLP section, if the counts still match */
+    if (sdlp &&
+        sizeof(SDL_GPUVertexBufferDescription) == 16 && sizeof(SDL_GPUVertexAttribute) == 16 && sizeof(SDL_GPUColorTargetDescription) == 32 &&
+        ((const Uint32*)sdlp)[0] == (Uint32)compiled->num_vertex_input_buffers &&
+        ((const Uint32*)sdlp)[1] == (Uint32)compiled->num_vertex_inputs &&
+        ((const Uint32*)sdlp)[2] == (Uint32)compiled->num_fragment_outputs) {
+        sdlp += 16;
+        if (compiled->num_vertex_input_buffers) memcpy(vertex_buffer_descriptions, sdlp, compiled->num_vertex_input_buffers * 16);
+        sdlp += compiled->num_vertex_input_buffers * 16;
+        if (compiled->num_vertex_inputs) memcpy(vertex_attributes, sdlp, compiled->num_vertex_inputs * 16);
+        sdlp += compiled->num_vertex_inputs * 16;
+        if (compiled->num_fragment_outputs) memcpy(color_target_descriptions, sdlp, compiled->num_fragment_outputs * 32);
+    } else {
+        sdlp = NULL;
+    }
+
     /* set vertex_input_state */
     /* buffer descriptions */
     info->vertex_input_state.num_vertex_buffers = compiled->num_vertex_input_buffers;
-    SDL_GPUVertexBufferDescription *vertex_buffer_descriptions = SHAD_ALLOC(SDL_GPUVertexBufferDescription, arena, info->vertex_input_state.num_vertex_buffers);
-    for (i = 0; i < compiled->num_vertex_input_buffers; ++i) {
+    for (i = 0; !sdlp && i < compiled->num_vertex_input_buffers; ++i) {
         SDL_GPUVertexBufferDescription *desc = &vertex_buffer_descriptions[i];
         ShadVertexInputBuffer *buf = compiled->vertex_input_buffers + i;
+        memset(desc, 0, sizeof(*desc));
         desc->slot = buf->slot;
         desc->pitch = buf->stride;
         desc->input_rate = buf->instanced ? SDL_GPU_VERTEXINPUTRATE_INSTANCE : SDL_GPU_VERTEXINPUTRATE_VERTEX;
     }
-    info->vertex_input_state.vertex_buffer_descriptions = vertex_buffer_descriptions;
+    info->vertex_input_state.vertex_buffer_descriptions = compiled->num_vertex_input_buffers ? vertex_buffer_descriptions : NULL;
 
     /* attributes */
     info->vertex_input_state.num_vertex_attributes = compiled->num_vertex_inputs;
-    SDL_GPUVertexAttribute *vertex_attributes = SHAD_ALLOC(SDL_GPUVertexAttribute, arena, info->vertex_input_state.num_vertex_attributes);
-    for (i = 0; i < compiled->num_vertex_inputs; ++i) {
+    for (i = 0; !sdlp && i < compiled->num_vertex_inputs; ++i) {
         ShadVertexInput *in = compiled->vertex_inputs + i;
         SDL_GPUVertexAttribute *desc = &vertex_attributes[i];
+        memset(desc, 0, sizeof(*desc));
         desc->location = i;
         desc->buffer_slot = in->buffer_slot;
         desc->offset = in->offset;
         desc->format = shad_to_sdl_vertex_element_format[in->format];
     }
-    info->vertex_input_state.vertex_attributes = vertex_attributes;
+    info->vertex_input_state.vertex_attributes = compiled->num_vertex_inputs ? vertex_attributes : NULL;
 
     /* rasterization */
     info->rasterizer_state.cull_mode = shad_to_sdl_cull_mode[compiled->cull_mode];
@@ -1608,10 +3679,10 @@ void shad_sdl_fill_pipeline(SDL_GPUGraphicsPipelineCreateInfo *info, ShadCompila
     /* targets */
     info->target_info.num_color_targets = compiled->num_fragment_outputs;
     if (info->target_info.num_color_targets) {
-        SDL_GPUColorTargetDescription *color_target_descriptions = SHAD_ALLOC(SDL_GPUColorTargetDescription, arena, info->target_info.num_color_targets);
-        for (i = 0; i < (int)info->target_info.num_color_targets; ++i) {
+        for (i = 0; !sdlp && i < (int)info->target_info.num_color_targets; ++i) {
             SDL_GPUColorTargetDescription *desc = &color_target_descriptions[i];
             ShadFragmentOutput *out = compiled->fragment_outputs + i;
+            memset(desc, 0, sizeof(*desc));
             desc->format = shad_to_sdl_texture_format[out->format];
 
             SDL_GPUColorTargetBlendState *blend = &desc->blend_state;
@@ -1632,8 +3703,289 @@ void shad_sdl_fill_pipeline(SDL_GPUGraphicsPipelineCreateInfo *info, ShadCompila
     info->primitive_type = shad_to_sdl_primitive[compiled->primitive];
 }
 
+void shad_sdl_fill_pipeline(SDL_GPUGraphicsPipelineCreateInfo *info, ShadCompilation *compiled) {
+    ShadArena *arena = shad__compilation_arena_get(compiled);
+    shad__sdl_fill_pipeline(info, compiled,
+        SHAD_ALLOC(SDL_GPUVertexBufferDescription, arena, compiled->num_vertex_input_buffers),
+        SHAD_ALLOC(SDL_GPUVertexAttribute, arena, compiled->num_vertex_inputs),
+        SHAD_ALLOC(SDL_GPUColorTargetDescription, arena, compiled->num_fragment_outputs));
+}
+
+ShadBool shad_sdl_fill_pipeline_storage(SDL_GPUGraphicsPipelineCreateInfo *info, ShadSdlPipelineStorage *storage, const ShadCompilation *compiled) {
+    if (compiled->num_vertex_input_buffers > SHAD_SDL_MAX_VERTEX_BUFFERS ||
+        compiled->num_vertex_inputs > SHAD_SDL_MAX_VERTEX_ATTRIBUTES ||
+        compiled->num_fragment_outputs > SHAD_SDL_MAX_COLOR_TARGETS) {
+        memset(info, 0, sizeof(*info));
+        return 0;
+    }
+    shad__sdl_fill_pipeline(info, compiled, storage->vertex_buffer_descriptions, storage->vertex_attributes, storage->color_target_descriptions);
+    return 1;
+}
+
+/******
+
+    Registry
+
+    Shaders and pipelines are interned by a content key derived from shad_compilation_hash().
+    Entries are never removed, a released entry just drops its object and is recreated if the same content comes back.
+    key_slots maps key -> entry, object_slots maps pipeline pointer -> entry (with tombstones, since pipelines come and go).
+    Both are open addressing tables of entry index + 1.
+
+*/
+
+typedef struct ShadSdlRegistryEntry {
+    uint64_t key;
+    /* SDL_GPUShader or SDL_GPUGraphicsPipeline, NULL while released */
+    void *object;
+    /* shaders: number of live pipelines using them */
+    int refs;
+    /* pipelines: entry index of their shaders, fragment_shader is -1 if there is none */
+    int vertex_shader;
+    int fragment_shader;
+} ShadSdlRegistryEntry;
+
+#define SHAD__REGISTRY_TOMBSTONE (-1)
+
+uint64_t shad__registry_object_key(void *object) {
+    uintptr_t p = (uintptr_t)object;
+    return shad__hash64((const char*)&p, (int)sizeof(p), 0);
+}
+
+int shad__registry_find_key(ShadSdlRegistry *reg, uint64_t key) {
+    ShadSdlRegistryEntry *entries = (ShadSdlRegistryEntry*)reg->entries;
+    int mask = reg->slots_cap - 1;
+    int slot;
+    if (!reg->slots_cap) return -1;
+    for (slot = (int)(key & mask); reg->key_slots[slot]; slot = (slot + 1) & mask)
+        if (entries[reg->key_slots[slot] - 1].key == key)
+            return reg->key_slots[slot] - 1;
+    return -1;
+}
+
+/* returns the slot in object_slots */
+int shad__registry_find_object(ShadSdlRegistry *reg, void *object) {
+    ShadSdlRegistryEntry *entries = (ShadSdlRegistryEntry*)reg->entries;
+    int mask = reg->slots_cap - 1;
+    int slot;
+    if (!reg->slots_cap || !object) return -1;
+    for (slot = (int)(shad__registry_object_key(object) & mask); reg->object_slots[slot]; slot = (slot + 1) & mask)
+        if (reg->object_slots[slot] != SHAD__REGISTRY_TOMBSTONE && entries[reg->object_slots[slot] - 1].object == object)
+            return slot;
+    return -1;
+}
+
+void shad__registry_insert_object(ShadSdlRegistry *reg, int entry) {
+    ShadSdlRegistryEntry *entries = (ShadSdlRegistryEntry*)reg->entries;
+    int mask = reg->slots_cap - 1;
+    int slot = (int)(shad__registry_object_key(entries[entry].object) & mask);
+    while (reg->object_slots[slot] > 0) slot = (slot + 1) & mask;
+    if (!reg->object_slots[slot]) ++reg->object_slots_used;
+    reg->object_slots[slot] = entry + 1;
+}
+
+/* rebuilds both tables, which also clears out the tombstones */
+ShadBool shad__registry_rehash(ShadSdlRegistry *reg, int cap) {
+    ShadSdlRegistryEntry *entries = (ShadSdlRegistryEntry*)reg->entries;
+    int *key_slots = (int*)calloc(cap, sizeof(int));
+    int *object_slots = (int*)calloc(cap, sizeof(int));
+    int i;
+    if (!key_slots || !object_slots) {
+        free(key_slots);
+        free(object_slots);
+        return 0;
+    }
+    free(reg->key_slots);
+    free(reg->object_slots);
+    reg->key_slots = key_slots;
+    reg->object_slots = object_slots;
+    reg->slots_cap = cap;
+    reg->object_slots_used = 0;
+    for (i = 0; i < reg->num_entries; ++i) {
+        int slot = (int)(entries[i].key & (cap - 1));
+        while (key_slots[slot]) slot = (slot + 1) & (cap - 1);
+        key_slots[slot] = i + 1;
+        if (entries[i].object && entries[i].vertex_shader >= 0)
+            shad__registry_insert_object(reg, i);
+    }
+    return 1;
+}
+
+/* makes room in the tables for a pipeline and its two shaders */
+ShadBool shad__registry_reserve(ShadSdlRegistry *reg) {
+    int cap = reg->slots_cap ? reg->slots_cap : 64;
+    if ((reg->num_entries + 3) * 2 <= reg->slots_cap && (reg->object_slots_used + 1) * 2 <= reg->slots_cap) return 1;
+    while ((reg->num_entries + 3) * 2 > cap) cap *= 2;
+    return shad__registry_rehash(reg, cap);
+}
+
+/* finds or adds the entry for key, returns its index or -1 if we're out of memory. Call shad__registry_reserve() first */
+int shad__registry_entry(ShadSdlRegistry *reg, uint64_t key) {
+    ShadSdlRegistryEntry *entries;
+    int i = shad__registry_find_key(reg, key);
+    if (i >= 0) return i;
+
+    if (reg->num_entries == reg->entries_cap) {
+        int cap = reg->entries_cap ? reg->entries_cap * 2 : 32;
+        void *p = realloc(reg->entries, cap * sizeof(ShadSdlRegistryEntry));
+        if (!p) return -1;
+        reg->entries = p;
+        reg->entries_cap = cap;
+    }
+
+    i = reg->num_entries++;
+    entries = (ShadSdlRegistryEntry*)reg->entries;
+    memset(&entries[i], 0, sizeof(entries[i]));
+    entries[i].key = key;
+    entries[i].vertex_shader = -1;
+    entries[i].fragment_shader = -1;
+    {
+        int mask = reg->slots_cap - 1;
+        int slot = (int)(key & mask);
+        while (reg->key_slots[slot]) slot = (slot + 1) & mask;
+        reg->key_slots[slot] = i + 1;
+    }
+    return i;
+}
+
+uint64_t shad__registry_key(uint64_t a, unsigned b, unsigned c, unsigned d, unsigned e, unsigned kind) {
+    char buf[28];
+    shad__put_u32(buf + 0, (unsigned)a);
+    shad__put_u32(buf + 4, (unsigned)(a >> 32));
+    shad__put_u32(buf + 8, b);
+    shad__put_u32(buf + 12, c);
+    shad__put_u32(buf + 16, d);
+    shad__put_u32(buf + 20, e);
+    shad__put_u32(buf + 24, kind);
+    return shad__hash64(buf, (int)sizeof(buf), 0);
+}
+
+void shad__registry_release_shader(ShadSdlRegistry *reg, int i) {
+    ShadSdlRegistryEntry *e;
+    if (i < 0) return;
+    e = (ShadSdlRegistryEntry*)reg->entries + i;
+    if (--e->refs > 0) return;
+    if (reg->release_shader) reg->release_shader(reg->userdata, (SDL_GPUShader*)e->object);
+    else SDL_ReleaseGPUShader(reg->device, (SDL_GPUShader*)e->object);
+    e->object = NULL;
+    --reg->num_shaders;
+}
+
+/* gets the shader for a stage, creating it if needed, and takes a reference */
+int shad__registry_shader(ShadSdlRegistry *reg, ShadCompilation *compiled, uint64_t spirv_hash, ShadBool fragment) {
+    SDL_GPUShaderCreateInfo info;
+    ShadSdlRegistryEntry *e;
+    uint64_t key;
+    int i;
+
+    if (fragment) key = shad__registry_key(spirv_hash, compiled->num_fragment_samplers, compiled->num_fragment_images, compiled->num_fragment_buffers, compiled->num_fragment_uniforms, 2);
+    else key = shad__registry_key(spirv_hash, compiled->num_vertex_samplers, compiled->num_vertex_images, compiled->num_vertex_buffers, compiled->num_vertex_uniforms, 1);
+
+    i = shad__registry_entry(reg, key);
+    if (i < 0) return -1;
+    e = (ShadSdlRegistryEntry*)reg->entries + i;
+    if (!e->object) {
+        if (fragment) shad_sdl_fill_fragment_shader(&info, compiled);
+        else shad_sdl_fill_vertex_shader(&info, compiled);
+        e->object = reg->create_shader ? reg->create_shader(reg->userdata, &info) : SDL_CreateGPUShader(reg->device, &info);
+        if (!e->object) return -1;
+        e->refs = 0;
+        ++reg->num_shaders;
+    } else {
+        ++reg->num_reused_shaders;
+    }
+    ++e->refs;
+    return i;
+}
+
+void shad_sdl_registry_init(ShadSdlRegistry *reg, SDL_GPUDevice *device) {
+    memset(reg, 0, sizeof(*reg));
+    reg->device = device;
+}
+
+SDL_GPUGraphicsPipeline* shad_sdl_registry_acquire(ShadSdlRegistry *reg, ShadCompilation *compiled) {
+    ShadCompilationHash hash;
+    ShadSdlPipelineStorage storage;
+    SDL_GPUGraphicsPipelineCreateInfo info;
+    ShadSdlRegistryEntry *e;
+    int i, vs, fs = -1;
+
+    shad_compilation_hash(compiled, &hash);
+    if (!shad__registry_reserve(reg)) return NULL;
+    i = shad__registry_entry(reg, shad__registry_key(hash.all, 0, 0, 0, 0, 3));
+    if (i < 0) return NULL;
+    e = (ShadSdlRegistryEntry*)reg->entries + i;
+    if (e->object) {
+        ++e->refs;
+        ++reg->num_reused_pipelines;
+        return (SDL_GPUGraphicsPipeline*)e->object;
+    }
+
+    /* new pipeline, get the shaders first. Note that these might grow the entries */
+    vs = shad__registry_shader(reg, compiled, hash.vertex_spirv, 0);
+    if (vs < 0) return NULL;
+    if (compiled->has_fragment_shader) {
+        fs = shad__registry_shader(reg, compiled, hash.fragment_spirv, 1);
+        if (fs < 0) {
+            shad__registry_release_shader(reg, vs);
+            return NULL;
+        }
+    }
+
+    if (!shad_sdl_fill_pipeline_storage(&info, &storage, compiled))
+        shad_sdl_fill_pipeline(&info, compiled);
+    info.vertex_shader = (SDL_GPUShader*)((ShadSdlRegistryEntry*)reg->entries)[vs].object;
+    info.fragment_shader = fs >= 0 ? (SDL_GPUShader*)((ShadSdlRegistryEntry*)reg->entries)[fs].object : NULL;
+
+    e = (ShadSdlRegistryEntry*)reg->entries + i;
+    e->object = reg->create_pipeline ? reg->create_pipeline(reg->userdata, &info) : SDL_CreateGPUGraphicsPipeline(reg->device, &info);
+    if (!e->object) {
+        shad__registry_release_shader(reg, vs);
+        shad__registry_release_shader(reg, fs);
+        return NULL;
+    }
+    e->refs = 1;
+    e->vertex_shader = vs;
+    e->fragment_shader = fs;
+    shad__registry_insert_object(reg, i);
+    ++reg->num_pipelines;
+    return (SDL_GPUGraphicsPipeline*)e->object;
+}
+
+void shad_sdl_registry_release(ShadSdlRegistry *reg, SDL_GPUGraphicsPipeline *pipeline) {
+    ShadSdlRegistryEntry *e;
+    int slot = shad__registry_find_object(reg, pipeline);
+    if (slot < 0) return;
+    e = (ShadSdlRegistryEntry*)reg->entries + reg->object_slots[slot] - 1;
+    if (--e->refs > 0) return;
+
+    if (reg->release_pipeline) reg->release_pipeline(reg->userdata, pipeline);
+    else SDL_ReleaseGPUGraphicsPipeline(reg->device, pipeline);
+    e->object = NULL;
+    reg->object_slots[slot] = SHAD__REGISTRY_TOMBSTONE;
+    --reg->num_pipelines;
+    shad__registry_release_shader(reg, e->vertex_shader);
+    shad__registry_release_shader(reg, e->fragment_shader);
+}
+
+void shad_sdl_registry_destroy(ShadSdlRegistry *reg) {
+    ShadSdlRegistryEntry *entries = (ShadSdlRegistryEntry*)reg->entries;
+    int i;
+
+    /* pipelines first, they hold references to the shaders */
+    for (i = 0; i < reg->num_entries; ++i) {
+        if (!entries[i].object || entries[i].vertex_shader < 0) continue;
+        entries[i].refs = 1;
+        shad_sdl_registry_release(reg, (SDL_GPUGraphicsPipeline*)entries[i].object);
+    }
+    free(reg->entries);
+    free(reg->key_slots);
+    free(reg->object_slots);
+    memset(reg, 0, sizeof(*reg));
+}
+
 #endif /* SDL_VERSION */
 
+#ifndef SHAD_NO_COMPILER
 
 static const char *shad_to_sdl_cull_mode_string[] = {
     "SDL_GPU_CULLMODE_NONE", /* SDL_GPU_CULLMODE_INVALID */
@@ -1674,6 +4026,39 @@ static const char *shad_to_sdl_vertex_element_format_string[] = {
     "SDL_GPU_VERTEXELEMENTFORMAT_USHORT4_NORM", /* SHAD_VERTEXELEMENTFORMAT_USHORT4_NORM */
 };
 
+/* the C type of each vertex element format, for the generated vertex structs */
+static const struct {const char *type; int count;} shad_vertex_element_format_c_type[] = {
+    {NULL, 0},        /* SHAD_VERTEXELEMENTFORMAT_INVALID */
+    {"Sint32", 1},    /* SHAD_VERTEXELEMENTFORMAT_INT */
+    {"Sint32", 2},    /* SHAD_VERTEXELEMENTFORMAT_INT2 */
+    {"Sint32", 3},    /* SHAD_VERTEXELEMENTFORMAT_INT3 */
+    {"Sint32", 4},    /* SHAD_VERTEXELEMENTFORMAT_INT4 */
+    {"Uint32", 1},    /* SHAD_VERTEXELEMENTFORMAT_UINT */
+    {"Uint32", 2},    /* SHAD_VERTEXELEMENTFORMAT_UINT2 */
+    {"Uint32", 3},    /* SHAD_VERTEXELEMENTFORMAT_UINT3 */
+    {"Uint32", 4},    /* SHAD_VERTEXELEMENTFORMAT_UINT4 */
+    {"float", 1},     /* SHAD_VERTEXELEMENTFORMAT_FLOAT */
+    {"float", 2},     /* SHAD_VERTEXELEMENTFORMAT_FLOAT2 */
+    {"float", 3},     /* SHAD_VERTEXELEMENTFORMAT_FLOAT3 */
+    {"float", 4},     /* SHAD_VERTEXELEMENTFORMAT_FLOAT4 */
+    {"Sint8", 2},     /* SHAD_VERTEXELEMENTFORMAT_BYTE2 */
+    {"Sint8", 4},     /* SHAD_VERTEXELEMENTFORMAT_BYTE4 */
+    {"Uint8", 2},     /* SHAD_VERTEXELEMENTFORMAT_UBYTE2 */
+    {"Uint8", 4},     /* SHAD_VERTEXELEMENTFORMAT_UBYTE4 */
+    {"Sint8", 2},     /* SHAD_VERTEXELEMENTFORMAT_BYTE2_NORM */
+    {"Sint8", 4},     /* SHAD_VERTEXELEMENTFORMAT_BYTE4_NORM */
+    {"Uint8", 2},     /* SHAD_VERTEXELEMENTFORMAT_UBYTE2_NORM */
+    {"Uint8", 4},     /* SHAD_VERTEXELEMENTFORMAT_UBYTE4_NORM */
+    {"Sint16", 2},    /* SHAD_VERTEXELEMENTFORMAT_SHORT2 */
+    {"Sint16", 4},    /* SHAD_VERTEXELEMENTFORMAT_SHORT4 */
+    {"Uint16", 2},    /* SHAD_VERTEXELEMENTFORMAT_USHORT2 */
+    {"Uint16", 4},    /* SHAD_VERTEXELEMENTFORMAT_USHORT4 */
+    {"Sint16", 2},    /* SHAD_VERTEXELEMENTFORMAT_SHORT2_NORM */
+    {"Sint16", 4},    /* SHAD_VERTEXELEMENTFORMAT_SHORT4_NORM */
+    {"Uint16", 2},    /* SHAD_VERTEXELEMENTFORMAT_USHORT2_NORM */
+    {"Uint16", 4},    /* SHAD_VERTEXELEMENTFORMAT_USHORT4_NORM */
+};
+
 static const char *shad_to_sdl_compare_op_string[] = {
     "SDL_GPU_COMPAREOP_INVALID", /* SHAD_COMPARE_OP_INVALID */
     "SDL_GPU_COMPAREOP_NEVER", /* SHAD_COMPARE_OP_NEVER */
@@ -1755,63 +4140,170 @@ static const char *shad_to_sdl_primitive_string[] = {
     "SDL_GPU_PRIMITIVETYPE_POINTLIST",      /* SHAD_PRIMITIVE_POINT_LIST */
 };
 
+/* 0x0123456789abcdefull */
+char* shad__hex64(char *buf, uint64_t v) {
+    int i;
+    buf[0] = '0';
+    buf[1] = 'x';
+    for (i = 0; i < 16; ++i)
+        buf[2+i] = "0123456789abcdef"[(v >> (60 - 4*i)) & 15];
+    memcpy(buf + 18, "ull", 4);
+    return buf;
+}
+
+/* the array holding a stage's SPIRV, shad__spirv_<stage>_code_<name>. linkage is "static const" or "const" */
+/* SDL hands the SPIRV to the driver as 4-byte words, so byte arrays need to be aligned like them */
+static const char shad__spirv_align_macro[] =
+    "#ifndef SHAD_SPIRV_ALIGN\n"
+    "#if defined(__cplusplus)\n"
+    "#define SHAD_SPIRV_ALIGN alignas(4)\n"
+    "#elif defined(_MSC_VER)\n"
+    "#define SHAD_SPIRV_ALIGN __declspec(align(4))\n"
+    "#elif defined(__STDC_VERSION__) && __STDC_VERSION__ >= 201112L\n"
+    "#define SHAD_SPIRV_ALIGN _Alignas(4)\n"
+    "#else\n"
+    "#define SHAD_SPIRV_ALIGN __attribute__((aligned(4)))\n"
+    "#endif\n"
+    "#endif\n";
+
+void shad__serialize_spirv_decl(ShadWriter *w, const char *stage, const char *ext, const char *name, char *spirv, int spirv_size, ShadEmbedMode mode, const char *spirv_path, const char *linkage) {
+    switch (mode) {
+        case SHAD_EMBED_STRING:
+            shad__writer_print(w, "%sSHAD_SPIRV_ALIGN %s char shad__spirv_%s_code_%s[] =", shad__spirv_align_macro, linkage, stage, name);
+            shad__serialize_spirv_to_string(w, spirv, spirv_size);
+            shad__writer_print(w, ";\n");
+            break;
+        case SHAD_EMBED_C23:
+            shad__writer_print(w, "%sSHAD_SPIRV_ALIGN %s unsigned char shad__spirv_%s_code_%s[] = {\n#embed \"%s%s%s\"\n};\n", shad__spirv_align_macro, linkage, stage, name, spirv_path, name, ext);
+            break;
+        case SHAD_EMBED_INCBIN:
+            shad__writer_print(w, "extern const unsigned char shad__spirv_%s_code_%s[];\n", stage, name);
+            break;
+        default:
+            shad__writer_print(w, "%s unsigned shad__spirv_%s_code_%s[%i] = {", linkage, stage, name, spirv_size/4);
+            shad__serialize_spirv_to_code(w, spirv, spirv_size);
+            shad__writer_print(w, "};\n");
+            break;
+    }
+}
+
 void shad_sdl_serialize_to_c(ShadCompilation *sc, const char *name, char **code_out, int *code_len_out) {
-    ShadArena *arena = shad__compilation_arena_get(sc);
-    ShadWriter writer = {arena, NULL, 0, 0};
+    shad_sdl_serialize_to_c_embed(sc, name, SHAD_EMBED_ARRAY, "", code_out, code_len_out);
+}
+
+void shad_serialize_to_asm(ShadCompilation *sc, const char *name, const char *spirv_path, char **code_out, int *code_len_out) {
+    /* .S files go through the preprocessor, which lets us deal with the platform differences */
+    static const char preamble[] =
+        "#ifndef SHAD_SYM\n"
+        "#if defined(__APPLE__)\n"
+        "#define SHAD_SYM(x) _##x\n"
+        "#define SHAD_RODATA .section __TEXT,__const\n"
+        "#elif defined(_WIN32)\n"
+        "#define SHAD_SYM(x) x\n"
+        "#define SHAD_RODATA .section .rdata,\"dr\"\n"
+        "#else\n"
+        "#define SHAD_SYM(x) x\n"
+        "#define SHAD_RODATA .section .rodata\n"
+        "    .section .note.GNU-stack,\"\",%progbits\n"
+        "#endif\n"
+        "#endif\n";
+    ShadWriter writer = {shad__compilation_arena_get(sc), NULL, 0, 0};
     int i;
 
-    /* vertex spirv */
-    shad__writer_print(&writer, "static const unsigned shad__spirv_vertex_code_%s[%i] = {", name, (int)sc->spirv_vertex_code_size/4);
-    shad__serialize_spirv_to_code(&writer, (char*)sc->spirv_vertex_code, (int)sc->spirv_vertex_code_size);
-    shad__writer_print(&writer, "};\n");
+    shad__writer_print(&writer, "%s", preamble);
+    for (i = 0; i < 1 + sc->has_fragment_shader; ++i) {
+        const char *stage = i ? "fragment" : "vertex";
+        shad__writer_print(&writer,
+            "    SHAD_RODATA\n"
+            "    .balign 4\n"
+            "    .globl SHAD_SYM(shad__spirv_%s_code_%s)\n"
+            "SHAD_SYM(shad__spirv_%s_code_%s):\n"
+            "    .incbin \"%s%s%s\"\n",
+            stage, name, stage, name, spirv_path, name, i ? ".frag.spv" : ".vert.spv");
+    }
+
+    *code_out = writer.buf;
+    *code_len_out = writer.len;
+}
+
+/* the declaration of another compilation's SPIRV array, for when it's defined in another file */
+void shad__serialize_spirv_extern(ShadWriter *w, const char *stage, const char *name, ShadEmbedMode mode) {
+    const char *type = mode == SHAD_EMBED_STRING ? "char" : mode == SHAD_EMBED_ARRAY ? "unsigned" : "unsigned char";
+    shad__writer_print(w, "extern const %s shad__spirv_%s_code_%s[];\n", type, stage, name);
+}
+
+/* writes the SPIRV, create infos and everything they point to. linkage is how the create infos are defined,
+   "static const" when everything goes in a header, "const" when they're defined once and declared extern.
+   The SPIRV arrays are defined with array_linkage. If vertex_spirv_of/fragment_spirv_of is set, the stage
+   uses the SPIRV array of that compilation instead of defining its own */
+void shad__sdl_write_c_pipeline(ShadWriter *w, ShadCompilation *sc, const char *name, const char *linkage, const char *cpp_name);
+
+void shad__sdl_write_c(ShadWriter *w, ShadCompilation *sc, const char *name, ShadEmbedMode mode, const char *spirv_path, const char *linkage, const char *array_linkage, const char *vertex_spirv_of, const char *fragment_spirv_of) {
+    /* vertex spirv. A shared array is already declared if we're all in one file */
+    if (!vertex_spirv_of)
+        shad__serialize_spirv_decl(w, "vertex", ".vert.spv", name, sc->spirv_vertex_code, sc->spirv_vertex_code_size, mode, spirv_path, array_linkage);
+    else if (strcmp(array_linkage, "static const"))
+        shad__serialize_spirv_extern(w, "vertex", vertex_spirv_of, mode);
 
     /* fragment spirv */
     if (sc->has_fragment_shader) {
-        shad__writer_print(&writer, "static const unsigned shad__spirv_fragment_code_%s[%i] = {", name, (int)sc->spirv_fragment_code_size/4);
-        shad__serialize_spirv_to_code(&writer, (char*)sc->spirv_fragment_code, (int)sc->spirv_fragment_code_size);
-        shad__writer_print(&writer, "};\n");
+        if (!fragment_spirv_of)
+            shad__serialize_spirv_decl(w, "fragment", ".frag.spv", name, sc->spirv_fragment_code, sc->spirv_fragment_code_size, mode, spirv_path, array_linkage);
+        else if (strcmp(array_linkage, "static const"))
+            shad__serialize_spirv_extern(w, "fragment", fragment_spirv_of, mode);
     } else {
-        shad__writer_print(&writer, "static const unsigned shad__spirv_fragment_code_%s[1];\n", name);
+        shad__writer_print(w, "static const unsigned shad__spirv_fragment_code_%s[1] = {0};\n", name);
     }
 
     /* vertex shader */
-    shad__writer_print(&writer, "static const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_%s = {\n", name);
-    shad__writer_print(&writer, "    (size_t)%i, /* code_size */\n", (int)sc->spirv_vertex_code_size);
-    shad__writer_print(&writer, "    (const Uint8*)shad__spirv_vertex_code_%s,   /* code */\n", name);
-    shad__writer_print(&writer, "    \"main\",                    /* entrypoint */\n");
-    shad__writer_print(&writer, "    SDL_GPU_SHADERFORMAT_SPIRV,  /* format */\n");
-    shad__writer_print(&writer, "    SDL_GPU_SHADERSTAGE_VERTEX,  /* stage */\n");
-    shad__writer_print(&writer, "    (Uint32)%i,                  /* num_samplers */\n", (int)sc->num_vertex_samplers);
-    shad__writer_print(&writer, "    (Uint32)%i,                  /* num_storage_textures */\n", (int)sc->num_vertex_images);
-    shad__writer_print(&writer, "    (Uint32)%i,                  /* num_storage_buffers */\n", (int)sc->num_vertex_buffers);
-    shad__writer_print(&writer, "    (Uint32)%i,                  /* num_uniform_buffers */\n", (int)sc->num_vertex_uniforms);
-    shad__writer_print(&writer, "    0,                  /* props */\n");
-    shad__writer_print(&writer, "};\n");
+    shad__writer_print(w, "%s SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_%s = {\n", linkage, name);
+    shad__writer_print(w, "    (size_t)%i, /* code_size */\n", (int)sc->spirv_vertex_code_size);
+    shad__writer_print(w, "    (const Uint8*)shad__spirv_vertex_code_%s,   /* code */\n", vertex_spirv_of ? vertex_spirv_of : name);
+    shad__writer_print(w, "    \"main\",                    /* entrypoint */\n");
+    shad__writer_print(w, "    SDL_GPU_SHADERFORMAT_SPIRV,  /* format */\n");
+    shad__writer_print(w, "    SDL_GPU_SHADERSTAGE_VERTEX,  /* stage */\n");
+    shad__writer_print(w, "    (Uint32)%i,                  /* num_samplers */\n", (int)sc->num_vertex_samplers);
+    shad__writer_print(w, "    (Uint32)%i,                  /* num_storage_textures */\n", (int)sc->num_vertex_images);
+    shad__writer_print(w, "    (Uint32)%i,                  /* num_storage_buffers */\n", (int)sc->num_vertex_buffers);
+    shad__writer_print(w, "    (Uint32)%i,                  /* num_uniform_buffers */\n", (int)sc->num_vertex_uniforms);
+    shad__writer_print(w, "    0,                  /* props */\n");
+    shad__writer_print(w, "};\n");
 
     /* fragment shader */
     if (sc->has_fragment_shader) {
-        shad__writer_print(&writer, "static const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_%s = {\n", name);
-        shad__writer_print(&writer, "    (size_t)%i,   /* code_size */\n", (int)sc->spirv_fragment_code_size);
-        shad__writer_print(&writer, "    (const Uint8*)shad__spirv_fragment_code_%s,  /* code */\n", name);
-        shad__writer_print(&writer, "    \"main\",                      /* entrypoint */\n");
-        shad__writer_print(&writer, "    SDL_GPU_SHADERFORMAT_SPIRV,    /* format */\n");
-        shad__writer_print(&writer, "    SDL_GPU_SHADERSTAGE_FRAGMENT,  /* stage */\n");
-        shad__writer_print(&writer, "    (Uint32)%i,         /* num_samplers */\n", (int)sc->num_fragment_samplers);
-        shad__writer_print(&writer, "    (Uint32)%i,         /* num_storage_textures */\n", (int)sc->num_fragment_images);
-        shad__writer_print(&writer, "    (Uint32)%i,         /* num_storage_buffers */\n", (int)sc->num_fragment_buffers);
-        shad__writer_print(&writer, "    (Uint32)%i,         /* num_uniform_buffers */\n", (int)sc->num_fragment_uniforms);
-        shad__writer_print(&writer, "    0,                  /* props */\n");
-        shad__writer_print(&writer, "};\n");
+        shad__writer_print(w, "%s SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_%s = {\n", linkage, name);
+        shad__writer_print(w, "    (size_t)%i,   /* code_size */\n", (int)sc->spirv_fragment_code_size);
+        shad__writer_print(w, "    (const Uint8*)shad__spirv_fragment_code_%s,  /* code */\n", fragment_spirv_of ? fragment_spirv_of : name);
+        shad__writer_print(w, "    \"main\",                      /* entrypoint */\n");
+        shad__writer_print(w, "    SDL_GPU_SHADERFORMAT_SPIRV,    /* format */\n");
+        shad__writer_print(w, "    SDL_GPU_SHADERSTAGE_FRAGMENT,  /* stage */\n");
+        shad__writer_print(w, "    (Uint32)%i,         /* num_samplers */\n", (int)sc->num_fragment_samplers);
+        shad__writer_print(w, "    (Uint32)%i,         /* num_storage_textures */\n", (int)sc->num_fragment_images);
+        shad__writer_print(w, "    (Uint32)%i,         /* num_storage_buffers */\n", (int)sc->num_fragment_buffers);
+        shad__writer_print(w, "    (Uint32)%i,         /* num_uniform_buffers */\n", (int)sc->num_fragment_uniforms);
+        shad__writer_print(w, "    0,                  /* props */\n");
+        shad__writer_print(w, "};\n");
     } else {
-        shad__writer_print(&writer, "static const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_%s;\n", name);
+        shad__writer_print(w, "%s SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_%s = {0};\n", linkage, name);
     }
 
+    shad__sdl_write_c_pipeline(w, sc, name, linkage, NULL);
+}
+
+/* the pipeline create info shad_sdl_pipeline_<name> and the arrays it points to.
+   With cpp_name it's all static constexpr instead, and the pipeline is called cpp_name, to go in a C++ struct */
+void shad__sdl_write_c_pipeline(ShadWriter *w, ShadCompilation *sc, const char *name, const char *linkage, const char *cpp_name) {
+    const char *array_linkage = cpp_name ? "static constexpr" : "static const";
+    /* the placeholder for an empty array is initialized with a cast, so the C also compiles as C++ */
+    const char *empty = cpp_name ? " = {}" : " = {{(Uint32)0}}";
+    int i;
+
     /* vertex inputs */
     if (sc->num_vertex_inputs) {
-        shad__writer_print(&writer, "static const SDL_GPUVertexAttribute shad__vertex_attributes_info_%s[%i] = {\n", name, (int)sc->num_vertex_inputs);
+        shad__writer_print(w, "%s SDL_GPUVertexAttribute shad__vertex_attributes_info_%s[%i] = {\n", array_linkage, name, (int)sc->num_vertex_inputs);
         for (i = 0; i < sc->num_vertex_inputs; ++i) {
             ShadVertexInput *in = sc->vertex_inputs + i;
-            shad__writer_print(&writer,
+            shad__writer_print(w,
             "    {\n"
             "        (Uint32)%i,                          /* location */\n"
             "        (Uint32)%i,                          /* buffer_slot */\n"
@@ -1823,17 +4315,17 @@ void shad_sdl_serialize_to_c(ShadCompilation *sc, const char *name, char **code_
             shad_to_sdl_vertex_element_format_string[in->format],
             (int)in->offset);
         }
-        shad__writer_print(&writer, "};\n");
+        shad__writer_print(w, "};\n");
     } else {
-        shad__writer_print(&writer, "static const SDL_GPUVertexAttribute shad__vertex_attributes_info_%s[1];\n", name);
+        shad__writer_print(w, "%s SDL_GPUVertexAttribute shad__vertex_attributes_info_%s[1]%s;\n", array_linkage, name, empty);
     }
 
     /* vertex input buffers */
     if (sc->num_vertex_input_buffers) {
-        shad__writer_print(&writer, "static const SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_%s[%i] = {\n", name, (int)sc->num_vertex_input_buffers);
+        shad__writer_print(w, "%s SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_%s[%i] = {\n", array_linkage, name, (int)sc->num_vertex_input_buffers);
         for (i = 0; i < sc->num_vertex_input_buffers; ++i) {
             ShadVertexInputBuffer *buffer = sc->vertex_input_buffers + i;
-            shad__writer_print(&writer,
+            shad__writer_print(w,
             "    {\n"
             "        (Uint32)%i,                          /* slot */\n"
             "        (Uint32)%i,                          /* pitch */\n"
@@ -1844,102 +4336,1033 @@ void shad_sdl_serialize_to_c(ShadCompilation *sc, const char *name, char **code_
             (int)buffer->stride,
             buffer->instanced ? "SDL_GPU_VERTEXINPUTRATE_INSTANCE" : "SDL_GPU_VERTEXINPUTRATE_VERTEX");
         }
-        shad__writer_print(&writer, "};\n");
+        shad__writer_print(w, "};\n");
     } else {
-        shad__writer_print(&writer, "static const SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_%s[1];\n", name);
+        shad__writer_print(w, "%s SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_%s[1]%s;\n", array_linkage, name, empty);
     }
 
     /* color target descriptions */
     if (sc->num_fragment_outputs) {
-        shad__writer_print(&writer, "static const SDL_GPUColorTargetDescription shad__color_target_descriptions_info_%s[%i] = {\n", name, (int)sc->num_fragment_outputs);
+        shad__writer_print(w, "%s SDL_GPUColorTargetDescription shad__color_target_descriptions_info_%s[%i] = {\n", array_linkage, name, (int)sc->num_fragment_outputs);
         for (i = 0; i < sc->num_fragment_outputs; ++i) {
             ShadFragmentOutput *out = sc->fragment_outputs + i;
-            shad__writer_print(&writer, "    {\n");
-            shad__writer_print(&writer, "        %s,   /* format */\n", shad_to_sdl_texture_format_string[out->format]);
-            shad__writer_print(&writer, "        {\n");
-            shad__writer_print(&writer, "            %s,   /* src_color_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_src]);
-            shad__writer_print(&writer, "            %s,   /* dst_color_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_dst]);
-            shad__writer_print(&writer, "            %s,   /* color_blend_op */\n", shad_to_sdl_blend_op_string[out->blend_op]);
-            shad__writer_print(&writer, "            %s,   /* src_alpha_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_src]);
-            shad__writer_print(&writer, "            %s,   /* dst_alpha_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_dst]);
-            shad__writer_print(&writer, "            %s,   /* alpha_blend_op */\n", shad_to_sdl_blend_op_string[out->blend_op]);
-            shad__writer_print(&writer, "            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */\n");
-            shad__writer_print(&writer, "            (bool)%i,   /* enable_blend */\n", (int)out->blend_op != SHAD_BLEND_OP_INVALID);
-            shad__writer_print(&writer, "            (bool)0,   /* enable_color_write_mask */\n");
-            shad__writer_print(&writer, "            (Uint8)0,   /* padding1 */\n");
-            shad__writer_print(&writer, "            (Uint8)0,   /* padding2 */\n");
-            shad__writer_print(&writer, "        },\n");
-            shad__writer_print(&writer, "    },\n");
+            shad__writer_print(w, "    {\n");
+            shad__writer_print(w, "        %s,   /* format */\n", shad_to_sdl_texture_format_string[out->format]);
+            shad__writer_print(w, "        {\n");
+            shad__writer_print(w, "            %s,   /* src_color_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_src]);
+            shad__writer_print(w, "            %s,   /* dst_color_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_dst]);
+            shad__writer_print(w, "            %s,   /* color_blend_op */\n", shad_to_sdl_blend_op_string[out->blend_op]);
+            shad__writer_print(w, "            %s,   /* src_alpha_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_src]);
+            shad__writer_print(w, "            %s,   /* dst_alpha_blendfactor */\n", shad_to_sdl_blend_factor_string[out->blend_dst]);
+            shad__writer_print(w, "            %s,   /* alpha_blend_op */\n", shad_to_sdl_blend_op_string[out->blend_op]);
+            shad__writer_print(w, "            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */\n");
+            shad__writer_print(w, "            (bool)%i,   /* enable_blend */\n", (int)out->blend_op != SHAD_BLEND_OP_INVALID);
+            shad__writer_print(w, "            (bool)0,   /* enable_color_write_mask */\n");
+            shad__writer_print(w, "            (Uint8)0,   /* padding1 */\n");
+            shad__writer_print(w, "            (Uint8)0,   /* padding2 */\n");
+            shad__writer_print(w, "        },\n");
+            shad__writer_print(w, "    },\n");
         }
-        shad__writer_print(&writer, "};\n");
+        shad__writer_print(w, "};\n");
     } else {
-        shad__writer_print(&writer, "static const SDL_GPUColorTargetDescription shad__color_target_descriptions_info_%s[1];\n", name);
+        shad__writer_print(w, "%s SDL_GPUColorTargetDescription shad__color_target_descriptions_info_%s[1]%s;\n", array_linkage, name, cpp_name ? empty : " = {{(SDL_GPUTextureFormat)0}}");
     }
 
     /* pipeline*/
-    shad__writer_print(&writer, "static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_%s = {\n", name);
-    shad__writer_print(&writer, "    NULL,   /* vertex_shader */\n");
-    shad__writer_print(&writer, "    NULL,   /* fragment_shader */\n");
+    if (cpp_name) shad__writer_print(w, "%s SDL_GPUGraphicsPipelineCreateInfo %s = {\n", linkage, cpp_name);
+    else shad__writer_print(w, "%s SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_%s = {\n", linkage, name);
+    shad__writer_print(w, "    NULL,   /* vertex_shader */\n");
+    shad__writer_print(w, "    NULL,   /* fragment_shader */\n");
     /* vertex input state */
-    shad__writer_print(&writer, "    {\n");
-    shad__writer_print(&writer, "        shad__vertex_buffer_descriptions_info_%s,   /* vertex_buffer_descriptions */\n", name);
-    shad__writer_print(&writer, "        (Uint32)%i,                          /* num_vertex_buffers */\n", (int)sc->num_vertex_input_buffers);
-    shad__writer_print(&writer, "        shad__vertex_attributes_info_%s,   /* vertex_attributes */\n", name);
-    shad__writer_print(&writer, "        (Uint32)%i,                          /* num_vertex_attributes */\n", (int)sc->num_vertex_inputs);
-    shad__writer_print(&writer, "    },\n");
+    shad__writer_print(w, "    {\n");
+    shad__writer_print(w, "        shad__vertex_buffer_descriptions_info_%s,   /* vertex_buffer_descriptions */\n", name);
+    shad__writer_print(w, "        (Uint32)%i,                          /* num_vertex_buffers */\n", (int)sc->num_vertex_input_buffers);
+    shad__writer_print(w, "        shad__vertex_attributes_info_%s,   /* vertex_attributes */\n", name);
+    shad__writer_print(w, "        (Uint32)%i,                          /* num_vertex_attributes */\n", (int)sc->num_vertex_inputs);
+    shad__writer_print(w, "    },\n");
     /* primitive type */
-    shad__writer_print(&writer, "    %s, /* primitive_type */\n", shad_to_sdl_primitive_string[sc->primitive]);
+    shad__writer_print(w, "    %s, /* primitive_type */\n", shad_to_sdl_primitive_string[sc->primitive]);
     /* rasterizer state */
-    shad__writer_print(&writer, "    {\n");
-    shad__writer_print(&writer, "        SDL_GPU_FILLMODE_FILL,   /* fill_mode */\n");
-    shad__writer_print(&writer, "        %s,   /* cull_mode */\n", shad_to_sdl_cull_mode_string[sc->cull_mode]);
-    shad__writer_print(&writer, "        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */\n");
-    shad__writer_print(&writer, "        0.f,   /* depth_bias_constant_factor */\n");
-    shad__writer_print(&writer, "        0.f,   /* depth_bias_clamp */\n");
-    shad__writer_print(&writer, "        0.f,   /* depth_bias_slope_factor */\n");
-    shad__writer_print(&writer, "        (bool)0,   /* enable_depth_bias */\n");
-    shad__writer_print(&writer, "        (bool)%i,   /* enable_depth_clip */\n", (int)sc->depth_clip);
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding1 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding2 */\n");
-    shad__writer_print(&writer, "    },\n");
+    shad__writer_print(w, "    {\n");
+    shad__writer_print(w, "        SDL_GPU_FILLMODE_FILL,   /* fill_mode */\n");
+    shad__writer_print(w, "        %s,   /* cull_mode */\n", shad_to_sdl_cull_mode_string[sc->cull_mode]);
+    shad__writer_print(w, "        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */\n");
+    shad__writer_print(w, "        0.f,   /* depth_bias_constant_factor */\n");
+    shad__writer_print(w, "        0.f,   /* depth_bias_clamp */\n");
+    shad__writer_print(w, "        0.f,   /* depth_bias_slope_factor */\n");
+    shad__writer_print(w, "        (bool)0,   /* enable_depth_bias */\n");
+    shad__writer_print(w, "        (bool)%i,   /* enable_depth_clip */\n", (int)sc->depth_clip);
+    shad__writer_print(w, "        (Uint8)0,   /* padding1 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding2 */\n");
+    shad__writer_print(w, "    },\n");
     /* multisample state */
-    shad__writer_print(&writer, "    {\n");
-    shad__writer_print(&writer, "        %s,   /* sample_count */\n", shad_to_sdl_sample_count_string[sc->multisample_count]);
-    shad__writer_print(&writer, "        (Uint32)0,   /* sample_mask */\n");
-    shad__writer_print(&writer, "        (bool)0,   /* enable_mask */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding1 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding2 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding3 */\n");
-    shad__writer_print(&writer, "    },\n");
+    shad__writer_print(w, "    {\n");
+    shad__writer_print(w, "        %s,   /* sample_count */\n", shad_to_sdl_sample_count_string[sc->multisample_count]);
+    shad__writer_print(w, "        (Uint32)0,   /* sample_mask */\n");
+    shad__writer_print(w, "        (bool)0,   /* enable_mask */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding1 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding2 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding3 */\n");
+    shad__writer_print(w, "    },\n");
     /* depth stencil state */
-    shad__writer_print(&writer, "    {\n");
-    shad__writer_print(&writer, "        %s,   /* compare_op */\n", shad_to_sdl_compare_op_string[sc->depth_cmp]);
-    shad__writer_print(&writer, "        {0}, /* back stencil state */\n");
-    shad__writer_print(&writer, "        {0}, /* front stencil state */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* compare_mask */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* write_mask */\n");
-    shad__writer_print(&writer, "        (bool)%i,   /* enable_depth_test */\n", (int)sc->depth_cmp != SHAD_COMPARE_OP_INVALID);
-    shad__writer_print(&writer, "        (bool)%i,   /* enable_depth_write */\n", (int)sc->depth_write);
-    shad__writer_print(&writer, "        (bool)0,   /* enable_stencil_test */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding1 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding2 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding3 */\n");
-    shad__writer_print(&writer, "    },\n");
+    shad__writer_print(w, "    {\n");
+    shad__writer_print(w, "        %s,   /* compare_op */\n", shad_to_sdl_compare_op_string[sc->depth_cmp]);
+    shad__writer_print(w, "        {(SDL_GPUStencilOp)0}, /* back stencil state */\n");
+    shad__writer_print(w, "        {(SDL_GPUStencilOp)0}, /* front stencil state */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* compare_mask */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* write_mask */\n");
+    shad__writer_print(w, "        (bool)%i,   /* enable_depth_test */\n", (int)sc->depth_cmp != SHAD_COMPARE_OP_INVALID);
+    shad__writer_print(w, "        (bool)%i,   /* enable_depth_write */\n", (int)sc->depth_write);
+    shad__writer_print(w, "        (bool)0,   /* enable_stencil_test */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding1 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding2 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding3 */\n");
+    shad__writer_print(w, "    },\n");
     /* target info */
-    shad__writer_print(&writer, "    {\n");
-    shad__writer_print(&writer, "        shad__color_target_descriptions_info_%s,   /* color_target_descriptions */\n", name);
-    shad__writer_print(&writer, "        (Uint32)%i,   /* num_color_targets */\n", (int)sc->num_fragment_outputs);
-    shad__writer_print(&writer, "        %s,   /* depth_stencil_format */\n", shad_to_sdl_texture_format_string[sc->depth_format]);
-    shad__writer_print(&writer, "        (bool)%i,   /* has_depth_stencil_target */\n", (int)sc->depth_format != SHAD_TEXTURE_FORMAT_INVALID);
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding1 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding2 */\n");
-    shad__writer_print(&writer, "        (Uint8)0,   /* padding3 */\n");
-    shad__writer_print(&writer, "    },\n");
+    shad__writer_print(w, "    {\n");
+    shad__writer_print(w, "        shad__color_target_descriptions_info_%s,   /* color_target_descriptions */\n", name);
+    shad__writer_print(w, "        (Uint32)%i,   /* num_color_targets */\n", (int)sc->num_fragment_outputs);
+    shad__writer_print(w, "        %s,   /* depth_stencil_format */\n", shad_to_sdl_texture_format_string[sc->depth_format]);
+    shad__writer_print(w, "        (bool)%i,   /* has_depth_stencil_target */\n", (int)sc->depth_format != SHAD_TEXTURE_FORMAT_INVALID);
+    shad__writer_print(w, "        (Uint8)0,   /* padding1 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding2 */\n");
+    shad__writer_print(w, "        (Uint8)0,   /* padding3 */\n");
+    shad__writer_print(w, "    },\n");
     /* pipeline end */
-    shad__writer_print(&writer, "};\n");
+    shad__writer_print(w, "};\n");
+}
+
+/* hashes, see shad_compilation_hash(). These are always static, so they can be used as constants */
+void shad__sdl_write_c_hashes(ShadWriter *w, ShadCompilation *sc, const char *name) {
+    ShadCompilationHash hash;
+    char hex[24];
+    shad_compilation_hash(sc, &hash);
+    shad__writer_print(w, "static const Uint64 shad_hash_%s = %s;\n", name, shad__hex64(hex, hash.all));
+    shad__writer_print(w, "static const Uint64 shad_vertex_spirv_hash_%s = %s;\n", name, shad__hex64(hex, hash.vertex_spirv));
+    shad__writer_print(w, "static const Uint64 shad_fragment_spirv_hash_%s = %s;\n", name, shad__hex64(hex, hash.fragment_spirv));
+    shad__writer_print(w, "static const Uint64 shad_pipeline_hash_%s = %s;\n", name, shad__hex64(hex, hash.pipeline));
+}
+
+/* a struct per vertex buffer with the layout of the vertex inputs, so vertices can be written straight into a buffer.
+   The layout is what the C compiler would pick anyway, the asserts are there to catch it if it doesn't */
+void shad__sdl_write_c_vertex_structs(ShadWriter *w, ShadCompilation *sc, const char *name) {
+    int i, j, pass;
+    for (i = 0; i < sc->num_vertex_input_buffers; ++i) {
+        int slot = sc->vertex_input_buffers[i].slot;
+        shad__writer_print(w, "typedef struct shad_vertex_%s_%i {\n", name, slot);
+        /* first the fields, then their offsets */
+        for (pass = 0; pass < 2; ++pass) {
+            for (j = 0; j < sc->num_vertex_inputs; ++j) {
+                ShadVertexInput *in = sc->vertex_inputs + j;
+                const char *type = shad_vertex_element_format_c_type[in->format].type;
+                int count = shad_vertex_element_format_c_type[in->format].count;
+                const char *field = in->name;
+                char location[24];
+                if (in->buffer_slot != slot) continue;
+                /* compacted compilations don't have names */
+                if (!field) shad__snprintf(location, sizeof(location), "location%i", j), field = location;
+                if (pass == 1)
+                    shad__writer_print(w, "SDL_COMPILE_TIME_ASSERT(shad_vertex_%s_%i_%s, offsetof(shad_vertex_%s_%i, %s) == %i);\n", name, slot, field, name, slot, field, (int)in->offset);
+                else if (count == 1)
+                    shad__writer_print(w, "    %s %s;\n", type, field);
+                else
+                    shad__writer_print(w, "    %s %s[%i];\n", type, field, count);
+            }
+            if (pass == 0) {
+                shad__writer_print(w, "} shad_vertex_%s_%i;\n", name, slot);
+                shad__writer_print(w, "SDL_COMPILE_TIME_ASSERT(shad_vertex_%s_%i_size, sizeof(shad_vertex_%s_%i) == %i);\n", name, slot, name, slot, (int)sc->vertex_input_buffers[i].stride);
+            }
+        }
+    }
+}
 
-    /* output result */
+/* SPIRV reflection of uniform and buffer blocks, for the generated C structs. Only what's needed for the layout is kept */
+typedef struct ShadSpirvMember {
+    const char *name;
+    int offset;
+    int matrix_stride;
+    ShadBool row_major;
+} ShadSpirvMember;
+
+typedef struct ShadSpirvId {
+    const unsigned *inst; /* the type, constant or variable defining the id */
+    int depth;            /* how deeply a type nests, 1 for scalars */
+    int array_stride;
+    int set, binding;
+    ShadBool block;
+    int num_members;
+    ShadSpirvMember *members;
+} ShadSpirvId;
+
+typedef struct ShadSpirvReflection {
+    ShadArena *arena;
+    ShadSpirvId *ids;
+    unsigned bound;
+} ShadSpirvReflection;
+
+/* types nested deeper than this are left out, which also bounds the recursion over them */
+#define SHAD__SPIRV_MAX_TYPE_DEPTH 32
+
+/* the nesting depth of a type instruction, or 0 if it can't be used: too short, a bad scalar width or vector size,
+   or made of types that aren't defined before it. The SPIRV could come from a deserialized blob, and requiring
+   types to be defined before use also rules out cycles */
+int shad__spirv_type_depth(ShadSpirvReflection *r, const unsigned *inst) {
+    unsigned op = inst[0] & 0xffff, wc = inst[0] >> 16, i;
+    int depth = 0;
+    switch (op) {
+        case 21: /* OpTypeInt */
+            if (wc < 4) return 0;
+            /* fallthrough */
+        case 22: /* OpTypeFloat */
+            return inst[2] == 8 || inst[2] == 16 || inst[2] == 32 || inst[2] == 64;
+        case 23: /* OpTypeVector */
+        case 24: /* OpTypeMatrix */
+            if (wc < 4 || inst[3] < 2 || inst[3] > 4) return 0;
+            break;
+        case 28: /* OpTypeArray */
+            if (wc < 4) return 0;
+            break;
+        case 29: /* OpTypeRuntimeArray */
+            break;
+        case 30: /* OpTypeStruct */
+            for (i = 2; i < wc; ++i) {
+                if (inst[i] >= r->bound || !r->ids[inst[i]].depth) return 0;
+                depth = SHAD_MAX(depth, r->ids[inst[i]].depth);
+            }
+            return depth < SHAD__SPIRV_MAX_TYPE_DEPTH ? depth + 1 : 0;
+        default:
+            return 0;
+    }
+    /* the element or column type */
+    if (inst[2] >= r->bound || !r->ids[inst[2]].depth) return 0;
+    depth = r->ids[inst[2]].depth;
+    return depth < SHAD__SPIRV_MAX_TYPE_DEPTH ? depth + 1 : 0;
+}
+
+ShadBool shad__spirv_reflect(ShadSpirvReflection *r, ShadArena *arena, const char *spirv, int size) {
+    unsigned num_words = (unsigned)size/4, i, wc, pass;
+    unsigned *words;
+
+    r->arena = arena;
+    if (num_words < 5) return 0;
+    words = (unsigned*)memcpy(shad__alloc(arena, (int)num_words*4, 4), spirv, num_words*4);
+    if (words[0] != SHAD__SPIRV_MAGIC) return 0;
+    r->bound = words[3];
+    r->ids = SHAD_ALLOC(ShadSpirvId, arena, r->bound);
+
+    /* the names and decorations come before the types they're on, so the types are found first */
+    for (pass = 0; pass < 2; ++pass) {
+        for (i = 5; i < num_words; i += wc) {
+            const unsigned *inst = words + i;
+            unsigned op = inst[0] & 0xffff;
+            ShadSpirvId *id;
+            wc = inst[0] >> 16;
+            if (!wc || wc > num_words - i) return 0;
+            if (wc < 3 || inst[1] >= r->bound) continue;
+
+            if (pass == 0) {
+                /* ids are only defined once, anything else is ignored */
+                switch (op) {
+                    case 43: /* OpConstant */
+                    case 59: /* OpVariable */
+                        if (wc >= 4 && inst[2] < r->bound && !r->ids[inst[2]].inst) r->ids[inst[2]].inst = inst;
+                        break;
+                    case 32: /* OpTypePointer */
+                        if (wc >= 4 && !r->ids[inst[1]].inst) r->ids[inst[1]].inst = inst;
+                        break;
+                    case 21: /* OpTypeInt */
+                    case 22: /* OpTypeFloat */
+                    case 23: /* OpTypeVector */
+                    case 24: /* OpTypeMatrix */
+                    case 28: /* OpTypeArray */
+                    case 29: /* OpTypeRuntimeArray */
+                    case 30: /* OpTypeStruct */
+                        id = &r->ids[inst[1]];
+                        if (id->inst || !(id->depth = shad__spirv_type_depth(r, inst))) break;
+                        id->inst = inst;
+                        if (op == 30) {
+                            id->num_members = (int)wc - 2;
+                            id->members = SHAD_ALLOC(ShadSpirvMember, arena, id->num_members);
+                        }
+                        break;
+                }
+                continue;
+            }
+
+            id = &r->ids[inst[1]];
+            switch (op) {
+                case 6: /* OpMemberName, the string has to end within the instruction */
+                    if (wc >= 4 && inst[2] < (unsigned)id->num_members && memchr(inst + 3, 0, (wc - 3) * 4))
+                        id->members[inst[2]].name = (const char*)(inst + 3);
+                    break;
+                case 71: /* OpDecorate */
+                    if (inst[2] == 2 || inst[2] == 3) id->block = 1; /* Block, BufferBlock */
+                    else if (wc >= 4 && inst[2] == 6) id->array_stride = (int)inst[3];
+                    else if (wc >= 4 && inst[2] == 33) id->binding = (int)inst[3];
+                    else if (wc >= 4 && inst[2] == 34) id->set = (int)inst[3];
+                    break;
+                case 72: /* OpMemberDecorate */
+                    if (wc < 4 || inst[2] >= (unsigned)id->num_members) break;
+                    if (inst[3] == 4) id->members[inst[2]].row_major = 1; /* RowMajor */
+                    else if (wc >= 5 && inst[3] == 7) id->members[inst[2]].matrix_stride = (int)inst[4];
+                    else if (wc >= 5 && inst[3] == 35) id->members[inst[2]].offset = (int)inst[4];
+                    break;
+            }
+        }
+    }
+    return 1;
+}
+
+/* the defining instruction of a type, or NULL */
+const unsigned* shad__spirv_type(ShadSpirvReflection *r, unsigned type) {
+    return type < r->bound ? r->ids[type].inst : NULL;
+}
+
+/* the length of an OpTypeArray, or -1 if it isn't a plain constant that fits an int */
+int shad__spirv_array_length(ShadSpirvReflection *r, const unsigned *array) {
+    const unsigned *c = shad__spirv_type(r, array[3]);
+    return c && (c[0] & 0xffff) == 43 && c[3] <= 0x7fffffff ? (int)c[3] : -1;
+}
+
+/* the scalar type a type is made of, which is also what C aligns it to */
+const unsigned* shad__spirv_scalar(ShadSpirvReflection *r, unsigned type) {
+    const unsigned *t = shad__spirv_type(r, type);
+    while (t) {
+        unsigned op = t[0] & 0xffff;
+        if (op == 21 || op == 22) return t;
+        if (op != 23 && op != 24 && op != 28 && op != 29) return NULL;
+        t = shad__spirv_type(r, t[2]);
+    }
+    return NULL;
+}
+
+/* size of a type as laid out in the block, with the padding a C compiler would add to the end of a struct.
+   Runtime arrays have no size */
+int shad__spirv_type_size(ShadSpirvReflection *r, unsigned type, int matrix_stride, ShadBool row_major, int *align_out) {
+    const unsigned *t = shad__spirv_type(r, type), *c;
+    long long size = 0;
+    int i, length, align = 0;
+    if (!t) return 0;
+    switch (t[0] & 0xffff) {
+        case 21: case 22: /* OpTypeInt, OpTypeFloat */
+            size = align = (int)t[2] / 8;
+            break;
+        case 23: /* OpTypeVector */
+            size = (long long)t[3] * shad__spirv_type_size(r, t[2], 0, 0, &align);
+            break;
+        case 24: /* OpTypeMatrix, columns of vectors */
+            c = shad__spirv_type(r, t[2]);
+            shad__spirv_type_size(r, t[2], 0, 0, &align);
+            size = (long long)(row_major && c ? c[3] : t[3]) * matrix_stride;
+            break;
+        case 28: /* OpTypeArray, the length is a constant */
+            length = shad__spirv_array_length(r, t);
+            shad__spirv_type_size(r, t[2], matrix_stride, row_major, &align);
+            size = length > 0 ? (long long)length * r->ids[type].array_stride : 0;
+            break;
+        case 29: /* OpTypeRuntimeArray */
+            shad__spirv_type_size(r, t[2], matrix_stride, row_major, &align);
+            break;
+        case 30: /* OpTypeStruct */
+            for (i = 0; i < r->ids[type].num_members; ++i) {
+                ShadSpirvMember *m = &r->ids[type].members[i];
+                size = SHAD_MAX(size, (long long)m->offset + shad__spirv_type_size(r, t[2+i], m->matrix_stride, m->row_major, &align));
+            }
+            if (align) size = (size + align - 1) / align * align;
+            break;
+    }
+    *align_out = SHAD_MAX(*align_out, align);
+    /* nonsense decorations can't overflow anything */
+    return size >= 0 && size <= 0x7fffffff ? (int)size : 0;
+}
+
+void shad__spirv_write_c_struct(ShadWriter *w, ShadSpirvReflection *r, unsigned type, const char *c_name, int padded_size);
+
+/* writes "<prefix><c type> <field><dimensions>;" for a member, the struct types it uses must already be written.
+   stride is the array stride if type is an array element, 0 otherwise */
+void shad__spirv_write_c_member(ShadWriter *w, ShadSpirvReflection *r, const char *prefix, unsigned type, int stride, const char *field, const char *struct_name, int matrix_stride, ShadBool row_major) {
+    const unsigned *t = shad__spirv_type(r, type), *scalar = shad__spirv_scalar(r, type);
+    const char *c_type = struct_name ? struct_name : "Uint32";
+    int scalar_size = 4;
+
+    if (scalar) {
+        ShadBool is_float = (scalar[0] & 0xffff) == 22;
+        scalar_size = (int)scalar[2] / 8;
+        if (is_float) c_type = scalar_size == 8 ? "double" : scalar_size == 4 ? "float" : "Uint16";
+        else if (scalar[3]) c_type = scalar_size == 8 ? "Sint64" : scalar_size == 4 ? "Sint32" : scalar_size == 2 ? "Sint16" : "Sint8";
+        else c_type = scalar_size == 8 ? "Uint64" : scalar_size == 4 ? "Uint32" : scalar_size == 2 ? "Uint16" : "Uint8";
+    }
+    shad__writer_print(w, "%s%s %s", prefix, c_type, field);
+
+    /* arrays, outermost first */
+    while (t && ((t[0] & 0xffff) == 28 || (t[0] & 0xffff) == 29)) {
+        int length = (t[0] & 0xffff) == 28 ? shad__spirv_array_length(r, t) : -1;
+        if (length >= 0) shad__writer_print(w, "[%i]", length);
+        else shad__writer_print(w, "[]");
+        stride = r->ids[type].array_stride;
+        type = t[2];
+        t = shad__spirv_type(r, type);
+    }
+
+    /* vectors and matrices are arrays of scalars. In an array, an element takes up the whole stride, which in std140 pads e.g. a float to 16 bytes */
+    if (scalar && t) {
+        switch (t[0] & 0xffff) {
+            case 21: case 22:
+                if (stride > scalar_size) shad__writer_print(w, "[%i]", stride / scalar_size);
+                break;
+            case 23:
+                shad__writer_print(w, "[%i]", stride > (int)t[3] * scalar_size ? stride / scalar_size : (int)t[3]);
+                break;
+            case 24: {
+                const unsigned *column = shad__spirv_type(r, t[2]);
+                shad__writer_print(w, "[%i][%i]", row_major && column ? (int)column[3] : (int)t[3], matrix_stride / scalar_size);
+                break;
+            }
+        }
+    }
+    shad__writer_print(w, ";\n");
+}
+
+/* the type of a member, without its array dimensions */
+unsigned shad__spirv_element_type(ShadSpirvReflection *r, unsigned type, int *stride_out) {
+    const unsigned *t = shad__spirv_type(r, type);
+    while (t && ((t[0] & 0xffff) == 28 || (t[0] & 0xffff) == 29)) {
+        *stride_out = r->ids[type].array_stride;
+        type = t[2];
+        t = shad__spirv_type(r, type);
+    }
+    return type;
+}
+
+/* writes the struct types of the members first, then the struct with explicit padding and asserts on the layout.
+   padded_size is the array stride for structs in arrays, 0 otherwise */
+void shad__spirv_write_c_struct(ShadWriter *w, ShadSpirvReflection *r, unsigned type, const char *c_name, int padded_size) {
+    ShadSpirvId *s = &r->ids[type];
+    const unsigned *t = s->inst;
+    const char **fields = SHAD_ALLOC(const char*, r->arena, s->num_members);
+    const char **struct_names = SHAD_ALLOC(const char*, r->arena, s->num_members);
+    int i, at = 0, num_pads = 0, align = 0, size;
+
+    size = shad__spirv_type_size(r, type, 0, 0, &align);
+    if (padded_size) size = padded_size;
+
+    for (i = 0; i < s->num_members; ++i) {
+        int stride = 0;
+        unsigned element = shad__spirv_element_type(r, t[2+i], &stride);
+        const unsigned *e = shad__spirv_type(r, element);
+        fields[i] = s->members[i].name;
+        /* stripped SPIRV has no names */
+        if (!fields[i] || !fields[i][0]) {
+            ShadWriter field = {r->arena, NULL, 0, 0};
+            shad__writer_print(&field, "member%i", i);
+            fields[i] = field.buf;
+        }
+        if (e && (e[0] & 0xffff) == 30) {
+            ShadWriter struct_name = {r->arena, NULL, 0, 0};
+            shad__writer_print(&struct_name, "%s_%s", c_name, fields[i]);
+            struct_names[i] = struct_name.buf;
+            shad__spirv_write_c_struct(w, r, element, struct_names[i], stride);
+        }
+    }
+
+    shad__writer_print(w, "typedef struct %s {\n", c_name);
+    for (i = 0; i < s->num_members; ++i) {
+        ShadSpirvMember *m = &s->members[i];
+        int member_align = 0;
+        if (m->offset > at) shad__writer_print(w, "    Uint8 _pad%i[%i];\n", num_pads++, m->offset - at);
+        shad__spirv_write_c_member(w, r, "    ", t[2+i], 0, fields[i], struct_names[i], m->matrix_stride, m->row_major);
+        at = m->offset + shad__spirv_type_size(r, t[2+i], m->matrix_stride, m->row_major, &member_align);
+    }
+    if (size > at) shad__writer_print(w, "    Uint8 _pad%i[%i];\n", num_pads++, size - at);
+    shad__writer_print(w, "} %s;\n", c_name);
+
+    shad__writer_print(w, "SDL_COMPILE_TIME_ASSERT(%s_size, sizeof(%s) == %i);\n", c_name, c_name, size);
+    for (i = 0; i < s->num_members; ++i)
+        shad__writer_print(w, "SDL_COMPILE_TIME_ASSERT(%s_%s, offsetof(%s, %s) == %i);\n", c_name, fields[i], c_name, fields[i], s->members[i].offset);
+}
+
+/* a struct per uniform and buffer block, laid out like the shader reads it.
+   If traits is set, the C++ specializations that map the shader and slot to the struct are written to it, see shad__sdl_write_cpp().
+   Returns the uniform slots that got a struct, bit slot for the vertex ones and bit 16+slot for the fragment ones */
+unsigned shad__sdl_write_c_block_structs(ShadWriter *w, ShadCompilation *sc, const char *name, ShadWriter *traits) {
+    unsigned uniform_structs = 0;
+    int stage;
+    for (stage = 0; stage < 2; ++stage) {
+        const char *spirv = stage ? sc->spirv_fragment_code : sc->spirv_vertex_code;
+        int spirv_size = stage ? sc->spirv_fragment_code_size : sc->spirv_vertex_code_size;
+        int first_buffer = stage ? sc->num_fragment_samplers + sc->num_fragment_images : sc->num_vertex_samplers + sc->num_vertex_images;
+        ShadSpirvReflection r;
+        ShadArena arena;
+        unsigned i;
+
+        if (!spirv || (stage && !sc->has_fragment_shader)) continue;
+        memset(&arena, 0, sizeof(arena));
+        if (!shad__spirv_reflect(&r, &arena, spirv, spirv_size)) {
+            shad__arena_destroy(&arena);
+            continue;
+        }
+        for (i = 0; i < r.bound; ++i) {
+            const unsigned *var = r.ids[i].inst, *ptr, *block;
+            ShadBool uniform;
+            ShadWriter c_name = {&arena, NULL, 0, 0};
+            int index;
+
+            /* OpVariable in the Uniform or StorageBuffer storage class, pointing at a block */
+            if (!var || (var[0] & 0xffff) != 59 || (var[3] != 2 && var[3] != 12)) continue;
+            ptr = shad__spirv_type(&r, var[1]);
+            if (!ptr || (ptr[0] & 0xffff) != 32) continue;
+            block = shad__spirv_type(&r, ptr[3]);
+            if (!block || (block[0] & 0xffff) != 30 || !r.ids[ptr[3]].block) continue;
+
+            uniform = r.ids[i].set == 1 || r.ids[i].set == 3;
+            index = uniform ? r.ids[i].binding : r.ids[i].binding - first_buffer;
+            if (index < 0) continue;
+            if (uniform && index < 16) uniform_structs |= 1u << (stage*16 + index);
+            shad__writer_print(&c_name, "shad_%s_%s_%s_%i", stage ? "fragment" : "vertex", uniform ? "uniform" : "buffer", name, index);
+            if (traits)
+                shad__writer_print(traits, "template <> struct %s_%s<shaders::%s, %i> {typedef %s type;};\n", stage ? "fragment" : "vertex", uniform ? "uniform" : "storage_buffer", name, index, c_name.buf);
+
+            /* a buffer that's only a runtime array can't be a C struct, so it gets the type of an element instead */
+            if (r.ids[ptr[3]].num_members == 1 && shad__spirv_type(&r, block[2]) && (shad__spirv_type(&r, block[2])[0] & 0xffff) == 29) {
+                ShadSpirvMember *m = &r.ids[ptr[3]].members[0];
+                int stride = 0;
+                unsigned element = shad__spirv_element_type(&r, block[2], &stride);
+                const unsigned *e = shad__spirv_type(&r, element);
+                if (e && (e[0] & 0xffff) == 30) {
+                    shad__spirv_write_c_struct(w, &r, element, c_name.buf, stride);
+                } else {
+                    shad__spirv_write_c_member(w, &r, "typedef ", element, stride, c_name.buf, NULL, m->matrix_stride, m->row_major);
+                    shad__writer_print(w, "SDL_COMPILE_TIME_ASSERT(%s_size, sizeof(%s) == %i);\n", c_name.buf, c_name.buf, stride);
+                }
+                continue;
+            }
+            shad__spirv_write_c_struct(w, &r, ptr[3], c_name.buf, 0);
+        }
+        shad__arena_destroy(&arena);
+    }
+    return uniform_structs;
+}
+
+void shad_sdl_serialize_to_c_embed(ShadCompilation *sc, const char *name, ShadEmbedMode mode, const char *spirv_path, char **code_out, int *code_len_out) {
+    ShadWriter writer = {shad__compilation_arena_get(sc), NULL, 0, 0};
+    shad__sdl_write_c(&writer, sc, name, mode, spirv_path, "static const", "static const", NULL, NULL);
+    shad__sdl_write_c_hashes(&writer, sc, name);
+    shad__sdl_write_c_vertex_structs(&writer, sc, name);
+    shad__sdl_write_c_block_structs(&writer, sc, name, NULL);
     *code_out = writer.buf;
     *code_len_out = writer.len;
 }
 
+unsigned shad__sdl_write_c_declarations(ShadWriter *w, ShadCompilation *sc, const char *name, ShadWriter *traits) {
+    shad__writer_print(w, "extern const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_%s;\n", name);
+    shad__writer_print(w, "extern const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_%s;\n", name);
+    shad__writer_print(w, "extern const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_%s;\n", name);
+    shad__sdl_write_c_hashes(w, sc, name);
+    shad__sdl_write_c_vertex_structs(w, sc, name);
+    return shad__sdl_write_c_block_structs(w, sc, name, traits);
+}
+
+void shad_sdl_serialize_to_c_split(ShadCompilation *sc, const char *name, ShadEmbedMode mode, const char *spirv_path, char **declarations_out, int *declarations_len_out, char **definitions_out, int *definitions_len_out) {
+    ShadArena *arena = shad__compilation_arena_get(sc);
+    ShadWriter declarations = {arena, NULL, 0, 0};
+    ShadWriter definitions = {arena, NULL, 0, 0};
+
+    shad__sdl_write_c_declarations(&declarations, sc, name, NULL);
+    shad__sdl_write_c(&definitions, sc, name, mode, spirv_path, "const", "static const", NULL, NULL);
+
+    *declarations_out = declarations.buf;
+    *declarations_len_out = declarations.len;
+    *definitions_out = definitions.buf;
+    *definitions_len_out = definitions.len;
+}
+
+/* what the shad_bind_<name>_<frequency>() helpers are built on, once per header */
+static const char shad__sdl_bind_preamble[] =
+    "#ifndef SHAD_SDL_BIND_CACHE_DEFINED\n"
+    "#define SHAD_SDL_BIND_CACHE_DEFINED\n"
+    "/* uniform data bigger than this is always pushed */\n"
+    "#ifndef SHAD_SDL_BIND_CACHE_UNIFORM_SIZE\n"
+    "#define SHAD_SDL_BIND_CACHE_UNIFORM_SIZE 256\n"
+    "#endif\n"
+    "/* what was last pushed and bound, so it isn't pushed or bound again. Slots go by update frequency, so per frame\n"
+    "   resources come first, and if shaders declare them alike they stay bound when switching between them.\n"
+    "   Call shad_sdl_bind_cache_begin() at the start of every render pass, which forgets everything.\n"
+    "   [0] is the vertex stage, [1] the fragment stage */\n"
+    "typedef struct ShadSdlBindCache {\n"
+    "    SDL_GPUCommandBuffer *cmd;\n"
+    "    SDL_GPURenderPass *pass;\n"
+    "    Uint32 uniform_sizes[2][4];\n"
+    "    Uint8 uniforms[2][4][SHAD_SDL_BIND_CACHE_UNIFORM_SIZE];\n"
+    "    SDL_GPUTextureSamplerBinding samplers[2][16];\n"
+    "    SDL_GPUTexture *storage_textures[2][8];\n"
+    "    SDL_GPUBuffer *storage_buffers[2][8];\n"
+    "    /* pushes and bind calls skipped in this render pass */\n"
+    "    int num_skipped;\n"
+    "} ShadSdlBindCache;\n"
+    "\n"
+    "static inline void shad_sdl_bind_cache_begin(ShadSdlBindCache *cache, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {\n"
+    "    SDL_memset(cache, 0, sizeof(*cache));\n"
+    "    cache->cmd = cmd;\n"
+    "    cache->pass = pass;\n"
+    "}\n"
+    "\n"
+    "static inline void shad_sdl_push_uniform(ShadSdlBindCache *cache, int stage, Uint32 slot, const void *data, Uint32 size) {\n"
+    "    if (slot < 4 && size <= SHAD_SDL_BIND_CACHE_UNIFORM_SIZE) {\n"
+    "        if (cache->uniform_sizes[stage][slot] == size && !SDL_memcmp(cache->uniforms[stage][slot], data, size)) {++cache->num_skipped; return;}\n"
+    "        cache->uniform_sizes[stage][slot] = size;\n"
+    "        SDL_memcpy(cache->uniforms[stage][slot], data, size);\n"
+    "    }\n"
+    "    else if (slot < 4)\n"
+    "        cache->uniform_sizes[stage][slot] = 0;\n"
+    "    if (stage) SDL_PushGPUFragmentUniformData(cache->cmd, slot, data, size);\n"
+    "    else SDL_PushGPUVertexUniformData(cache->cmd, slot, data, size);\n"
+    "}\n"
+    "\n"
+    "/* narrows [*lo, *hi) down to the values that aren't what's cached, and caches them. False if they all are */\n"
+    "static inline bool shad__sdl_bind_cache_update(void *cached, const void *values, size_t size, Uint32 *lo, Uint32 *hi) {\n"
+    "    char *c = (char*)cached;\n"
+    "    const char *v = (const char*)values;\n"
+    "    while (*lo < *hi && !SDL_memcmp(c + *lo*size, v + *lo*size, size)) ++*lo;\n"
+    "    while (*hi > *lo && !SDL_memcmp(c + (*hi-1)*size, v + (*hi-1)*size, size)) --*hi;\n"
+    "    SDL_memcpy(c + *lo*size, v + *lo*size, (*hi - *lo)*size);\n"
+    "    return *lo < *hi;\n"
+    "}\n"
+    "\n"
+    "/* binds what changed of slots first to first+num, in one call */\n"
+    "static inline void shad_sdl_bind_samplers(ShadSdlBindCache *cache, int stage, Uint32 first, const SDL_GPUTextureSamplerBinding *bindings, Uint32 num) {\n"
+    "    Uint32 lo = 0, hi = num;\n"
+    "    if (first + num <= 16 && !shad__sdl_bind_cache_update(cache->samplers[stage] + first, bindings, sizeof(*bindings), &lo, &hi)) {++cache->num_skipped; return;}\n"
+    "    if (stage) SDL_BindGPUFragmentSamplers(cache->pass, first + lo, bindings + lo, hi - lo);\n"
+    "    else SDL_BindGPUVertexSamplers(cache->pass, first + lo, bindings + lo, hi - lo);\n"
+    "}\n"
+    "\n"
+    "static inline void shad_sdl_bind_storage_textures(ShadSdlBindCache *cache, int stage, Uint32 first, SDL_GPUTexture *const *textures, Uint32 num) {\n"
+    "    Uint32 lo = 0, hi = num;\n"
+    "    if (first + num <= 8 && !shad__sdl_bind_cache_update(cache->storage_textures[stage] + first, textures, sizeof(*textures), &lo, &hi)) {++cache->num_skipped; return;}\n"
+    "    if (stage) SDL_BindGPUFragmentStorageTextures(cache->pass, first + lo, textures + lo, hi - lo);\n"
+    "    else SDL_BindGPUVertexStorageTextures(cache->pass, first + lo, textures + lo, hi - lo);\n"
+    "}\n"
+    "\n"
+    "static inline void shad_sdl_bind_storage_buffers(ShadSdlBindCache *cache, int stage, Uint32 first, SDL_GPUBuffer *const *buffers, Uint32 num) {\n"
+    "    Uint32 lo = 0, hi = num;\n"
+    "    if (first + num <= 8 && !shad__sdl_bind_cache_update(cache->storage_buffers[stage] + first, buffers, sizeof(*buffers), &lo, &hi)) {++cache->num_skipped; return;}\n"
+    "    if (stage) SDL_BindGPUFragmentStorageBuffers(cache->pass, first + lo, buffers + lo, hi - lo);\n"
+    "    else SDL_BindGPUVertexStorageBuffers(cache->pass, first + lo, buffers + lo, hi - lo);\n"
+    "}\n"
+    "#endif\n";
+
+static const char *shad__frequency_names[SHAD_FREQUENCY_COUNT] = {"per_frame", "per_material", "per_draw"};
+
+/* shad_bind_<name>_<frequency>() for each frequency the compilation has resources of. They take each resource as
+   an argument, named by stage, kind and slot, e.g. fragment_sampler1, and the uniforms as their struct if they have one */
+void shad__sdl_write_c_bind_helpers(ShadWriter *w, ShadCompilation *sc, const char *name, unsigned uniform_structs) {
+    static const char *kinds[4] = {"sampler", "storage_texture", "storage_buffer", "uniform"};
+    static const char *types[4] = {"SDL_GPUTextureSamplerBinding ", "SDL_GPUTexture *", "SDL_GPUBuffer *", NULL};
+    int f, kind, slot, first, count;
+
+    shad__writer_print(w, "%s", shad__sdl_bind_preamble);
+    for (f = 0; f < SHAD_FREQUENCY_COUNT; ++f) {
+        const char *sep = "";
+        int total = 0;
+        for (kind = 0; kind < SHAD__NUM_RESOURCE_KINDS; ++kind) {
+            shad__frequency_range(sc, kind, (ShadFrequency)f, &first, &count);
+            total += count;
+        }
+        if (!total) continue;
+
+        shad__writer_print(w, "/* pushes and binds the %s resources of %s, see ShadSdlBindCache */\n", shad__frequency_names[f], name);
+        shad__writer_print(w, "static inline void shad_bind_%s_%s(ShadSdlBindCache *cache", name, shad__frequency_names[f]);
+        for (kind = 0; kind < SHAD__NUM_RESOURCE_KINDS; ++kind) {
+            const char *stage = kind < 4 ? "vertex" : "fragment";
+            shad__frequency_range(sc, kind, (ShadFrequency)f, &first, &count);
+            for (slot = first; slot < first + count; ++slot) {
+                if (types[kind % 4])
+                    shad__writer_print(w, ", %s%s_%s%i", types[kind % 4], stage, kinds[kind % 4], slot);
+                else if (slot < 16 && ((uniform_structs >> ((kind / 4)*16 + slot)) & 1))
+                    shad__writer_print(w, ", const shad_%s_uniform_%s_%i *%s_uniform%i", stage, name, slot, stage, slot);
+                else
+                    shad__writer_print(w, ", const void *%s_uniform%i, Uint32 %s_uniform%i_size", stage, slot, stage, slot);
+            }
+        }
+        shad__writer_print(w, ") {\n");
+
+        for (kind = 0; kind < SHAD__NUM_RESOURCE_KINDS; ++kind) {
+            const char *stage = kind < 4 ? "vertex" : "fragment";
+            shad__frequency_range(sc, kind, (ShadFrequency)f, &first, &count);
+            if (!count) continue;
+            if (kind % 4 == 3) {
+                for (slot = first; slot < first + count; ++slot) {
+                    if (slot < 16 && ((uniform_structs >> ((kind / 4)*16 + slot)) & 1))
+                        shad__writer_print(w, "    shad_sdl_push_uniform(cache, %i, %i, %s_uniform%i, (Uint32)sizeof(*%s_uniform%i));\n", kind / 4, slot, stage, slot, stage, slot);
+                    else
+                        shad__writer_print(w, "    shad_sdl_push_uniform(cache, %i, %i, %s_uniform%i, %s_uniform%i_size);\n", kind / 4, slot, stage, slot, stage, slot);
+                }
+                continue;
+            }
+            /* the bindings of a kind are next to each other, so they're bound in one call */
+            shad__writer_print(w, "    {\n        %s%s_%ss[] = {", types[kind % 4], stage, kinds[kind % 4]);
+            for (slot = first, sep = ""; slot < first + count; ++slot, sep = ", ")
+                shad__writer_print(w, "%s%s_%s%i", sep, stage, kinds[kind % 4], slot);
+            shad__writer_print(w, "};\n        shad_sdl_bind_%ss(cache, %i, %i, %s_%ss, %i);\n    }\n", kinds[kind % 4], kind / 4, first, stage, kinds[kind % 4], count);
+        }
+        shad__writer_print(w, "}\n");
+    }
+}
+
+/* the C++ types and functions the shader tags are used with, once per header */
+static const char shad__cpp_preamble[] =
+    "#ifndef SHAD_CPP_DEFINED\n"
+    "#define SHAD_CPP_DEFINED\n"
+    "namespace shad {\n"
+    "/* the C struct of a slot of a shader as ::type, e.g. vertex_uniform<shaders::mesh, 0>::type.\n"
+    "   Only defined for the slots the shader has, so anything else doesn't compile */\n"
+    "template <class Shader, Uint32 Slot> struct vertex_buffer;\n"
+    "template <class Shader, Uint32 Slot> struct vertex_uniform;\n"
+    "template <class Shader, Uint32 Slot> struct vertex_storage_buffer;\n"
+    "template <class Shader, Uint32 Slot> struct fragment_uniform;\n"
+    "template <class Shader, Uint32 Slot> struct fragment_storage_buffer;\n"
+    "\n"
+    "template <class Shader, Uint32 Slot>\n"
+    "inline void push_vertex_uniform(SDL_GPUCommandBuffer *cmd, const typename vertex_uniform<Shader, Slot>::type &data) {\n"
+    "    SDL_PushGPUVertexUniformData(cmd, Slot, &data, (Uint32)sizeof(data));\n"
+    "}\n"
+    "template <class Shader, Uint32 Slot>\n"
+    "inline void push_fragment_uniform(SDL_GPUCommandBuffer *cmd, const typename fragment_uniform<Shader, Slot>::type &data) {\n"
+    "    SDL_PushGPUFragmentUniformData(cmd, Slot, &data, (Uint32)sizeof(data));\n"
+    "}\n"
+    "/* a mapped transfer buffer as the vertices of a vertex buffer slot */\n"
+    "template <class Shader, Uint32 Slot>\n"
+    "inline typename vertex_buffer<Shader, Slot>::type* map_vertices(SDL_GPUDevice *device, SDL_GPUTransferBuffer *buffer, bool cycle) {\n"
+    "    return (typename vertex_buffer<Shader, Slot>::type*)SDL_MapGPUTransferBuffer(device, buffer, cycle);\n"
+    "}\n"
+    "} /* namespace shad */\n"
+    "#endif\n";
+
+/* the C++ tag type shad::shaders::<name>: the resource counts and the pipeline create info as static constexpr members,
+   and the struct of every slot as specializations. traits has the uniform and storage buffer ones from shad__sdl_write_c_block_structs().
+   The shader create infos are only referenced if split, otherwise they're static and the struct would differ between translation units */
+void shad__sdl_write_cpp(ShadWriter *w, ShadCompilation *sc, const char *name, ShadWriter *traits, ShadBool split) {
+    char hex[24];
+    int i;
+
+    shad__writer_print(w, "#ifdef __cplusplus\n%s", shad__cpp_preamble);
+    shad__writer_print(w, "namespace shad {\nnamespace shaders {\n");
+    shad__writer_print(w, "struct %s {\n", name);
+    shad__writer_print(w, "    static constexpr const char *name = \"%s\";\n", name);
+    shad__writer_print(w, "    static constexpr Uint64 hash = %s;\n", shad__hex64(hex, shad_compilation_hash(sc, NULL)));
+    shad__writer_print(w, "    static constexpr Uint32 num_vertex_buffers = %i;\n", (int)sc->num_vertex_input_buffers);
+    shad__writer_print(w, "    static constexpr Uint32 num_vertex_samplers = %i;\n", (int)sc->num_vertex_samplers);
+    shad__writer_print(w, "    static constexpr Uint32 num_vertex_storage_textures = %i;\n", (int)sc->num_vertex_images);
+    shad__writer_print(w, "    static constexpr Uint32 num_vertex_storage_buffers = %i;\n", (int)sc->num_vertex_buffers);
+    shad__writer_print(w, "    static constexpr Uint32 num_vertex_uniform_buffers = %i;\n", (int)sc->num_vertex_uniforms);
+    shad__writer_print(w, "    static constexpr Uint32 num_fragment_samplers = %i;\n", (int)sc->num_fragment_samplers);
+    shad__writer_print(w, "    static constexpr Uint32 num_fragment_storage_textures = %i;\n", (int)sc->num_fragment_images);
+    shad__writer_print(w, "    static constexpr Uint32 num_fragment_storage_buffers = %i;\n", (int)sc->num_fragment_buffers);
+    shad__writer_print(w, "    static constexpr Uint32 num_fragment_uniform_buffers = %i;\n", (int)sc->num_fragment_uniforms);
+    shad__writer_print(w, "    static constexpr Uint32 num_color_targets = %i;\n", (int)sc->num_fragment_outputs);
+    if (split) {
+        shad__writer_print(w, "    static constexpr const SDL_GPUShaderCreateInfo &vertex_shader = shad_sdl_vertex_shader_%s;\n", name);
+        shad__writer_print(w, "    static constexpr const SDL_GPUShaderCreateInfo &fragment_shader = shad_sdl_fragment_shader_%s;\n", name);
+    }
+    shad__sdl_write_c_pipeline(w, sc, name, "static constexpr", "pipeline");
+    shad__writer_print(w, "};\n");
+    shad__writer_print(w, "} /* namespace shaders */\n");
+    for (i = 0; i < sc->num_vertex_input_buffers; ++i)
+        shad__writer_print(w, "template <> struct vertex_buffer<shaders::%s, %i> {typedef shad_vertex_%s_%i type;};\n", name, (int)sc->vertex_input_buffers[i].slot, name, (int)sc->vertex_input_buffers[i].slot);
+    if (traits->len) shad__writer_print(w, "%s", traits->buf);
+    shad__writer_print(w, "} /* namespace shad */\n#endif\n");
+}
+
+typedef struct ShadSdlCWriterEntry {
+    const char *name;
+    uint64_t hash;
+} ShadSdlCWriterEntry;
+
+void shad_sdl_c_writer_begin(ShadSdlCWriter *w) {
+    memset(w, 0, sizeof(*w));
+    w->spirv_path = "";
+    w->modules = memset(malloc(sizeof(ShadModuleTable)), 0, sizeof(ShadModuleTable));
+}
+
+/* returns the name of the compilation that first had this SPIRV, or NULL if it's the first */
+const char* shad__sdl_c_writer_module(ShadSdlCWriter *w, const char *name, const char *spirv, int size) {
+    ShadModuleTable *table = (ShadModuleTable*)w->modules;
+    ShadModuleTableEntry *module;
+    ShadBool found;
+    int len;
+
+    /* the assembly or object file defines every module, so there's nothing to share */
+    if (w->embed == SHAD_EMBED_INCBIN) return NULL;
+
+    module = shad__module_table_get(table, spirv, size, &found);
+    if (found) {
+        w->bytes_deduplicated += size;
+        return module->name;
+    }
+    len = (int)strlen(name);
+    module->name = (const char*)memcpy(shad__alloc(&table->arena, len+1, 1), name, len+1);
+    ++w->num_modules;
+    return NULL;
+}
+
+void shad_sdl_c_writer_add(ShadSdlCWriter *w, const char *name, ShadCompilation *sc, char **code_out, int *code_len_out, char **definitions_out, int *definitions_len_out) {
+    ShadArena *arena = shad__compilation_arena_get(sc);
+    ShadWriter code = {arena, NULL, 0, 0};
+    ShadWriter definitions = {arena, NULL, 0, 0};
+    ShadWriter traits = {arena, NULL, 0, 0};
+    const char *vertex_spirv_of, *fragment_spirv_of = NULL;
+    unsigned uniform_structs;
+
+    /* remembered for shad_sdl_c_writer_registry() */
+    if (w->num_entries == w->entries_cap) {
+        w->entries_cap = w->entries_cap ? w->entries_cap*2 : 64;
+        w->entries = realloc(w->entries, w->entries_cap * sizeof(ShadSdlCWriterEntry));
+    }
+    {
+        ShadSdlCWriterEntry *e = (ShadSdlCWriterEntry*)w->entries + w->num_entries++;
+        int len = (int)strlen(name);
+        e->name = (const char*)memcpy(shad__alloc(&((ShadModuleTable*)w->modules)->arena, len+1, 1), name, len+1);
+        e->hash = shad_compilation_hash(sc, NULL);
+    }
+
+    vertex_spirv_of = shad__sdl_c_writer_module(w, name, sc->spirv_vertex_code, sc->spirv_vertex_code_size);
+    if (sc->has_fragment_shader)
+        fragment_spirv_of = shad__sdl_c_writer_module(w, name, sc->spirv_fragment_code, sc->spirv_fragment_code_size);
+
+    if (w->split) {
+        /* shared arrays can be in another file, so they can't be static */
+        uniform_structs = shad__sdl_write_c_declarations(&code, sc, name, w->cpp ? &traits : NULL);
+        shad__sdl_write_c(&definitions, sc, name, w->embed, w->spirv_path, "const", "const", vertex_spirv_of, fragment_spirv_of);
+    } else {
+        shad__sdl_write_c(&code, sc, name, w->embed, w->spirv_path, "static const", "static const", vertex_spirv_of, fragment_spirv_of);
+        shad__sdl_write_c_hashes(&code, sc, name);
+        shad__sdl_write_c_vertex_structs(&code, sc, name);
+        uniform_structs = shad__sdl_write_c_block_structs(&code, sc, name, w->cpp ? &traits : NULL);
+    }
+    if (w->bind_helpers) shad__sdl_write_c_bind_helpers(&code, sc, name, uniform_structs);
+    if (w->cpp) shad__sdl_write_cpp(&code, sc, name, &traits, w->split);
+
+    *code_out = code.buf;
+    *code_len_out = code.len;
+    if (definitions_out) *definitions_out = definitions.buf;
+    if (definitions_len_out) *definitions_len_out = definitions.len;
+}
+
+/* FNV-1a, what the generated registry looks names up by */
+uint64_t shad__name_hash(const char *name) {
+    uint64_t h = 0xcbf29ce484222325ull;
+    while (*name) h = (h ^ (unsigned char)*name++) * 0x100000001b3ull;
+    return h;
+}
+
+/* the slot of a name in a generated registry. The generated <registry>_slot() does the same */
+int shad__registry_slot(uint64_t hash, const unsigned *displacements, int num_buckets, int num_entries) {
+    unsigned d = displacements[(unsigned)hash % (unsigned)num_buckets];
+    return (int)((((unsigned)(hash >> 32) ^ d) * 0x9e3779b1u & 0xffffffffu) % (unsigned)num_entries);
+}
+
+/* builds a minimal perfect hash over the names (hash and displace): the names are put in buckets by one half of
+   their hash, then for the biggest bucket first, we look for a displacement that puts all its names in free slots.
+   Returns the displacements (free them), or NULL if there is none, which only happens if two hashes are the same */
+unsigned* shad__registry_build(const uint64_t *hashes, int n, int *num_buckets_out) {
+    int num_buckets, i, j, k;
+
+    for (num_buckets = n/2 + 1; num_buckets <= n*4; num_buckets *= 2) {
+        unsigned *displacements = (unsigned*)calloc(num_buckets, sizeof(unsigned));
+        int *count = (int*)calloc(num_buckets, sizeof(int));
+        int *order = (int*)malloc(num_buckets * sizeof(int));
+        int *keys = (int*)malloc(n * sizeof(int));
+        int *slots = (int*)malloc(n * sizeof(int));
+        char *taken = (char*)calloc(n, 1);
+        ShadBool ok = 1;
+
+        for (i = 0; i < n; ++i) ++count[(unsigned)hashes[i] % (unsigned)num_buckets];
+        /* biggest buckets first, while there are the most free slots */
+        for (i = 0; i < num_buckets; ++i) {
+            for (j = i; j > 0 && count[order[j-1]] < count[i]; --j) order[j] = order[j-1];
+            order[j] = i;
+        }
+
+        for (i = 0; i < num_buckets && ok && count[order[i]]; ++i) {
+            int b = order[i], num_keys = 0;
+            unsigned d;
+            for (j = 0; j < n; ++j)
+                if ((int)((unsigned)hashes[j] % (unsigned)num_buckets) == b) keys[num_keys++] = j;
+            for (d = 0; d < (1u << 20); ++d) {
+                displacements[b] = d;
+                for (j = 0; j < num_keys; ++j) {
+                    slots[j] = shad__registry_slot(hashes[keys[j]], displacements, num_buckets, n);
+                    if (taken[slots[j]]) break;
+                    for (k = 0; k < j && slots[k] != slots[j]; ++k);
+                    if (k < j) break;
+                }
+                if (j == num_keys) break;
+            }
+            if (d == (1u << 20)) ok = 0;
+            for (j = 0; ok && j < num_keys; ++j) taken[slots[j]] = 1;
+        }
+
+        free(count);
+        free(order);
+        free(keys);
+        free(slots);
+        free(taken);
+        if (ok) {
+            *num_buckets_out = num_buckets;
+            return displacements;
+        }
+        free(displacements);
+    }
+    return NULL;
+}
+
+ShadBool shad_sdl_c_writer_registry(ShadSdlCWriter *w, const char *registry_name, char **code_out, int *code_len_out) {
+    ShadSdlCWriterEntry *entries = (ShadSdlCWriterEntry*)w->entries;
+    ShadWriter code = {&((ShadModuleTable*)w->modules)->arena, NULL, 0, 0};
+    const char *r = registry_name;
+    uint64_t *hashes;
+    unsigned *displacements;
+    int *entry_of_slot;
+    int n = w->num_entries, num_buckets = 0, i;
+    char hex[24];
+
+    *code_out = NULL;
+    *code_len_out = 0;
+    if (n <= 0) return 0;
+
+    hashes = (uint64_t*)malloc(n * sizeof(uint64_t));
+    for (i = 0; i < n; ++i) hashes[i] = shad__name_hash(entries[i].name);
+    displacements = shad__registry_build(hashes, n, &num_buckets);
+    if (!displacements) {
+        free(hashes);
+        return 0;
+    }
+    entry_of_slot = (int*)malloc(n * sizeof(int));
+    for (i = 0; i < n; ++i)
+        entry_of_slot[shad__registry_slot(hashes[i], displacements, num_buckets, n)] = i;
+
+    /* shared by all registries */
+    shad__writer_print(&code,
+        "#ifndef SHAD_SHADER_ENTRY_DEFINED\n"
+        "#define SHAD_SHADER_ENTRY_DEFINED\n"
+        "#ifdef __cplusplus\n"
+        "#define SHAD_CONSTEXPR_FN constexpr\n"
+        "#define SHAD_CONSTEXPR_DATA constexpr\n"
+        "#else\n"
+        "#define SHAD_CONSTEXPR_FN inline\n"
+        "#define SHAD_CONSTEXPR_DATA const\n"
+        "#endif\n"
+        "typedef struct ShadShaderEntry {\n"
+        "    const char *name;\n"
+        "    const SDL_GPUShaderCreateInfo *vertex_shader;\n"
+        "    const SDL_GPUShaderCreateInfo *fragment_shader;\n"
+        "    const SDL_GPUGraphicsPipelineCreateInfo *pipeline;\n"
+        "    Uint64 hash; /* shad_hash_<name> */\n"
+        "} ShadShaderEntry;\n"
+        "/* FNV-1a of a name, what registries look names up by */\n"
+        "static SHAD_CONSTEXPR_FN Uint64 shad_name_hash(const char *name) {\n"
+        "    Uint64 h = 0xcbf29ce484222325ull;\n"
+        "    while (*name) h = (h ^ (unsigned char)*name++) * 0x100000001b3ull;\n"
+        "    return h;\n"
+        "}\n"
+        "/* what shad_sdl_create_all() made for an entry */\n"
+        "typedef struct ShadSdlCreated {\n"
+        "    SDL_GPUShader *vertex_shader;\n"
+        "    SDL_GPUShader *fragment_shader;\n"
+        "    SDL_GPUGraphicsPipeline *pipeline;\n"
+        "} ShadSdlCreated;\n"
+        "/* runs task(data, i) for every i in [0, count) on your thread pool, and returns when they're all done */\n"
+        "typedef void (*ShadParallelFor)(void *pool, int count, void (*task)(void *data, int index), void *data);\n"
+        "/* what shad_sdl_create_all() creates things with, SDL_CreateGPUShader() and SDL_CreateGPUGraphicsPipeline() if NULL */\n"
+        "typedef struct ShadSdlCreateCallbacks {\n"
+        "    SDL_GPUShader* (*create_shader)(SDL_GPUDevice *device, const SDL_GPUShaderCreateInfo *info);\n"
+        "    SDL_GPUGraphicsPipeline* (*create_pipeline)(SDL_GPUDevice *device, const SDL_GPUGraphicsPipelineCreateInfo *info);\n"
+        "} ShadSdlCreateCallbacks;\n"
+        "typedef struct ShadSdlCreateJob {\n"
+        "    SDL_GPUDevice *device;\n"
+        "    const ShadShaderEntry *entries;\n"
+        "    ShadSdlCreated *out;\n"
+        "    ShadSdlCreateCallbacks callbacks;\n"
+        "} ShadSdlCreateJob;\n"
+        "/* a pipeline only needs its own two shaders, so an entry is a task of its own */\n"
+        "static inline void shad_sdl_create_entry(void *data, int index) {\n"
+        "    ShadSdlCreateJob *job = (ShadSdlCreateJob*)data;\n"
+        "    const ShadShaderEntry *e = &job->entries[index];\n"
+        "    ShadSdlCreated *out = &job->out[index];\n"
+        "    SDL_GPUGraphicsPipelineCreateInfo info;\n"
+        "    out->vertex_shader = job->callbacks.create_shader(job->device, e->vertex_shader);\n"
+        "    out->fragment_shader = e->fragment_shader->code_size ? job->callbacks.create_shader(job->device, e->fragment_shader) : NULL;\n"
+        "    out->pipeline = NULL;\n"
+        "    if (!out->vertex_shader || (e->fragment_shader->code_size && !out->fragment_shader)) return;\n"
+        "    info = *e->pipeline;\n"
+        "    info.vertex_shader = out->vertex_shader;\n"
+        "    info.fragment_shader = out->fragment_shader;\n"
+        "    out->pipeline = job->callbacks.create_pipeline(job->device, &info);\n"
+        "}\n"
+        "/* creates the shaders and pipeline of each of the count entries into out[count], spread over parallel_for (or one by one if NULL).\n"
+        "   Returns false if anything couldn't be created. What was created is in out either way, for you to release */\n"
+        "static inline bool shad_sdl_create_all(SDL_GPUDevice *device, const ShadShaderEntry *entries, int count, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated *out) {\n"
+        "    ShadSdlCreateJob job;\n"
+        "    int i;\n"
+        "    job.device = device;\n"
+        "    job.entries = entries;\n"
+        "    job.out = out;\n"
+        "    job.callbacks.create_shader = callbacks && callbacks->create_shader ? callbacks->create_shader : SDL_CreateGPUShader;\n"
+        "    job.callbacks.create_pipeline = callbacks && callbacks->create_pipeline ? callbacks->create_pipeline : SDL_CreateGPUGraphicsPipeline;\n"
+        "    if (parallel_for) parallel_for(pool, count, shad_sdl_create_entry, &job);\n"
+        "    else for (i = 0; i < count; ++i) shad_sdl_create_entry(&job, i);\n"
+        "    for (i = 0; i < count; ++i)\n"
+        "        if (!out[i].pipeline) return false;\n"
+        "    return true;\n"
+        "}\n"
+        "#endif\n");
+
+    /* the table, in slot order */
+    shad__writer_print(&code, "#define %s_COUNT %i\n", r, n);
+    shad__writer_print(&code, "static const ShadShaderEntry %s[%i] = {\n", r, n);
+    for (i = 0; i < n; ++i) {
+        const char *name = entries[entry_of_slot[i]].name;
+        shad__writer_print(&code, "    {\"%s\", &shad_sdl_vertex_shader_%s, &shad_sdl_fragment_shader_%s, &shad_sdl_pipeline_%s, %s},\n",
+            name, name, name, name, shad__hex64(hex, entries[entry_of_slot[i]].hash));
+    }
+    shad__writer_print(&code, "};\n");
+
+    /* the perfect hash, see shad__registry_build() */
+    shad__writer_print(&code, "static SHAD_CONSTEXPR_DATA Uint32 %s__displacements[%i] = {", r, num_buckets);
+    for (i = 0; i < num_buckets; ++i)
+        shad__writer_print(&code, "%s%xu,", i % 8 ? " " : "\n    ", displacements[i]);
+    shad__writer_print(&code, "\n};\n");
+    shad__writer_print(&code,
+        "/* where the entry for name is, if there is one */\n"
+        "static SHAD_CONSTEXPR_FN int %s_slot(const char *name) {\n"
+        "    Uint64 h = shad_name_hash(name);\n"
+        "    Uint32 d = %s__displacements[(Uint32)h %% %iu];\n"
+        "    return (int)((Uint32)(((Uint32)(h >> 32) ^ d) * 0x9e3779b1u) %% %iu);\n"
+        "}\n"
+        "/* the entry for name, or NULL */\n"
+        "static inline const ShadShaderEntry* %s_find(const char *name) {\n"
+        "    const ShadShaderEntry *e = &%s[%s_slot(name)];\n"
+        "    return SDL_strcmp(e->name, name) ? NULL : e;\n"
+        "}\n"
+        "/* creates every shader and pipeline in the table, out[i] is for %s[i], see shad_sdl_create_all() */\n"
+        "static inline bool %s_create_all(SDL_GPUDevice *device, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated out[%i]) {\n"
+        "    return shad_sdl_create_all(device, %s, %i, parallel_for, pool, callbacks, out);\n"
+        "}\n",
+        r, r, num_buckets, n, r, r, r, r, r, n, r, n);
+
+    free(hashes);
+    free(displacements);
+    free(entry_of_slot);
+    *code_out = code.buf;
+    *code_len_out = code.len;
+    return 1;
+}
+
+void shad_sdl_c_writer_end(ShadSdlCWriter *w) {
+    shad__module_table_free((ShadModuleTable*)w->modules);
+    free(w->entries);
+    w->modules = NULL;
+    w->entries = NULL;
+}
+
+#endif /* SHAD_NO_COMPILER */
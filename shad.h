@@ -19,16 +19,98 @@ See README.md for full documentation, but here's a quick overview:
 
     shad_compile()
         Compile a shader. free with shad_compilation_free()
+        Not available if SHAD_NO_COMPILER is defined
 
     shad_compilation_serialize()
         Serialize a compilation. data is freed when you call shad_compilation_free()
 
+    shad_compilation_serialize_compressed()
+        Same as shad_compilation_serialize(), but the SPIRV is stored in a compact encoding (usually less than half the size)
+        that shad_compilation_deserialize() decodes
+
     shad_compilation_deserialize()
         Deserialize a compilation. free with shad_compilation_free()
 
+    shad_compilation_deserialize_view()
+        Deserialize a compilation without copying the SPIRV, it points into your buffer instead.
+        The buffer must be 4-byte aligned and outlive the compilation. free with shad_compilation_free()
+        The checksum isn't verified so loading stays cheap, use shad_compilation_verify() for that
+
+    shad_compilation_verify()
+        Verify the checksum of serialized data. Call it once when you load data that may be corrupt
+
+    shad_compilation_compact()
+        Repack what's needed at runtime (SPIRV, vertex layout, pipeline state) into one tight allocation,
+        dropping the GLSL, identifier strings and code locations. Handy if you keep lots of compilations around
+
+    shad_compilation_hash()
+        Stable 64-bit hash of a compilation, the same on every platform and for serialized/compacted copies.
+        Optionally also gives you separate hashes of each stage's SPIRV and of the pipeline state
+
     shad_compilation_free()
         Free a compilation
 
+#### Pack API (shad_pack_* functions)
+
+    Store many compilations in one file, and load them individually at runtime.
+
+    shad_pack_writer_begin()
+        Start writing a pack file
+
+    shad_pack_writer_add()
+        Add a compilation under a name. Identical SPIRV modules are only stored once.
+        Set writer.compress_spirv to store the SPIRV in a compact encoding.
+        The compilation isn't needed afterwards, so you can free it right away
+
+    shad_pack_writer_end()
+        Finish the pack file. Returns false if anything failed along the way
+
+    shad_pack_open()
+        Memory map a pack file. Nothing is decoded until you ask for it. close with shad_pack_close()
+
+    shad_pack_open_memory()
+        Same as shad_pack_open(), but for a pack you've already loaded. The memory must outlive the pack
+
+    shad_pack_get()
+        Get a compilation by name. The SPIRV points into the pack, so free the compilation
+        with shad_compilation_free() before you close the pack
+
+    shad_pack_find(), shad_pack_name(), shad_pack_get_index()
+        Look up, name and get entries by index, 0 to pack.num_entries-1
+
+    shad_pack_close()
+        Close a pack
+
+    shad_pack_loader_start()
+        Start a thread that decodes pack entries in the background. stop with shad_pack_loader_stop()
+        Not available if SHAD_NO_THREADS is defined
+
+    shad_pack_loader_request()
+        Queue an entry for decoding. Higher priorities are decoded first, equal priorities in request order
+
+    shad_pack_loader_poll()
+        Get a finished entry if there is one, without blocking
+
+    shad_pack_loader_wait()
+        Get a finished entry, blocking until one is done. Returns false if nothing is queued
+
+    shad_pack_loader_stop()
+        Stop the thread, and free all entries that weren't picked up
+
+#### Object file API (shad_elf_writer_* functions)
+
+    shad_elf_writer_begin()
+        Start writing a relocatable ELF object (.o) with the SPIRV of many compilations in .rodata.
+        Set writer.machine after this to target something other than the host
+
+    shad_elf_writer_add()
+        Add the SPIRV of a compilation as the global symbols shad__spirv_vertex_code_<name> and
+        shad__spirv_fragment_code_<name>, the arrays that shad_sdl_serialize_to_c_embed() with
+        SHAD_EMBED_INCBIN declares. Link the object and include that C code, and you never compile the SPIRV
+
+    shad_elf_writer_end()
+        Finish the object file. Returns false if anything failed along the way
+
 #### SDL3 API (shad_sdl_* functions)
 
     This is the main API for using shad with SDL3.
@@ -38,6 +120,39 @@ See README.md for full documentation, but here's a quick overview:
             static const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_<name> = {...};
             static const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_<name> = {...};
             static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_<name> = {...};
+            static const Uint64 shad_hash_<name>, shad_vertex_spirv_hash_<name>, shad_fragment_spirv_hash_<name>, shad_pipeline_hash_<name>;
+        Not available if SHAD_NO_COMPILER is defined
+
+    shad_sdl_serialize_to_c_embed()
+        Same as shad_sdl_serialize_to_c(), but you choose how the SPIRV is embedded (see ShadEmbedMode).
+        Large SPIRV arrays are slow to compile, the other modes are a lot faster.
+        Not available if SHAD_NO_COMPILER is defined
+
+    shad_sdl_serialize_to_c_split()
+        Same as shad_sdl_serialize_to_c_embed(), but split in two: extern declarations of the create infos for a header,
+        and their definitions for a single .c file. That way every file that includes the header doesn't get its own copy.
+        The definitions need SDL.h and the declarations before them
+        Not available if SHAD_NO_COMPILER is defined
+
+    shad_sdl_c_writer_begin(), shad_sdl_c_writer_add(), shad_sdl_c_writer_end()
+        Write the C code for many compilations, like shad_sdl_serialize_to_c_embed() (or shad_sdl_serialize_to_c_split()
+        with writer.split), but a SPIRV module that's identical to an earlier one isn't written again, the create info
+        points at the earlier array instead. So all the code has to end up in the same program.
+        The code is allocated in the compilation, like with shad_sdl_serialize_to_c()
+        Not available if SHAD_NO_COMPILER is defined
+
+    shad_sdl_c_writer_registry()
+        C code for a table of everything added to the writer so far, and a function that finds an entry by name
+        with a minimal perfect hash, so it's one hash and one string compare:
+            static const ShadShaderEntry <registry_name>[<registry_name>_COUNT] = {{"name", &shad_sdl_vertex_shader_<name>, ...}, ...};
+            static inline const ShadShaderEntry* <registry_name>_find(const char *name);
+        <registry_name>_slot() and shad_name_hash() are constexpr in C++14, so names can be looked up at compile time.
+        The code is owned by the writer. Returns false if nothing was added
+        Not available if SHAD_NO_COMPILER is defined
+
+    shad_serialize_to_asm()
+        Assembly (.S) that defines the SPIRV arrays for SHAD_EMBED_INCBIN, using .incbin "<spirv_path><name>.vert.spv" etc.
+        Not available if SHAD_NO_COMPILER is defined
 
     shad_sdl_fill_vertex_shader()
         Fill SDL_GPUShaderCreateInfo with settings from the vertex shader compilation result
@@ -48,10 +163,31 @@ See README.md for full documentation, but here's a quick overview:
     shad_sdl_fill_pipeline()
         Fill SDL_GPUGraphicsPipelineCreateInfo with settings from the pipeline compilation result
 
+    shad_sdl_fill_pipeline_storage()
+        Same as shad_sdl_fill_pipeline(), but the arrays are written to a ShadSdlPipelineStorage that you own.
+        Doesn't allocate or modify the compilation, so it's fine to call repeatedly and from any thread.
+        Returns false if the compilation doesn't fit in the storage (see SHAD_SDL_MAX_*)
+
+    shad_sdl_registry_init()
+        Set up a registry that creates shaders and pipelines on a device, sharing identical ones. destroy with shad_sdl_registry_destroy()
+
+    shad_sdl_registry_acquire()
+        Get the pipeline for a compilation. If a compilation with the same content was acquired before, you get the same
+        pipeline back, and shader stages are shared between pipelines too. The compilation can be freed afterwards
+
+    shad_sdl_registry_release()
+        Release a pipeline you acquired. It's destroyed (along with any shaders nothing else uses) when the last user releases it.
+        The registry still remembers it though, entries are never evicted, so its memory grows with the number of
+        distinct pipelines you ever acquired until shad_sdl_registry_destroy()
+
+    shad_sdl_registry_destroy()
+        Release everything in the registry
+
 
     NOTE: Any arrays that have to be allocated to fill the info structs will be bound to ShadCompilation,
         and will be destroyed when you call shad_compilation_free().
         In short, only call shad_compilation_free() once you are done with the create info structs.
+        (shad_sdl_fill_pipeline_storage() is the exception, its arrays live in your ShadSdlPipelineStorage)
 
     NOTE: These functions will memzero the structs, so if you want to override some settings
         you must do so _after_ the call.
@@ -180,6 +316,14 @@ typedef enum ShadPrimitive {
     SHAD_PRIMITIVE_POINT_LIST
 } ShadPrimitive;
 
+/* how often a sampler, image, buffer or uniform changes, e.g. @uniform(per_frame). Resources without one are per draw */
+typedef enum ShadFrequency {
+    SHAD_FREQUENCY_PER_FRAME,
+    SHAD_FREQUENCY_PER_MATERIAL,
+    SHAD_FREQUENCY_PER_DRAW,
+    SHAD_FREQUENCY_COUNT
+} ShadFrequency;
+
 typedef struct ShadCodeLocation {
     char *path;
     char *start;
@@ -229,6 +373,15 @@ typedef struct ShadVertexInputBuffer {
     int stride;
 } ShadVertexInputBuffer;
 
+/* how many resources of each kind there are per ShadFrequency. The slots of a kind are ordered by frequency,
+   so e.g. the per material samplers come right after the samplers[SHAD_FREQUENCY_PER_FRAME] per frame ones */
+typedef struct ShadResourceFrequencies {
+    int samplers[SHAD_FREQUENCY_COUNT];
+    int images[SHAD_FREQUENCY_COUNT];
+    int buffers[SHAD_FREQUENCY_COUNT];
+    int uniforms[SHAD_FREQUENCY_COUNT];
+} ShadResourceFrequencies;
+
 typedef struct ShadCompilation {
     /* vertex shader info */
     char *vertex_code;
@@ -244,6 +397,7 @@ typedef struct ShadCompilation {
     int num_vertex_images;
     int num_vertex_buffers;
     int num_vertex_uniforms;
+    ShadResourceFrequencies vertex_frequencies;
 
     /* fragment shader info */
     ShadBool has_fragment_shader;
@@ -257,6 +411,7 @@ typedef struct ShadCompilation {
     int num_fragment_images;
     int num_fragment_buffers;
     int num_fragment_uniforms;
+    ShadResourceFrequencies fragment_frequencies;
 
     /* depth */
     ShadCodeLocation depth_code_location;
@@ -275,19 +430,247 @@ typedef struct ShadCompilation {
     /* multisampling. Valid values are 1,2,4,8 */
     int multisample_count;
 
+    /* the SDL arrays for shad_sdl_fill_pipeline(), already translated when the compilation was serialized.
+       Only set for deserialized compilations. It isn't updated if you change vertex_inputs, vertex_input_buffers
+       or fragment_outputs, so set it to NULL when you do */
+    const char *sdl_pipeline;
+
     /* private stuff */
     void *arena;
 } ShadCompilation;
 
+/* see shad_compilation_hash() */
+typedef struct ShadCompilationHash {
+    /* vertex/fragment SPIRV. fragment_spirv is 0 if there's no fragment shader */
+    uint64_t vertex_spirv;
+    uint64_t fragment_spirv;
+    /* vertex layout, fragment output formats, blending, depth, culling, primitive and multisampling */
+    uint64_t pipeline;
+    /* all of the above, the shader resource counts and their update frequencies, same as shad_compilation_hash() returns */
+    uint64_t all;
+} ShadCompilationHash;
+
+/* how shad_sdl_serialize_to_c_embed() puts the SPIRV in the generated code */
+typedef enum ShadEmbedMode {
+    /* static const unsigned shad__spirv_vertex_code_<name>[] = {0x07230203,...}; Works everywhere, but is slow to compile */
+    SHAD_EMBED_ARRAY,
+    /* a string literal, "\x03\x02\x23\x07...". Much faster to compile, but MSVC can't handle strings over 64KB */
+    SHAD_EMBED_STRING,
+    /* #embed "<spirv_path><name>.vert.spv" (C23), you write the SPIRV to those files */
+    SHAD_EMBED_C23,
+    /* extern declarations, defined by the assembly from shad_serialize_to_asm(). GCC/Clang-compatible assemblers only */
+    SHAD_EMBED_INCBIN
+} ShadEmbedMode;
+
+/* writes the C code for many compilations, with identical SPIRV modules only written once */
+typedef struct ShadSdlCWriter {
+    /* set after shad_sdl_c_writer_begin(), see shad_sdl_serialize_to_c_embed() and shad_sdl_serialize_to_c_split() */
+    ShadEmbedMode embed;
+    const char *spirv_path;
+    ShadBool split;
+    /* also write C++ for each compilation: a tag type shad::shaders::<name> with the resource counts and a constexpr
+       pipeline create info, and the structs of its slots as shad::vertex_uniform<shaders::<name>, slot>::type etc.
+       It's inside #ifdef __cplusplus, so the output still works as C */
+    ShadBool cpp;
+    /* also write shad_bind_<name>_per_frame() etc for each compilation, which push and bind the resources of that
+       frequency through a ShadSdlBindCache, skipping whatever is already pushed or bound */
+    ShadBool bind_helpers;
+    /* unique SPIRV modules written */
+    int num_modules;
+    /* SPIRV bytes that weren't written because an identical module was written before */
+    int bytes_deduplicated;
+
+    /* private stuff */
+    void *modules;
+    void *entries;
+    int num_entries;
+    int entries_cap;
+} ShadSdlCWriter;
+
+#ifndef SHAD_NO_COMPILER
 ShadBool shad_compile(const char *path, ShadOutputFormat output_format, ShadCompilation *result);
+void shad_sdl_serialize_to_c(ShadCompilation *sc, const char *name, char **code_out, int *code_len_out);
+void shad_sdl_serialize_to_c_embed(ShadCompilation *sc, const char *name, ShadEmbedMode mode, const char *spirv_path, char **code_out, int *code_len_out);
+void shad_sdl_serialize_to_c_split(ShadCompilation *sc, const char *name, ShadEmbedMode mode, const char *spirv_path, char **declarations_out, int *declarations_len_out, char **definitions_out, int *definitions_len_out);
+void shad_serialize_to_asm(ShadCompilation *sc, const char *name, const char *spirv_path, char **code_out, int *code_len_out);
+void shad_sdl_c_writer_begin(ShadSdlCWriter *writer);
+void shad_sdl_c_writer_add(ShadSdlCWriter *writer, const char *name, ShadCompilation *compilation, char **code_out, int *code_len_out, char **definitions_out, int *definitions_len_out);
+ShadBool shad_sdl_c_writer_registry(ShadSdlCWriter *writer, const char *registry_name, char **code_out, int *code_len_out);
+void shad_sdl_c_writer_end(ShadSdlCWriter *writer);
+#endif /* SHAD_NO_COMPILER */
 void     shad_compilation_serialize(ShadCompilation *compilation, char **bytes_out, int *num_bytes_out);
+void     shad_compilation_serialize_compressed(ShadCompilation *compilation, char **bytes_out, int *num_bytes_out);
 ShadBool shad_compilation_deserialize(char *bytes, int num_bytes, ShadCompilation *result);
+ShadBool shad_compilation_deserialize_view(const char *bytes, int num_bytes, ShadCompilation *result);
+ShadBool shad_compilation_verify(const char *bytes, int num_bytes);
+void     shad_compilation_compact(ShadCompilation *compilation);
+uint64_t shad_compilation_hash(const ShadCompilation *compilation, ShadCompilationHash *hash_out);
 void     shad_compilation_free(ShadCompilation*);
-void shad_sdl_serialize_to_c(ShadCompilation *sc, const char *name, char **code_out, int *code_len_out);
+
+/* writes many compilations into one pack file */
+typedef struct ShadPackWriter {
+    int num_entries;
+    /* SPIRV bytes that weren't written because an identical module was already in the pack */
+    int bytes_deduplicated;
+    /* store SPIRV in a compact encoding, decoded by shad_pack_get(). Set after shad_pack_writer_begin() */
+    ShadBool compress_spirv;
+
+    /* private stuff */
+    void *file;
+    void *arena;
+    void *entries;
+    int entries_cap;
+    char *names;
+    int names_len;
+    int names_cap;
+    void *modules;
+    int num_modules;
+    int *module_slots;
+    int module_slots_cap;
+    int size;
+    ShadBool failed;
+} ShadPackWriter;
+
+/* a pack file, opened for reading */
+typedef struct ShadPack {
+    int num_entries;
+
+    /* private stuff */
+    const char *data;
+    int size;
+    ShadBool mapped;
+} ShadPack;
+
+ShadBool    shad_pack_writer_begin(ShadPackWriter *writer, const char *path);
+ShadBool    shad_pack_writer_add(ShadPackWriter *writer, const char *name, ShadCompilation *compilation);
+ShadBool    shad_pack_writer_end(ShadPackWriter *writer);
+ShadBool    shad_pack_open(const char *path, ShadPack *pack);
+ShadBool    shad_pack_open_memory(const char *bytes, int num_bytes, ShadPack *pack);
+int         shad_pack_find(ShadPack *pack, const char *name);
+const char* shad_pack_name(ShadPack *pack, int index);
+ShadBool    shad_pack_get(ShadPack *pack, const char *name, ShadCompilation *result);
+ShadBool    shad_pack_get_index(ShadPack *pack, int index, ShadCompilation *result);
+void        shad_pack_close(ShadPack *pack);
+
+#ifndef SHAD_NO_THREADS
+/* a finished request from the pack loader */
+typedef struct ShadPackLoadResult {
+    /* false if the entry couldn't be decoded */
+    ShadBool ok;
+    /* entry index in the pack */
+    int index;
+    /* as passed to shad_pack_loader_request() */
+    void *userdata;
+    /* free with shad_compilation_free() */
+    ShadCompilation compilation;
+} ShadPackLoadResult;
+
+/* decodes pack entries on a background thread */
+typedef struct ShadPackLoader {
+    /* private stuff */
+    ShadPack *pack;
+    void *sync;
+    void *requests;
+    int num_requests;
+    int requests_cap;
+    unsigned seq;
+    void *volatile completed;
+    void *delivered;
+    int num_outstanding;
+    ShadBool quit;
+} ShadPackLoader;
+
+ShadBool shad_pack_loader_start(ShadPackLoader *loader, ShadPack *pack);
+ShadBool shad_pack_loader_request(ShadPackLoader *loader, const char *name, int priority, void *userdata);
+ShadBool shad_pack_loader_poll(ShadPackLoader *loader, ShadPackLoadResult *result);
+ShadBool shad_pack_loader_wait(ShadPackLoader *loader, ShadPackLoadResult *result);
+void     shad_pack_loader_stop(ShadPackLoader *loader);
+#endif /* SHAD_NO_THREADS */
+
+typedef enum ShadElfMachine {
+    /* the architecture shad was compiled for, x86_64 if it isn't one of the below */
+    SHAD_ELF_MACHINE_HOST,
+    SHAD_ELF_MACHINE_X86_64,
+    SHAD_ELF_MACHINE_AARCH64,
+    SHAD_ELF_MACHINE_RISCV64
+} ShadElfMachine;
+
+/* writes SPIRV to a 64-bit little-endian ELF object */
+typedef struct ShadElfWriter {
+    int num_symbols;
+    /* SPIRV bytes that weren't written because an identical module was already in the object */
+    int bytes_deduplicated;
+    /* set after shad_elf_writer_begin() */
+    ShadElfMachine machine;
+
+    /* private stuff */
+    void *file;
+    void *arena;
+    void *modules;
+    char *symbols;
+    int symbols_len;
+    int symbols_cap;
+    char *names;
+    int names_len;
+    int names_cap;
+    int size;
+    ShadBool failed;
+} ShadElfWriter;
+
+ShadBool shad_elf_writer_begin(ShadElfWriter *writer, const char *path);
+ShadBool shad_elf_writer_add(ShadElfWriter *writer, const char *name, ShadCompilation *compilation);
+ShadBool shad_elf_writer_end(ShadElfWriter *writer);
 #ifdef SDL_VERSION
+
+/* capacity of ShadSdlPipelineStorage. Fixed so every translation unit agrees on its layout; these cover SDL's own limits */
+#define SHAD_SDL_MAX_VERTEX_BUFFERS 16
+#define SHAD_SDL_MAX_VERTEX_ATTRIBUTES 16
+#define SHAD_SDL_MAX_COLOR_TARGETS 8
+
+/* caller-owned storage for the arrays SDL_GPUGraphicsPipelineCreateInfo points to. See shad_sdl_fill_pipeline_storage() */
+typedef struct ShadSdlPipelineStorage {
+    SDL_GPUVertexBufferDescription vertex_buffer_descriptions[SHAD_SDL_MAX_VERTEX_BUFFERS];
+    SDL_GPUVertexAttribute vertex_attributes[SHAD_SDL_MAX_VERTEX_ATTRIBUTES];
+    SDL_GPUColorTargetDescription color_target_descriptions[SHAD_SDL_MAX_COLOR_TARGETS];
+} ShadSdlPipelineStorage;
+
 void shad_sdl_fill_vertex_shader(struct SDL_GPUShaderCreateInfo *info, ShadCompilation *sc);
 void shad_sdl_fill_fragment_shader(struct SDL_GPUShaderCreateInfo *info, ShadCompilation *sc);
 void shad_sdl_fill_pipeline(struct SDL_GPUGraphicsPipelineCreateInfo *info, ShadCompilation *sc);
+ShadBool shad_sdl_fill_pipeline_storage(struct SDL_GPUGraphicsPipelineCreateInfo *info, ShadSdlPipelineStorage *storage, const ShadCompilation *sc);
+
+/* creates each distinct shader and pipeline only once. See shad_sdl_registry_acquire() */
+typedef struct ShadSdlRegistry {
+    /* optional, called instead of SDL_CreateGPUShader() etc. on the device, e.g. to tweak the create infos
+       or to name the objects. Set after shad_sdl_registry_init() */
+    SDL_GPUShader* (*create_shader)(void *userdata, const SDL_GPUShaderCreateInfo *info);
+    SDL_GPUGraphicsPipeline* (*create_pipeline)(void *userdata, const SDL_GPUGraphicsPipelineCreateInfo *info);
+    void (*release_shader)(void *userdata, SDL_GPUShader *shader);
+    void (*release_pipeline)(void *userdata, SDL_GPUGraphicsPipeline *pipeline);
+    void *userdata;
+
+    /* live objects */
+    int num_shaders;
+    int num_pipelines;
+    /* how many times an existing object was handed out instead of creating a new one */
+    int num_reused_shaders;
+    int num_reused_pipelines;
+
+    /* private stuff */
+    SDL_GPUDevice *device;
+    void *entries;
+    int num_entries;
+    int entries_cap;
+    int *key_slots;
+    int *object_slots;
+    int object_slots_used;
+    int slots_cap;
+} ShadSdlRegistry;
+
+void shad_sdl_registry_init(ShadSdlRegistry *reg, SDL_GPUDevice *device);
+SDL_GPUGraphicsPipeline* shad_sdl_registry_acquire(ShadSdlRegistry *reg, ShadCompilation *sc);
+void shad_sdl_registry_release(ShadSdlRegistry *reg, SDL_GPUGraphicsPipeline *pipeline);
+void shad_sdl_registry_destroy(ShadSdlRegistry *reg);
 #endif /* SDL_VERSION */
 
 #ifdef __cplusplus
@@ -0,0 +1,131 @@
+#ifndef CM_SHADER_HPP
+#define CM_SHADER_HPP
+
+/*
+
+C++ layer over shad.h (C++20)
+=============================
+
+shad::Compilation owns a ShadCompilation and frees it when it goes out of scope. It can be moved but not copied,
+since copying the C struct would alias its memory.
+
+    auto sc = shad::Compilation::compile("my_shader.shader");
+    if (!sc) return;
+    for (const ShadVertexInput &in : sc->vertex_inputs()) ...
+    std::span<const uint32_t> spirv = sc->vertex_spirv();
+
+The C struct is always available through ->/get(), so everything in shad.h can still be used directly,
+e.g. shad_sdl_fill_pipeline(&info, sc->get()).
+
+*/
+
+#include "shad.h"
+
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+
+namespace shad {
+
+class Compilation {
+public:
+    Compilation() noexcept { std::memset(&c_, 0, sizeof(c_)); }
+
+    /* takes ownership of a compilation from the C API */
+    explicit Compilation(const ShadCompilation &c) noexcept : c_(c) {}
+
+    Compilation(Compilation &&other) noexcept : c_(other.release()) {}
+
+    Compilation& operator=(Compilation &&other) noexcept {
+        if (this != &other) {
+            reset();
+            c_ = other.release();
+        }
+        return *this;
+    }
+
+    Compilation(const Compilation&) = delete;
+    Compilation& operator=(const Compilation&) = delete;
+
+    ~Compilation() { reset(); }
+
+#ifndef SHAD_NO_COMPILER
+    static std::optional<Compilation> compile(std::string_view path, ShadOutputFormat format = SHAD_OUTPUT_FORMAT_SDL) {
+        std::string p(path);
+        ShadCompilation c;
+        if (!shad_compile(p.c_str(), format, &c)) return std::nullopt;
+        return Compilation(c);
+    }
+#endif
+
+    static std::optional<Compilation> deserialize(std::span<const char> bytes) {
+        ShadCompilation c;
+        if (!shad_compilation_deserialize(const_cast<char*>(bytes.data()), (int)bytes.size(), &c)) return std::nullopt;
+        return Compilation(c);
+    }
+
+    /* the SPIRV points into bytes, see shad_compilation_deserialize_view() */
+    static std::optional<Compilation> deserialize_view(std::span<const char> bytes) {
+        ShadCompilation c;
+        if (!shad_compilation_deserialize_view(bytes.data(), (int)bytes.size(), &c)) return std::nullopt;
+        return Compilation(c);
+    }
+
+    /* the data is owned by the compilation */
+    std::span<const char> serialize() {
+        char *bytes;
+        int num_bytes;
+        shad_compilation_serialize(&c_, &bytes, &num_bytes);
+        return {bytes, (size_t)num_bytes};
+    }
+
+    std::span<const char> serialize_compressed() {
+        char *bytes;
+        int num_bytes;
+        shad_compilation_serialize_compressed(&c_, &bytes, &num_bytes);
+        return {bytes, (size_t)num_bytes};
+    }
+
+    void compact() { shad_compilation_compact(&c_); }
+
+    uint64_t hash(ShadCompilationHash *parts = nullptr) const { return shad_compilation_hash(&c_, parts); }
+
+    std::span<const ShadVertexInput> vertex_inputs() const { return {c_.vertex_inputs, (size_t)c_.num_vertex_inputs}; }
+    std::span<const ShadVertexInputBuffer> vertex_input_buffers() const { return {c_.vertex_input_buffers, (size_t)c_.num_vertex_input_buffers}; }
+    std::span<const ShadFragmentOutput> fragment_outputs() const { return {c_.fragment_outputs, (size_t)c_.num_fragment_outputs}; }
+
+    /* SPIRV, as words */
+    std::span<const uint32_t> vertex_spirv() const { return {(const uint32_t*)c_.spirv_vertex_code, (size_t)c_.spirv_vertex_code_size / 4}; }
+    std::span<const uint32_t> fragment_spirv() const { return {(const uint32_t*)c_.spirv_fragment_code, (size_t)c_.spirv_fragment_code_size / 4}; }
+
+    ShadCompilation* get() noexcept { return &c_; }
+    const ShadCompilation* get() const noexcept { return &c_; }
+    ShadCompilation* operator->() noexcept { return &c_; }
+    const ShadCompilation* operator->() const noexcept { return &c_; }
+
+    /* false if empty, e.g. after being moved from */
+    explicit operator bool() const noexcept { return c_.arena != nullptr; }
+
+    /* gives up ownership, free the result with shad_compilation_free() */
+    ShadCompilation release() noexcept {
+        ShadCompilation c = c_;
+        std::memset(&c_, 0, sizeof(c_));
+        return c;
+    }
+
+    void reset() noexcept {
+        shad_compilation_free(&c_);
+        std::memset(&c_, 0, sizeof(c_));
+    }
+
+private:
+    ShadCompilation c_;
+};
+
+} /* namespace shad */
+
+#endif /* CM_SHADER_HPP */
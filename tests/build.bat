@@ -1,2 +1,4 @@
-shad.exe sdl3 kitchensink.shader > kitchensink.h
-cl -I%VULKAN_SDK%\Include -I. -I.. -I../examples test.c -Fetest.exe -MD -link -libpath:%VULKAN_SDK%\Lib
+shad.exe sdl3 --registry shad_test_shaders --bind-helpers kitchensink.shader > kitchensink.h
+shad.exe cpp --registry shad_test_shaders kitchensink.shader import.shader > kitchensink.hpp
+cl -I%VULKAN_SDK%\Include -I. -I.. -I../examples test.c -Fetest.exe -MD -link -libpath:%VULKAN_SDK%\Lib -libpath:../examples SDL3.lib
+cl -I%VULKAN_SDK%\Include -I. -I.. -I../examples test_hpp.cpp -std:c++20 -EHsc -Fetest_hpp.exe -MD -link -libpath:%VULKAN_SDK%\Lib -libpath:../examples SDL3.lib
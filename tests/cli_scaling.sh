@@ -0,0 +1,44 @@
+#!/bin/bash
+# Checks that the CLI's memory use stays flat as the number of input shaders grows, for each kind of output.
+# Usage: ./cli_scaling.sh [path/to/shad]
+SHAD=${1:-../cli/shad}
+DIR=$(mktemp -d)
+trap 'rm -rf "$DIR"' EXIT
+
+# GNU time, for measuring peak resident memory
+TIME=${TIME:-/usr/bin/time}
+if ! [ -x "$TIME" ] || ! "$TIME" -f "%M" true >/dev/null 2>&1; then
+    echo "SKIP: GNU time not found, set TIME=path/to/time"
+    exit 0
+fi
+
+# unique shaders with a few KB of SPIRV each, so anything kept per module shows up
+body=""
+for ((j = 0; j < 250; ++j)); do body+="    v += vec4(N.$j);"$'\n'; done
+for n in 100 10000; do
+    mkdir -p "$DIR/$n"
+    for ((i = 0; i < n; ++i)); do
+        printf '@vert\n@in() vec3 pos;\n@uniform {vec4 u;};\nvoid main() {\n    vec4 v = vec4(pos, 1);\n%s    gl_Position = v + u;\n}\n@end\n@frag\n@out(format=rgba8) vec4 color;\nvoid main() {color = vec4(1);}\n@end\n' "${body//N/$i}" > "$DIR/$n/s$i.shader"
+    done
+done
+
+fail=0
+for mode in "sdl3" "sdl3 --split" "sdl3 --shards 4" "sdl3 --emit pack"; do
+    first=0
+    for n in 100 10000; do
+        rm -f "$DIR"/out*
+        stats=$(cd "$DIR/$n" && "$TIME" -f "%e %M" "$SHAD" $mode -o "$DIR/out" $(ls) 2>&1 >/dev/null | tail -n1)
+        [ -f "$DIR/out" ] || { echo "FAIL: $mode: $n shaders didn't compile"; exit 1; }
+        read secs rss <<< "$stats"
+        printf '%-18s %6i shaders: %8ss %8i KB peak\n' "$mode" $n $secs $rss
+        [ $first -eq 0 ] && first=$rss
+    done
+
+    # allow some growth for the argument list itself, but nothing proportional to the compiled output
+    if [ $((rss * 4)) -gt $((first * 5)) ]; then
+        echo "FAIL: $mode: peak memory grew from $first KB to $rss KB"
+        fail=1
+    fi
+done
+[ $fail -eq 0 ] && echo "OK"
+exit $fail
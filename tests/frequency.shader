@@ -0,0 +1,26 @@
+@vert
+
+    @in() vec3 position;
+
+    @uniform {mat4 model;};
+    @uniform(per_frame) {mat4 view_projection;};
+
+    void main() {gl_Position = view_projection * model * vec4(position, 1);}
+
+@end
+
+@frag
+
+    @out(format=rgba8) vec4 color;
+
+    @sampler sampler2D detail;
+    @sampler(per_material) sampler2D albedo;
+    @sampler(per_frame) sampler2D shadow_map;
+    @image(format=rgba8, per_frame) readonly image2D lut;
+    @image(format=rgba8) readonly image2D mask;
+    @buffer(per_material) readonly {vec4 palette[];};
+    @uniform(per_material) {vec4 tint;};
+
+    void main() {color = texture(albedo, vec2(0)) * tint;}
+
+@end
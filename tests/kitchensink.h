@@ -1,5 +1,84 @@
-static const unsigned shad__spirv_vertex_code_kitchensink[364] = {0x7230203,0x10000,0x8000b,0x28,0x0,0x20011,0x1,0x6000b,0x1,0x4c534c47,0x6474732e,0x3035342e,0x0,0x3000e,0x0,0x1,0x9000f,0x0,0x4,0x6e69616d,0x0,0xd,0x17,0x18,0x1a,0x30003,0x2,0x1c2,0x40005,0x4,0x6e69616d,0x0,0x60005,0xb,0x505f6c67,0x65567265,0x78657472,0x0,0x60006,0xb,0x0,0x505f6c67,0x7469736f,0x6e6f69,0x70006,0xb,0x1,0x505f6c67,0x746e696f,0x657a6953,0x0,0x70006,0xb,0x2,0x435f6c67,0x4470696c,0x61747369,0x65636e,0x70006,0xb,0x3,0x435f6c67,0x446c6c75,0x61747369,0x65636e,0x30005,0xd,0x0,0x30005,0x17,0x3076,0x30005,0x18,0x3176,0x30005,0x1a,0x3276,0x30005,0x1e,0x3173,0x40005,0x1f,0x66667542,0x327265,0x40006,0x1f,0x0,0x3162,0x30005,0x21,0x0,0x30005,0x24,0x3174,0x50005,0x25,0x66696e55,0x306d726f,0x0,0x40006,0x25,0x0,0x3175,0x30005,0x27,0x0,0x30047,0xb,0x2,0x50048,0xb,0x0,0xb,0x0,0x50048,0xb,0x1,0xb,0x1,0x50048,0xb,0x2,0xb,0x3,0x50048,0xb,0x3,0xb,0x4,0x40047,0x17,0x1e,0x0,0x40047,0x18,0x1e,0x1,0x40047,0x1a,0x1e,0x2,0x40047,0x1e,0x21,0x0,0x40047,0x1e,0x22,0x0,0x30047,0x1f,0x3,0x40048,0x1f,0x0,0x19,0x50048,0x1f,0x0,0x23,0x0,0x30047,0x21,0x19,0x40047,0x21,0x21,0x2,0x40047,0x21,0x22,0x0,0x30047,0x24,0x18,0x40047,0x24,0x21,0x1,0x40047,0x24,0x22,0x0,0x30047,0x25,0x2,0x50048,0x25,0x0,0x23,0x0,0x40047,0x27,0x21,0x0,0x40047,0x27,0x22,0x1,0x20013,0x2,0x30021,0x3,0x2,0x30016,0x6,0x20,0x40017,0x7,0x6,0x4,0x40015,0x8,0x20,0x0,0x4002b,0x8,0x9,0x1,0x4001c,0xa,0x6,0x9,0x6001e,0xb,0x7,0x6,0xa,0xa,0x40020,0xc,0x3,0xb,0x4003b,0xc,0xd,0x3,0x40015,0xe,0x20,0x1,0x4002b,0xe,0xf,0x0,0x4002b,0x6,0x10,0x0,0x4002b,0x6,0x11,0x3f800000,0x7002c,0x7,0x12,0x10,0x10,0x10,0x11,0x40020,0x13,0x3,0x7,0x40017,0x15,0x6,0x3,0x40020,0x16,0x1,0x15,0x4003b,0x16,0x17,0x1,0x4003b,0x16,0x18,0x1,0x40020,0x19,0x1,0x7,0x4003b,0x19,0x1a,0x1,0x90019,0x1b,0x6,0x1,0x0,0x0,0x0,0x1,0x0,0x3001b,0x1c,0x1b,0x40020,0x1d,0x0,0x1c,0x4003b,0x1d,0x1e,0x0,0x3001e,0x1f,0xe,0x40020,0x20,0x2,0x1f,0x4003b,0x20,0x21,0x2,0x90019,0x22,0x6,0x1,0x0,0x0,0x0,0x2,0x4,0x40020,0x23,0x0,0x22,0x4003b,0x23,0x24,0x0,0x3001e,0x25,0xe,0x40020,0x26,0x2,0x25,0x4003b,0x26,0x27,0x2,0x50036,0x2,0x4,0x0,0x3,0x200f8,0x5,0x50041,0x13,0x14,0xd,0xf,0x3003e,0x14,0x12,0x100fd,0x10038,};
-static const unsigned shad__spirv_fragment_code_kitchensink[242] = {0x7230203,0x10000,0x8000b,0x1c,0x0,0x20011,0x1,0x20011,0x31,0x6000b,0x1,0x4c534c47,0x6474732e,0x3035342e,0x0,0x3000e,0x0,0x1,0x8000f,0x4,0x4,0x6e69616d,0x0,0x9,0xc,0xd,0x30010,0x4,0x7,0x30003,0x2,0x1c2,0x40005,0x4,0x6e69616d,0x0,0x30005,0x9,0x3066,0x30005,0xc,0x3166,0x30005,0xd,0x3266,0x30005,0x11,0x3273,0x40005,0x13,0x66667542,0x327265,0x40006,0x13,0x0,0x3262,0x30005,0x15,0x0,0x30005,0x18,0x3274,0x50005,0x19,0x66696e55,0x306d726f,0x0,0x40006,0x19,0x0,0x3275,0x30005,0x1b,0x0,0x40047,0x9,0x1e,0x0,0x40047,0xc,0x1e,0x1,0x40047,0xd,0x1e,0x2,0x40047,0x11,0x21,0x0,0x40047,0x11,0x22,0x2,0x30047,0x13,0x3,0x50048,0x13,0x0,0x23,0x0,0x40047,0x15,0x21,0x2,0x40047,0x15,0x22,0x2,0x40047,0x18,0x21,0x1,0x40047,0x18,0x22,0x2,0x30047,0x19,0x2,0x50048,0x19,0x0,0x23,0x0,0x40047,0x1b,0x21,0x0,0x40047,0x1b,0x22,0x3,0x20013,0x2,0x30021,0x3,0x2,0x30016,0x6,0x20,0x40017,0x7,0x6,0x4,0x40020,0x8,0x3,0x7,0x4003b,0x8,0x9,0x3,0x40017,0xa,0x6,0x2,0x40020,0xb,0x3,0xa,0x4003b,0xb,0xc,0x3,0x4003b,0x8,0xd,0x3,0x90019,0xe,0x6,0x1,0x0,0x0,0x0,0x1,0x0,0x3001b,0xf,0xe,0x40020,0x10,0x0,0xf,0x4003b,0x10,0x11,0x0,0x40015,0x12,0x20,0x1,0x3001e,0x13,0x12,0x40020,0x14,0x2,0x13,0x4003b,0x14,0x15,0x2,0x90019,0x16,0x6,0x1,0x0,0x0,0x0,0x2,0x13,0x40020,0x17,0x0,0x16,0x4003b,0x17,0x18,0x0,0x3001e,0x19,0x12,0x40020,0x1a,0x2,0x19,0x4003b,0x1a,0x1b,0x2,0x50036,0x2,0x4,0x0,0x3,0x200f8,0x5,0x100fd,0x10038,};
+static const unsigned shad__spirv_vertex_code_kitchensink[364] = {
+    0x07230203,0x00010000,0x0008000b,0x00000028,0x00000000,0x00020011,0x00000001,0x0006000b,
+    0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+    0x0009000f,0x00000000,0x00000004,0x6e69616d,0x00000000,0x0000000d,0x00000017,0x00000018,
+    0x0000001a,0x00030003,0x00000002,0x000001c2,0x00040005,0x00000004,0x6e69616d,0x00000000,
+    0x00060005,0x0000000b,0x505f6c67,0x65567265,0x78657472,0x00000000,0x00060006,0x0000000b,
+    0x00000000,0x505f6c67,0x7469736f,0x006e6f69,0x00070006,0x0000000b,0x00000001,0x505f6c67,
+    0x746e696f,0x657a6953,0x00000000,0x00070006,0x0000000b,0x00000002,0x435f6c67,0x4470696c,
+    0x61747369,0x0065636e,0x00070006,0x0000000b,0x00000003,0x435f6c67,0x446c6c75,0x61747369,
+    0x0065636e,0x00030005,0x0000000d,0x00000000,0x00030005,0x00000017,0x00003076,0x00030005,
+    0x00000018,0x00003176,0x00030005,0x0000001a,0x00003276,0x00030005,0x0000001e,0x00003173,
+    0x00040005,0x0000001f,0x66667542,0x00327265,0x00040006,0x0000001f,0x00000000,0x00003162,
+    0x00030005,0x00000021,0x00000000,0x00030005,0x00000024,0x00003174,0x00050005,0x00000025,
+    0x66696e55,0x306d726f,0x00000000,0x00040006,0x00000025,0x00000000,0x00003175,0x00030005,
+    0x00000027,0x00000000,0x00030047,0x0000000b,0x00000002,0x00050048,0x0000000b,0x00000000,
+    0x0000000b,0x00000000,0x00050048,0x0000000b,0x00000001,0x0000000b,0x00000001,0x00050048,
+    0x0000000b,0x00000002,0x0000000b,0x00000003,0x00050048,0x0000000b,0x00000003,0x0000000b,
+    0x00000004,0x00040047,0x00000017,0x0000001e,0x00000000,0x00040047,0x00000018,0x0000001e,
+    0x00000001,0x00040047,0x0000001a,0x0000001e,0x00000002,0x00040047,0x0000001e,0x00000021,
+    0x00000000,0x00040047,0x0000001e,0x00000022,0x00000000,0x00030047,0x0000001f,0x00000003,
+    0x00040048,0x0000001f,0x00000000,0x00000019,0x00050048,0x0000001f,0x00000000,0x00000023,
+    0x00000000,0x00030047,0x00000021,0x00000019,0x00040047,0x00000021,0x00000021,0x00000002,
+    0x00040047,0x00000021,0x00000022,0x00000000,0x00030047,0x00000024,0x00000018,0x00040047,
+    0x00000024,0x00000021,0x00000001,0x00040047,0x00000024,0x00000022,0x00000000,0x00030047,
+    0x00000025,0x00000002,0x00050048,0x00000025,0x00000000,0x00000023,0x00000000,0x00040047,
+    0x00000027,0x00000021,0x00000000,0x00040047,0x00000027,0x00000022,0x00000001,0x00020013,
+    0x00000002,0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,
+    0x00000007,0x00000006,0x00000004,0x00040015,0x00000008,0x00000020,0x00000000,0x0004002b,
+    0x00000008,0x00000009,0x00000001,0x0004001c,0x0000000a,0x00000006,0x00000009,0x0006001e,
+    0x0000000b,0x00000007,0x00000006,0x0000000a,0x0000000a,0x00040020,0x0000000c,0x00000003,
+    0x0000000b,0x0004003b,0x0000000c,0x0000000d,0x00000003,0x00040015,0x0000000e,0x00000020,
+    0x00000001,0x0004002b,0x0000000e,0x0000000f,0x00000000,0x0004002b,0x00000006,0x00000010,
+    0x00000000,0x0004002b,0x00000006,0x00000011,0x3f800000,0x0007002c,0x00000007,0x00000012,
+    0x00000010,0x00000010,0x00000010,0x00000011,0x00040020,0x00000013,0x00000003,0x00000007,
+    0x00040017,0x00000015,0x00000006,0x00000003,0x00040020,0x00000016,0x00000001,0x00000015,
+    0x0004003b,0x00000016,0x00000017,0x00000001,0x0004003b,0x00000016,0x00000018,0x00000001,
+    0x00040020,0x00000019,0x00000001,0x00000007,0x0004003b,0x00000019,0x0000001a,0x00000001,
+    0x00090019,0x0000001b,0x00000006,0x00000001,0x00000000,0x00000000,0x00000000,0x00000001,
+    0x00000000,0x0003001b,0x0000001c,0x0000001b,0x00040020,0x0000001d,0x00000000,0x0000001c,
+    0x0004003b,0x0000001d,0x0000001e,0x00000000,0x0003001e,0x0000001f,0x0000000e,0x00040020,
+    0x00000020,0x00000002,0x0000001f,0x0004003b,0x00000020,0x00000021,0x00000002,0x00090019,
+    0x00000022,0x00000006,0x00000001,0x00000000,0x00000000,0x00000000,0x00000002,0x00000004,
+    0x00040020,0x00000023,0x00000000,0x00000022,0x0004003b,0x00000023,0x00000024,0x00000000,
+    0x0003001e,0x00000025,0x0000000e,0x00040020,0x00000026,0x00000002,0x00000025,0x0004003b,
+    0x00000026,0x00000027,0x00000002,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,
+    0x000200f8,0x00000005,0x00050041,0x00000013,0x00000014,0x0000000d,0x0000000f,0x0003003e,
+    0x00000014,0x00000012,0x000100fd,0x00010038,
+};
+static const unsigned shad__spirv_fragment_code_kitchensink[242] = {
+    0x07230203,0x00010000,0x0008000b,0x0000001c,0x00000000,0x00020011,0x00000001,0x00020011,
+    0x00000031,0x0006000b,0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,
+    0x00000000,0x00000001,0x0008000f,0x00000004,0x00000004,0x6e69616d,0x00000000,0x00000009,
+    0x0000000c,0x0000000d,0x00030010,0x00000004,0x00000007,0x00030003,0x00000002,0x000001c2,
+    0x00040005,0x00000004,0x6e69616d,0x00000000,0x00030005,0x00000009,0x00003066,0x00030005,
+    0x0000000c,0x00003166,0x00030005,0x0000000d,0x00003266,0x00030005,0x00000011,0x00003273,
+    0x00040005,0x00000013,0x66667542,0x00327265,0x00040006,0x00000013,0x00000000,0x00003262,
+    0x00030005,0x00000015,0x00000000,0x00030005,0x00000018,0x00003274,0x00050005,0x00000019,
+    0x66696e55,0x306d726f,0x00000000,0x00040006,0x00000019,0x00000000,0x00003275,0x00030005,
+    0x0000001b,0x00000000,0x00040047,0x00000009,0x0000001e,0x00000000,0x00040047,0x0000000c,
+    0x0000001e,0x00000001,0x00040047,0x0000000d,0x0000001e,0x00000002,0x00040047,0x00000011,
+    0x00000021,0x00000000,0x00040047,0x00000011,0x00000022,0x00000002,0x00030047,0x00000013,
+    0x00000003,0x00050048,0x00000013,0x00000000,0x00000023,0x00000000,0x00040047,0x00000015,
+    0x00000021,0x00000002,0x00040047,0x00000015,0x00000022,0x00000002,0x00040047,0x00000018,
+    0x00000021,0x00000001,0x00040047,0x00000018,0x00000022,0x00000002,0x00030047,0x00000019,
+    0x00000002,0x00050048,0x00000019,0x00000000,0x00000023,0x00000000,0x00040047,0x0000001b,
+    0x00000021,0x00000000,0x00040047,0x0000001b,0x00000022,0x00000003,0x00020013,0x00000002,
+    0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,0x00000007,
+    0x00000006,0x00000004,0x00040020,0x00000008,0x00000003,0x00000007,0x0004003b,0x00000008,
+    0x00000009,0x00000003,0x00040017,0x0000000a,0x00000006,0x00000002,0x00040020,0x0000000b,
+    0x00000003,0x0000000a,0x0004003b,0x0000000b,0x0000000c,0x00000003,0x0004003b,0x00000008,
+    0x0000000d,0x00000003,0x00090019,0x0000000e,0x00000006,0x00000001,0x00000000,0x00000000,
+    0x00000000,0x00000001,0x00000000,0x0003001b,0x0000000f,0x0000000e,0x00040020,0x00000010,
+    0x00000000,0x0000000f,0x0004003b,0x00000010,0x00000011,0x00000000,0x00040015,0x00000012,
+    0x00000020,0x00000001,0x0003001e,0x00000013,0x00000012,0x00040020,0x00000014,0x00000002,
+    0x00000013,0x0004003b,0x00000014,0x00000015,0x00000002,0x00090019,0x00000016,0x00000006,
+    0x00000001,0x00000000,0x00000000,0x00000000,0x00000002,0x00000013,0x00040020,0x00000017,
+    0x00000000,0x00000016,0x0004003b,0x00000017,0x00000018,0x00000000,0x0003001e,0x00000019,
+    0x00000012,0x00040020,0x0000001a,0x00000002,0x00000019,0x0004003b,0x0000001a,0x0000001b,
+    0x00000002,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,0x000200f8,0x00000005,
+    0x000100fd,0x00010038,
+};
 static const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_kitchensink = {
     (size_t)1456, /* code_size */
     (const Uint8*)shad__spirv_vertex_code_kitchensink,   /* code */
@@ -41,7 +120,7 @@ static const SDL_GPUVertexAttribute shad__vertex_attributes_info_kitchensink[3]
         (Uint32)2,                          /* location */
         (Uint32)0,                          /* buffer_slot */
         SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,      /* format */
-        (Uint32)0,                          /* offset */
+        (Uint32)12,                          /* offset */
     },
 };
 static const SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_kitchensink[2] = {
@@ -140,8 +219,8 @@ static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_kitchensink = {
     },
     {
         SDL_GPU_COMPAREOP_LESS,   /* compare_op */
-        {0}, /* back stencil state */
-        {0}, /* front stencil state */
+        {(SDL_GPUStencilOp)0}, /* back stencil state */
+        {(SDL_GPUStencilOp)0}, /* front stencil state */
         (Uint8)0,   /* compare_mask */
         (Uint8)0,   /* write_mask */
         (bool)1,   /* enable_depth_test */
@@ -161,3 +240,241 @@ static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_kitchensink = {
         (Uint8)0,   /* padding3 */
     },
 };
+static const Uint64 shad_hash_kitchensink = 0x3ae6cdf71e77db89ull;
+static const Uint64 shad_vertex_spirv_hash_kitchensink = 0xbc3a9857f22463c8ull;
+static const Uint64 shad_fragment_spirv_hash_kitchensink = 0x5d32267b7c9cb276ull;
+static const Uint64 shad_pipeline_hash_kitchensink = 0xcdb52c68dd8e087bull;
+typedef struct shad_vertex_kitchensink_0 {
+    float v0[3];
+    Uint8 v2[4];
+} shad_vertex_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_size, sizeof(shad_vertex_kitchensink_0) == 16);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_v0, offsetof(shad_vertex_kitchensink_0, v0) == 0);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_v2, offsetof(shad_vertex_kitchensink_0, v2) == 12);
+typedef struct shad_vertex_kitchensink_3 {
+    float v1[3];
+} shad_vertex_kitchensink_3;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_3_size, sizeof(shad_vertex_kitchensink_3) == 12);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_3_v1, offsetof(shad_vertex_kitchensink_3, v1) == 0);
+typedef struct shad_vertex_buffer_kitchensink_0 {
+    Sint32 b1;
+} shad_vertex_buffer_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_kitchensink_0_size, sizeof(shad_vertex_buffer_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_kitchensink_0_b1, offsetof(shad_vertex_buffer_kitchensink_0, b1) == 0);
+typedef struct shad_vertex_uniform_kitchensink_0 {
+    Sint32 u1;
+} shad_vertex_uniform_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_kitchensink_0_size, sizeof(shad_vertex_uniform_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_kitchensink_0_u1, offsetof(shad_vertex_uniform_kitchensink_0, u1) == 0);
+typedef struct shad_fragment_buffer_kitchensink_0 {
+    Sint32 b2;
+} shad_fragment_buffer_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_fragment_buffer_kitchensink_0_size, sizeof(shad_fragment_buffer_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_fragment_buffer_kitchensink_0_b2, offsetof(shad_fragment_buffer_kitchensink_0, b2) == 0);
+typedef struct shad_fragment_uniform_kitchensink_0 {
+    Sint32 u2;
+} shad_fragment_uniform_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_fragment_uniform_kitchensink_0_size, sizeof(shad_fragment_uniform_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_fragment_uniform_kitchensink_0_u2, offsetof(shad_fragment_uniform_kitchensink_0, u2) == 0);
+#ifndef SHAD_SDL_BIND_CACHE_DEFINED
+#define SHAD_SDL_BIND_CACHE_DEFINED
+/* uniform data bigger than this is always pushed */
+#ifndef SHAD_SDL_BIND_CACHE_UNIFORM_SIZE
+#define SHAD_SDL_BIND_CACHE_UNIFORM_SIZE 256
+#endif
+/* what was last pushed and bound, so it isn't pushed or bound again. Slots go by update frequency, so per frame
+   resources come first, and if shaders declare them alike they stay bound when switching between them.
+   Call shad_sdl_bind_cache_begin() at the start of every render pass, which forgets everything.
+   [0] is the vertex stage, [1] the fragment stage */
+typedef struct ShadSdlBindCache {
+    SDL_GPUCommandBuffer *cmd;
+    SDL_GPURenderPass *pass;
+    Uint32 uniform_sizes[2][4];
+    Uint8 uniforms[2][4][SHAD_SDL_BIND_CACHE_UNIFORM_SIZE];
+    SDL_GPUTextureSamplerBinding samplers[2][16];
+    SDL_GPUTexture *storage_textures[2][8];
+    SDL_GPUBuffer *storage_buffers[2][8];
+    /* pushes and bind calls skipped in this render pass */
+    int num_skipped;
+} ShadSdlBindCache;
+
+static inline void shad_sdl_bind_cache_begin(ShadSdlBindCache *cache, SDL_GPUCommandBuffer *cmd, SDL_GPURenderPass *pass) {
+    SDL_memset(cache, 0, sizeof(*cache));
+    cache->cmd = cmd;
+    cache->pass = pass;
+}
+
+static inline void shad_sdl_push_uniform(ShadSdlBindCache *cache, int stage, Uint32 slot, const void *data, Uint32 size) {
+    if (slot < 4 && size <= SHAD_SDL_BIND_CACHE_UNIFORM_SIZE) {
+        if (cache->uniform_sizes[stage][slot] == size && !SDL_memcmp(cache->uniforms[stage][slot], data, size)) {++cache->num_skipped; return;}
+        cache->uniform_sizes[stage][slot] = size;
+        SDL_memcpy(cache->uniforms[stage][slot], data, size);
+    }
+    else if (slot < 4)
+        cache->uniform_sizes[stage][slot] = 0;
+    if (stage) SDL_PushGPUFragmentUniformData(cache->cmd, slot, data, size);
+    else SDL_PushGPUVertexUniformData(cache->cmd, slot, data, size);
+}
+
+/* narrows [*lo, *hi) down to the values that aren't what's cached, and caches them. False if they all are */
+static inline bool shad__sdl_bind_cache_update(void *cached, const void *values, size_t size, Uint32 *lo, Uint32 *hi) {
+    char *c = (char*)cached;
+    const char *v = (const char*)values;
+    while (*lo < *hi && !SDL_memcmp(c + *lo*size, v + *lo*size, size)) ++*lo;
+    while (*hi > *lo && !SDL_memcmp(c + (*hi-1)*size, v + (*hi-1)*size, size)) --*hi;
+    SDL_memcpy(c + *lo*size, v + *lo*size, (*hi - *lo)*size);
+    return *lo < *hi;
+}
+
+/* binds what changed of slots first to first+num, in one call */
+static inline void shad_sdl_bind_samplers(ShadSdlBindCache *cache, int stage, Uint32 first, const SDL_GPUTextureSamplerBinding *bindings, Uint32 num) {
+    Uint32 lo = 0, hi = num;
+    if (first + num <= 16 && !shad__sdl_bind_cache_update(cache->samplers[stage] + first, bindings, sizeof(*bindings), &lo, &hi)) {++cache->num_skipped; return;}
+    if (stage) SDL_BindGPUFragmentSamplers(cache->pass, first + lo, bindings + lo, hi - lo);
+    else SDL_BindGPUVertexSamplers(cache->pass, first + lo, bindings + lo, hi - lo);
+}
+
+static inline void shad_sdl_bind_storage_textures(ShadSdlBindCache *cache, int stage, Uint32 first, SDL_GPUTexture *const *textures, Uint32 num) {
+    Uint32 lo = 0, hi = num;
+    if (first + num <= 8 && !shad__sdl_bind_cache_update(cache->storage_textures[stage] + first, textures, sizeof(*textures), &lo, &hi)) {++cache->num_skipped; return;}
+    if (stage) SDL_BindGPUFragmentStorageTextures(cache->pass, first + lo, textures + lo, hi - lo);
+    else SDL_BindGPUVertexStorageTextures(cache->pass, first + lo, textures + lo, hi - lo);
+}
+
+static inline void shad_sdl_bind_storage_buffers(ShadSdlBindCache *cache, int stage, Uint32 first, SDL_GPUBuffer *const *buffers, Uint32 num) {
+    Uint32 lo = 0, hi = num;
+    if (first + num <= 8 && !shad__sdl_bind_cache_update(cache->storage_buffers[stage] + first, buffers, sizeof(*buffers), &lo, &hi)) {++cache->num_skipped; return;}
+    if (stage) SDL_BindGPUFragmentStorageBuffers(cache->pass, first + lo, buffers + lo, hi - lo);
+    else SDL_BindGPUVertexStorageBuffers(cache->pass, first + lo, buffers + lo, hi - lo);
+}
+#endif
+/* pushes and binds the per_frame resources of kitchensink, see ShadSdlBindCache */
+static inline void shad_bind_kitchensink_per_frame(ShadSdlBindCache *cache, SDL_GPUTextureSamplerBinding vertex_sampler0, const shad_vertex_uniform_kitchensink_0 *vertex_uniform0) {
+    {
+        SDL_GPUTextureSamplerBinding vertex_samplers[] = {vertex_sampler0};
+        shad_sdl_bind_samplers(cache, 0, 0, vertex_samplers, 1);
+    }
+    shad_sdl_push_uniform(cache, 0, 0, vertex_uniform0, (Uint32)sizeof(*vertex_uniform0));
+}
+/* pushes and binds the per_material resources of kitchensink, see ShadSdlBindCache */
+static inline void shad_bind_kitchensink_per_material(ShadSdlBindCache *cache, SDL_GPUTexture *vertex_storage_texture0, SDL_GPUTextureSamplerBinding fragment_sampler0, const shad_fragment_uniform_kitchensink_0 *fragment_uniform0) {
+    {
+        SDL_GPUTexture *vertex_storage_textures[] = {vertex_storage_texture0};
+        shad_sdl_bind_storage_textures(cache, 0, 0, vertex_storage_textures, 1);
+    }
+    {
+        SDL_GPUTextureSamplerBinding fragment_samplers[] = {fragment_sampler0};
+        shad_sdl_bind_samplers(cache, 1, 0, fragment_samplers, 1);
+    }
+    shad_sdl_push_uniform(cache, 1, 0, fragment_uniform0, (Uint32)sizeof(*fragment_uniform0));
+}
+/* pushes and binds the per_draw resources of kitchensink, see ShadSdlBindCache */
+static inline void shad_bind_kitchensink_per_draw(ShadSdlBindCache *cache, SDL_GPUBuffer *vertex_storage_buffer0, SDL_GPUTexture *fragment_storage_texture0, SDL_GPUBuffer *fragment_storage_buffer0) {
+    {
+        SDL_GPUBuffer *vertex_storage_buffers[] = {vertex_storage_buffer0};
+        shad_sdl_bind_storage_buffers(cache, 0, 0, vertex_storage_buffers, 1);
+    }
+    {
+        SDL_GPUTexture *fragment_storage_textures[] = {fragment_storage_texture0};
+        shad_sdl_bind_storage_textures(cache, 1, 0, fragment_storage_textures, 1);
+    }
+    {
+        SDL_GPUBuffer *fragment_storage_buffers[] = {fragment_storage_buffer0};
+        shad_sdl_bind_storage_buffers(cache, 1, 0, fragment_storage_buffers, 1);
+    }
+}
+#ifndef SHAD_SHADER_ENTRY_DEFINED
+#define SHAD_SHADER_ENTRY_DEFINED
+#ifdef __cplusplus
+#define SHAD_CONSTEXPR_FN constexpr
+#define SHAD_CONSTEXPR_DATA constexpr
+#else
+#define SHAD_CONSTEXPR_FN inline
+#define SHAD_CONSTEXPR_DATA const
+#endif
+typedef struct ShadShaderEntry {
+    const char *name;
+    const SDL_GPUShaderCreateInfo *vertex_shader;
+    const SDL_GPUShaderCreateInfo *fragment_shader;
+    const SDL_GPUGraphicsPipelineCreateInfo *pipeline;
+    Uint64 hash; /* shad_hash_<name> */
+} ShadShaderEntry;
+/* FNV-1a of a name, what registries look names up by */
+static SHAD_CONSTEXPR_FN Uint64 shad_name_hash(const char *name) {
+    Uint64 h = 0xcbf29ce484222325ull;
+    while (*name) h = (h ^ (unsigned char)*name++) * 0x100000001b3ull;
+    return h;
+}
+/* what shad_sdl_create_all() made for an entry */
+typedef struct ShadSdlCreated {
+    SDL_GPUShader *vertex_shader;
+    SDL_GPUShader *fragment_shader;
+    SDL_GPUGraphicsPipeline *pipeline;
+} ShadSdlCreated;
+/* runs task(data, i) for every i in [0, count) on your thread pool, and returns when they're all done */
+typedef void (*ShadParallelFor)(void *pool, int count, void (*task)(void *data, int index), void *data);
+/* what shad_sdl_create_all() creates things with, SDL_CreateGPUShader() and SDL_CreateGPUGraphicsPipeline() if NULL */
+typedef struct ShadSdlCreateCallbacks {
+    SDL_GPUShader* (*create_shader)(SDL_GPUDevice *device, const SDL_GPUShaderCreateInfo *info);
+    SDL_GPUGraphicsPipeline* (*create_pipeline)(SDL_GPUDevice *device, const SDL_GPUGraphicsPipelineCreateInfo *info);
+} ShadSdlCreateCallbacks;
+typedef struct ShadSdlCreateJob {
+    SDL_GPUDevice *device;
+    const ShadShaderEntry *entries;
+    ShadSdlCreated *out;
+    ShadSdlCreateCallbacks callbacks;
+} ShadSdlCreateJob;
+/* a pipeline only needs its own two shaders, so an entry is a task of its own */
+static inline void shad_sdl_create_entry(void *data, int index) {
+    ShadSdlCreateJob *job = (ShadSdlCreateJob*)data;
+    const ShadShaderEntry *e = &job->entries[index];
+    ShadSdlCreated *out = &job->out[index];
+    SDL_GPUGraphicsPipelineCreateInfo info;
+    out->vertex_shader = job->callbacks.create_shader(job->device, e->vertex_shader);
+    out->fragment_shader = e->fragment_shader->code_size ? job->callbacks.create_shader(job->device, e->fragment_shader) : NULL;
+    out->pipeline = NULL;
+    if (!out->vertex_shader || (e->fragment_shader->code_size && !out->fragment_shader)) return;
+    info = *e->pipeline;
+    info.vertex_shader = out->vertex_shader;
+    info.fragment_shader = out->fragment_shader;
+    out->pipeline = job->callbacks.create_pipeline(job->device, &info);
+}
+/* creates the shaders and pipeline of each of the count entries into out[count], spread over parallel_for (or one by one if NULL).
+   Returns false if anything couldn't be created. What was created is in out either way, for you to release */
+static inline bool shad_sdl_create_all(SDL_GPUDevice *device, const ShadShaderEntry *entries, int count, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated *out) {
+    ShadSdlCreateJob job;
+    int i;
+    job.device = device;
+    job.entries = entries;
+    job.out = out;
+    job.callbacks.create_shader = callbacks && callbacks->create_shader ? callbacks->create_shader : SDL_CreateGPUShader;
+    job.callbacks.create_pipeline = callbacks && callbacks->create_pipeline ? callbacks->create_pipeline : SDL_CreateGPUGraphicsPipeline;
+    if (parallel_for) parallel_for(pool, count, shad_sdl_create_entry, &job);
+    else for (i = 0; i < count; ++i) shad_sdl_create_entry(&job, i);
+    for (i = 0; i < count; ++i)
+        if (!out[i].pipeline) return false;
+    return true;
+}
+#endif
+#define shad_test_shaders_COUNT 1
+static const ShadShaderEntry shad_test_shaders[1] = {
+    {"kitchensink", &shad_sdl_vertex_shader_kitchensink, &shad_sdl_fragment_shader_kitchensink, &shad_sdl_pipeline_kitchensink, 0x3ae6cdf71e77db89ull},
+};
+static SHAD_CONSTEXPR_DATA Uint32 shad_test_shaders__displacements[1] = {
+    0x0u,
+};
+/* where the entry for name is, if there is one */
+static SHAD_CONSTEXPR_FN int shad_test_shaders_slot(const char *name) {
+    Uint64 h = shad_name_hash(name);
+    Uint32 d = shad_test_shaders__displacements[(Uint32)h % 1u];
+    return (int)((Uint32)(((Uint32)(h >> 32) ^ d) * 0x9e3779b1u) % 1u);
+}
+/* the entry for name, or NULL */
+static inline const ShadShaderEntry* shad_test_shaders_find(const char *name) {
+    const ShadShaderEntry *e = &shad_test_shaders[shad_test_shaders_slot(name)];
+    return SDL_strcmp(e->name, name) ? NULL : e;
+}
+/* creates every shader and pipeline in the table, out[i] is for shad_test_shaders[i], see shad_sdl_create_all() */
+static inline bool shad_test_shaders_create_all(SDL_GPUDevice *device, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated out[1]) {
+    return shad_sdl_create_all(device, shad_test_shaders, 1, parallel_for, pool, callbacks, out);
+}
@@ -0,0 +1,751 @@
+static const unsigned shad__spirv_vertex_code_kitchensink[364] = {
+    0x07230203,0x00010000,0x0008000b,0x00000028,0x00000000,0x00020011,0x00000001,0x0006000b,
+    0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,0x00000000,0x00000001,
+    0x0009000f,0x00000000,0x00000004,0x6e69616d,0x00000000,0x0000000d,0x00000017,0x00000018,
+    0x0000001a,0x00030003,0x00000002,0x000001c2,0x00040005,0x00000004,0x6e69616d,0x00000000,
+    0x00060005,0x0000000b,0x505f6c67,0x65567265,0x78657472,0x00000000,0x00060006,0x0000000b,
+    0x00000000,0x505f6c67,0x7469736f,0x006e6f69,0x00070006,0x0000000b,0x00000001,0x505f6c67,
+    0x746e696f,0x657a6953,0x00000000,0x00070006,0x0000000b,0x00000002,0x435f6c67,0x4470696c,
+    0x61747369,0x0065636e,0x00070006,0x0000000b,0x00000003,0x435f6c67,0x446c6c75,0x61747369,
+    0x0065636e,0x00030005,0x0000000d,0x00000000,0x00030005,0x00000017,0x00003076,0x00030005,
+    0x00000018,0x00003176,0x00030005,0x0000001a,0x00003276,0x00030005,0x0000001e,0x00003173,
+    0x00040005,0x0000001f,0x66667542,0x00327265,0x00040006,0x0000001f,0x00000000,0x00003162,
+    0x00030005,0x00000021,0x00000000,0x00030005,0x00000024,0x00003174,0x00050005,0x00000025,
+    0x66696e55,0x306d726f,0x00000000,0x00040006,0x00000025,0x00000000,0x00003175,0x00030005,
+    0x00000027,0x00000000,0x00030047,0x0000000b,0x00000002,0x00050048,0x0000000b,0x00000000,
+    0x0000000b,0x00000000,0x00050048,0x0000000b,0x00000001,0x0000000b,0x00000001,0x00050048,
+    0x0000000b,0x00000002,0x0000000b,0x00000003,0x00050048,0x0000000b,0x00000003,0x0000000b,
+    0x00000004,0x00040047,0x00000017,0x0000001e,0x00000000,0x00040047,0x00000018,0x0000001e,
+    0x00000001,0x00040047,0x0000001a,0x0000001e,0x00000002,0x00040047,0x0000001e,0x00000021,
+    0x00000000,0x00040047,0x0000001e,0x00000022,0x00000000,0x00030047,0x0000001f,0x00000003,
+    0x00040048,0x0000001f,0x00000000,0x00000019,0x00050048,0x0000001f,0x00000000,0x00000023,
+    0x00000000,0x00030047,0x00000021,0x00000019,0x00040047,0x00000021,0x00000021,0x00000002,
+    0x00040047,0x00000021,0x00000022,0x00000000,0x00030047,0x00000024,0x00000018,0x00040047,
+    0x00000024,0x00000021,0x00000001,0x00040047,0x00000024,0x00000022,0x00000000,0x00030047,
+    0x00000025,0x00000002,0x00050048,0x00000025,0x00000000,0x00000023,0x00000000,0x00040047,
+    0x00000027,0x00000021,0x00000000,0x00040047,0x00000027,0x00000022,0x00000001,0x00020013,
+    0x00000002,0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,
+    0x00000007,0x00000006,0x00000004,0x00040015,0x00000008,0x00000020,0x00000000,0x0004002b,
+    0x00000008,0x00000009,0x00000001,0x0004001c,0x0000000a,0x00000006,0x00000009,0x0006001e,
+    0x0000000b,0x00000007,0x00000006,0x0000000a,0x0000000a,0x00040020,0x0000000c,0x00000003,
+    0x0000000b,0x0004003b,0x0000000c,0x0000000d,0x00000003,0x00040015,0x0000000e,0x00000020,
+    0x00000001,0x0004002b,0x0000000e,0x0000000f,0x00000000,0x0004002b,0x00000006,0x00000010,
+    0x00000000,0x0004002b,0x00000006,0x00000011,0x3f800000,0x0007002c,0x00000007,0x00000012,
+    0x00000010,0x00000010,0x00000010,0x00000011,0x00040020,0x00000013,0x00000003,0x00000007,
+    0x00040017,0x00000015,0x00000006,0x00000003,0x00040020,0x00000016,0x00000001,0x00000015,
+    0x0004003b,0x00000016,0x00000017,0x00000001,0x0004003b,0x00000016,0x00000018,0x00000001,
+    0x00040020,0x00000019,0x00000001,0x00000007,0x0004003b,0x00000019,0x0000001a,0x00000001,
+    0x00090019,0x0000001b,0x00000006,0x00000001,0x00000000,0x00000000,0x00000000,0x00000001,
+    0x00000000,0x0003001b,0x0000001c,0x0000001b,0x00040020,0x0000001d,0x00000000,0x0000001c,
+    0x0004003b,0x0000001d,0x0000001e,0x00000000,0x0003001e,0x0000001f,0x0000000e,0x00040020,
+    0x00000020,0x00000002,0x0000001f,0x0004003b,0x00000020,0x00000021,0x00000002,0x00090019,
+    0x00000022,0x00000006,0x00000001,0x00000000,0x00000000,0x00000000,0x00000002,0x00000004,
+    0x00040020,0x00000023,0x00000000,0x00000022,0x0004003b,0x00000023,0x00000024,0x00000000,
+    0x0003001e,0x00000025,0x0000000e,0x00040020,0x00000026,0x00000002,0x00000025,0x0004003b,
+    0x00000026,0x00000027,0x00000002,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,
+    0x000200f8,0x00000005,0x00050041,0x00000013,0x00000014,0x0000000d,0x0000000f,0x0003003e,
+    0x00000014,0x00000012,0x000100fd,0x00010038,
+};
+static const unsigned shad__spirv_fragment_code_kitchensink[242] = {
+    0x07230203,0x00010000,0x0008000b,0x0000001c,0x00000000,0x00020011,0x00000001,0x00020011,
+    0x00000031,0x0006000b,0x00000001,0x4c534c47,0x6474732e,0x3035342e,0x00000000,0x0003000e,
+    0x00000000,0x00000001,0x0008000f,0x00000004,0x00000004,0x6e69616d,0x00000000,0x00000009,
+    0x0000000c,0x0000000d,0x00030010,0x00000004,0x00000007,0x00030003,0x00000002,0x000001c2,
+    0x00040005,0x00000004,0x6e69616d,0x00000000,0x00030005,0x00000009,0x00003066,0x00030005,
+    0x0000000c,0x00003166,0x00030005,0x0000000d,0x00003266,0x00030005,0x00000011,0x00003273,
+    0x00040005,0x00000013,0x66667542,0x00327265,0x00040006,0x00000013,0x00000000,0x00003262,
+    0x00030005,0x00000015,0x00000000,0x00030005,0x00000018,0x00003274,0x00050005,0x00000019,
+    0x66696e55,0x306d726f,0x00000000,0x00040006,0x00000019,0x00000000,0x00003275,0x00030005,
+    0x0000001b,0x00000000,0x00040047,0x00000009,0x0000001e,0x00000000,0x00040047,0x0000000c,
+    0x0000001e,0x00000001,0x00040047,0x0000000d,0x0000001e,0x00000002,0x00040047,0x00000011,
+    0x00000021,0x00000000,0x00040047,0x00000011,0x00000022,0x00000002,0x00030047,0x00000013,
+    0x00000003,0x00050048,0x00000013,0x00000000,0x00000023,0x00000000,0x00040047,0x00000015,
+    0x00000021,0x00000002,0x00040047,0x00000015,0x00000022,0x00000002,0x00040047,0x00000018,
+    0x00000021,0x00000001,0x00040047,0x00000018,0x00000022,0x00000002,0x00030047,0x00000019,
+    0x00000002,0x00050048,0x00000019,0x00000000,0x00000023,0x00000000,0x00040047,0x0000001b,
+    0x00000021,0x00000000,0x00040047,0x0000001b,0x00000022,0x00000003,0x00020013,0x00000002,
+    0x00030021,0x00000003,0x00000002,0x00030016,0x00000006,0x00000020,0x00040017,0x00000007,
+    0x00000006,0x00000004,0x00040020,0x00000008,0x00000003,0x00000007,0x0004003b,0x00000008,
+    0x00000009,0x00000003,0x00040017,0x0000000a,0x00000006,0x00000002,0x00040020,0x0000000b,
+    0x00000003,0x0000000a,0x0004003b,0x0000000b,0x0000000c,0x00000003,0x0004003b,0x00000008,
+    0x0000000d,0x00000003,0x00090019,0x0000000e,0x00000006,0x00000001,0x00000000,0x00000000,
+    0x00000000,0x00000001,0x00000000,0x0003001b,0x0000000f,0x0000000e,0x00040020,0x00000010,
+    0x00000000,0x0000000f,0x0004003b,0x00000010,0x00000011,0x00000000,0x00040015,0x00000012,
+    0x00000020,0x00000001,0x0003001e,0x00000013,0x00000012,0x00040020,0x00000014,0x00000002,
+    0x00000013,0x0004003b,0x00000014,0x00000015,0x00000002,0x00090019,0x00000016,0x00000006,
+    0x00000001,0x00000000,0x00000000,0x00000000,0x00000002,0x00000013,0x00040020,0x00000017,
+    0x00000000,0x00000016,0x0004003b,0x00000017,0x00000018,0x00000000,0x0003001e,0x00000019,
+    0x00000012,0x00040020,0x0000001a,0x00000002,0x00000019,0x0004003b,0x0000001a,0x0000001b,
+    0x00000002,0x00050036,0x00000002,0x00000004,0x00000000,0x00000003,0x000200f8,0x00000005,
+    0x000100fd,0x00010038,
+};
+static const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_kitchensink = {
+    (size_t)1456, /* code_size */
+    (const Uint8*)shad__spirv_vertex_code_kitchensink,   /* code */
+    "main",                    /* entrypoint */
+    SDL_GPU_SHADERFORMAT_SPIRV,  /* format */
+    SDL_GPU_SHADERSTAGE_VERTEX,  /* stage */
+    (Uint32)1,                  /* num_samplers */
+    (Uint32)1,                  /* num_storage_textures */
+    (Uint32)1,                  /* num_storage_buffers */
+    (Uint32)1,                  /* num_uniform_buffers */
+    0,                  /* props */
+};
+static const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_kitchensink = {
+    (size_t)968,   /* code_size */
+    (const Uint8*)shad__spirv_fragment_code_kitchensink,  /* code */
+    "main",                      /* entrypoint */
+    SDL_GPU_SHADERFORMAT_SPIRV,    /* format */
+    SDL_GPU_SHADERSTAGE_FRAGMENT,  /* stage */
+    (Uint32)1,         /* num_samplers */
+    (Uint32)1,         /* num_storage_textures */
+    (Uint32)1,         /* num_storage_buffers */
+    (Uint32)1,         /* num_uniform_buffers */
+    0,                  /* props */
+};
+static const SDL_GPUVertexAttribute shad__vertex_attributes_info_kitchensink[3] = {
+    {
+        (Uint32)0,                          /* location */
+        (Uint32)0,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,      /* format */
+        (Uint32)0,                          /* offset */
+    },
+    {
+        (Uint32)1,                          /* location */
+        (Uint32)3,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,      /* format */
+        (Uint32)0,                          /* offset */
+    },
+    {
+        (Uint32)2,                          /* location */
+        (Uint32)0,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,      /* format */
+        (Uint32)12,                          /* offset */
+    },
+};
+static const SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_kitchensink[2] = {
+    {
+        (Uint32)0,                          /* slot */
+        (Uint32)16,                          /* pitch */
+        SDL_GPU_VERTEXINPUTRATE_VERTEX,          /* input_rate */
+        (Uint32)0,                           /* instance_step_rate */
+    },
+    {
+        (Uint32)3,                          /* slot */
+        (Uint32)12,                          /* pitch */
+        SDL_GPU_VERTEXINPUTRATE_INSTANCE,          /* input_rate */
+        (Uint32)0,                           /* instance_step_rate */
+    },
+};
+static const SDL_GPUColorTargetDescription shad__color_target_descriptions_info_kitchensink[3] = {
+    {
+        SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_SRC_ALPHA,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_ADD,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_SRC_ALPHA,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_ADD,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+    {
+        SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_ZERO,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_SUBTRACT,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_ZERO,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_SUBTRACT,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+    {
+        SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_SRC_COLOR,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_DST_ALPHA,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_MAX,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_SRC_COLOR,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_DST_ALPHA,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_MAX,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+};
+static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_kitchensink = {
+    NULL,   /* vertex_shader */
+    NULL,   /* fragment_shader */
+    {
+        shad__vertex_buffer_descriptions_info_kitchensink,   /* vertex_buffer_descriptions */
+        (Uint32)2,                          /* num_vertex_buffers */
+        shad__vertex_attributes_info_kitchensink,   /* vertex_attributes */
+        (Uint32)3,                          /* num_vertex_attributes */
+    },
+    SDL_GPU_PRIMITIVETYPE_TRIANGLELIST, /* primitive_type */
+    {
+        SDL_GPU_FILLMODE_FILL,   /* fill_mode */
+        SDL_GPU_CULLMODE_FRONT,   /* cull_mode */
+        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */
+        0.f,   /* depth_bias_constant_factor */
+        0.f,   /* depth_bias_clamp */
+        0.f,   /* depth_bias_slope_factor */
+        (bool)0,   /* enable_depth_bias */
+        (bool)1,   /* enable_depth_clip */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+    },
+    {
+        SDL_GPU_SAMPLECOUNT_4,   /* sample_count */
+        (Uint32)0,   /* sample_mask */
+        (bool)0,   /* enable_mask */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        SDL_GPU_COMPAREOP_LESS,   /* compare_op */
+        {(SDL_GPUStencilOp)0}, /* back stencil state */
+        {(SDL_GPUStencilOp)0}, /* front stencil state */
+        (Uint8)0,   /* compare_mask */
+        (Uint8)0,   /* write_mask */
+        (bool)1,   /* enable_depth_test */
+        (bool)1,   /* enable_depth_write */
+        (bool)0,   /* enable_stencil_test */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        shad__color_target_descriptions_info_kitchensink,   /* color_target_descriptions */
+        (Uint32)3,   /* num_color_targets */
+        SDL_GPU_TEXTUREFORMAT_D24_UNORM,   /* depth_stencil_format */
+        (bool)1,   /* has_depth_stencil_target */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+};
+static const Uint64 shad_hash_kitchensink = 0x3ae6cdf71e77db89ull;
+static const Uint64 shad_vertex_spirv_hash_kitchensink = 0xbc3a9857f22463c8ull;
+static const Uint64 shad_fragment_spirv_hash_kitchensink = 0x5d32267b7c9cb276ull;
+static const Uint64 shad_pipeline_hash_kitchensink = 0xcdb52c68dd8e087bull;
+typedef struct shad_vertex_kitchensink_0 {
+    float v0[3];
+    Uint8 v2[4];
+} shad_vertex_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_size, sizeof(shad_vertex_kitchensink_0) == 16);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_v0, offsetof(shad_vertex_kitchensink_0, v0) == 0);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_0_v2, offsetof(shad_vertex_kitchensink_0, v2) == 12);
+typedef struct shad_vertex_kitchensink_3 {
+    float v1[3];
+} shad_vertex_kitchensink_3;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_3_size, sizeof(shad_vertex_kitchensink_3) == 12);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_kitchensink_3_v1, offsetof(shad_vertex_kitchensink_3, v1) == 0);
+typedef struct shad_vertex_buffer_kitchensink_0 {
+    Sint32 b1;
+} shad_vertex_buffer_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_kitchensink_0_size, sizeof(shad_vertex_buffer_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_kitchensink_0_b1, offsetof(shad_vertex_buffer_kitchensink_0, b1) == 0);
+typedef struct shad_vertex_uniform_kitchensink_0 {
+    Sint32 u1;
+} shad_vertex_uniform_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_kitchensink_0_size, sizeof(shad_vertex_uniform_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_kitchensink_0_u1, offsetof(shad_vertex_uniform_kitchensink_0, u1) == 0);
+typedef struct shad_fragment_buffer_kitchensink_0 {
+    Sint32 b2;
+} shad_fragment_buffer_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_fragment_buffer_kitchensink_0_size, sizeof(shad_fragment_buffer_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_fragment_buffer_kitchensink_0_b2, offsetof(shad_fragment_buffer_kitchensink_0, b2) == 0);
+typedef struct shad_fragment_uniform_kitchensink_0 {
+    Sint32 u2;
+} shad_fragment_uniform_kitchensink_0;
+SDL_COMPILE_TIME_ASSERT(shad_fragment_uniform_kitchensink_0_size, sizeof(shad_fragment_uniform_kitchensink_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_fragment_uniform_kitchensink_0_u2, offsetof(shad_fragment_uniform_kitchensink_0, u2) == 0);
+#ifdef __cplusplus
+#ifndef SHAD_CPP_DEFINED
+#define SHAD_CPP_DEFINED
+namespace shad {
+/* the C struct of a slot of a shader as ::type, e.g. vertex_uniform<shaders::mesh, 0>::type.
+   Only defined for the slots the shader has, so anything else doesn't compile */
+template <class Shader, Uint32 Slot> struct vertex_buffer;
+template <class Shader, Uint32 Slot> struct vertex_uniform;
+template <class Shader, Uint32 Slot> struct vertex_storage_buffer;
+template <class Shader, Uint32 Slot> struct fragment_uniform;
+template <class Shader, Uint32 Slot> struct fragment_storage_buffer;
+
+template <class Shader, Uint32 Slot>
+inline void push_vertex_uniform(SDL_GPUCommandBuffer *cmd, const typename vertex_uniform<Shader, Slot>::type &data) {
+    SDL_PushGPUVertexUniformData(cmd, Slot, &data, (Uint32)sizeof(data));
+}
+template <class Shader, Uint32 Slot>
+inline void push_fragment_uniform(SDL_GPUCommandBuffer *cmd, const typename fragment_uniform<Shader, Slot>::type &data) {
+    SDL_PushGPUFragmentUniformData(cmd, Slot, &data, (Uint32)sizeof(data));
+}
+/* a mapped transfer buffer as the vertices of a vertex buffer slot */
+template <class Shader, Uint32 Slot>
+inline typename vertex_buffer<Shader, Slot>::type* map_vertices(SDL_GPUDevice *device, SDL_GPUTransferBuffer *buffer, bool cycle) {
+    return (typename vertex_buffer<Shader, Slot>::type*)SDL_MapGPUTransferBuffer(device, buffer, cycle);
+}
+} /* namespace shad */
+#endif
+namespace shad {
+namespace shaders {
+struct kitchensink {
+    static constexpr const char *name = "kitchensink";
+    static constexpr Uint64 hash = 0x3ae6cdf71e77db89ull;
+    static constexpr Uint32 num_vertex_buffers = 2;
+    static constexpr Uint32 num_vertex_samplers = 1;
+    static constexpr Uint32 num_vertex_storage_textures = 1;
+    static constexpr Uint32 num_vertex_storage_buffers = 1;
+    static constexpr Uint32 num_vertex_uniform_buffers = 1;
+    static constexpr Uint32 num_fragment_samplers = 1;
+    static constexpr Uint32 num_fragment_storage_textures = 1;
+    static constexpr Uint32 num_fragment_storage_buffers = 1;
+    static constexpr Uint32 num_fragment_uniform_buffers = 1;
+    static constexpr Uint32 num_color_targets = 3;
+static constexpr SDL_GPUVertexAttribute shad__vertex_attributes_info_kitchensink[3] = {
+    {
+        (Uint32)0,                          /* location */
+        (Uint32)0,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,      /* format */
+        (Uint32)0,                          /* offset */
+    },
+    {
+        (Uint32)1,                          /* location */
+        (Uint32)3,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_FLOAT3,      /* format */
+        (Uint32)0,                          /* offset */
+    },
+    {
+        (Uint32)2,                          /* location */
+        (Uint32)0,                          /* buffer_slot */
+        SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM,      /* format */
+        (Uint32)12,                          /* offset */
+    },
+};
+static constexpr SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_kitchensink[2] = {
+    {
+        (Uint32)0,                          /* slot */
+        (Uint32)16,                          /* pitch */
+        SDL_GPU_VERTEXINPUTRATE_VERTEX,          /* input_rate */
+        (Uint32)0,                           /* instance_step_rate */
+    },
+    {
+        (Uint32)3,                          /* slot */
+        (Uint32)12,                          /* pitch */
+        SDL_GPU_VERTEXINPUTRATE_INSTANCE,          /* input_rate */
+        (Uint32)0,                           /* instance_step_rate */
+    },
+};
+static constexpr SDL_GPUColorTargetDescription shad__color_target_descriptions_info_kitchensink[3] = {
+    {
+        SDL_GPU_TEXTUREFORMAT_R8G8B8A8_UNORM,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_SRC_ALPHA,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_ADD,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_SRC_ALPHA,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE_MINUS_SRC_ALPHA,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_ADD,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+    {
+        SDL_GPU_TEXTUREFORMAT_R32G32_FLOAT,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_ZERO,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_SUBTRACT,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_ZERO,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_ONE,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_SUBTRACT,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+    {
+        SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT,   /* format */
+        {
+            SDL_GPU_BLENDFACTOR_SRC_COLOR,   /* src_color_blendfactor */
+            SDL_GPU_BLENDFACTOR_DST_ALPHA,   /* dst_color_blendfactor */
+            SDL_GPU_BLENDOP_MAX,   /* color_blend_op */
+            SDL_GPU_BLENDFACTOR_SRC_COLOR,   /* src_alpha_blendfactor */
+            SDL_GPU_BLENDFACTOR_DST_ALPHA,   /* dst_alpha_blendfactor */
+            SDL_GPU_BLENDOP_MAX,   /* alpha_blend_op */
+            (SDL_GPUColorComponentFlags)0,   /* color_write_mask */
+            (bool)1,   /* enable_blend */
+            (bool)0,   /* enable_color_write_mask */
+            (Uint8)0,   /* padding1 */
+            (Uint8)0,   /* padding2 */
+        },
+    },
+};
+static constexpr SDL_GPUGraphicsPipelineCreateInfo pipeline = {
+    NULL,   /* vertex_shader */
+    NULL,   /* fragment_shader */
+    {
+        shad__vertex_buffer_descriptions_info_kitchensink,   /* vertex_buffer_descriptions */
+        (Uint32)2,                          /* num_vertex_buffers */
+        shad__vertex_attributes_info_kitchensink,   /* vertex_attributes */
+        (Uint32)3,                          /* num_vertex_attributes */
+    },
+    SDL_GPU_PRIMITIVETYPE_TRIANGLELIST, /* primitive_type */
+    {
+        SDL_GPU_FILLMODE_FILL,   /* fill_mode */
+        SDL_GPU_CULLMODE_FRONT,   /* cull_mode */
+        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */
+        0.f,   /* depth_bias_constant_factor */
+        0.f,   /* depth_bias_clamp */
+        0.f,   /* depth_bias_slope_factor */
+        (bool)0,   /* enable_depth_bias */
+        (bool)1,   /* enable_depth_clip */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+    },
+    {
+        SDL_GPU_SAMPLECOUNT_4,   /* sample_count */
+        (Uint32)0,   /* sample_mask */
+        (bool)0,   /* enable_mask */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        SDL_GPU_COMPAREOP_LESS,   /* compare_op */
+        {(SDL_GPUStencilOp)0}, /* back stencil state */
+        {(SDL_GPUStencilOp)0}, /* front stencil state */
+        (Uint8)0,   /* compare_mask */
+        (Uint8)0,   /* write_mask */
+        (bool)1,   /* enable_depth_test */
+        (bool)1,   /* enable_depth_write */
+        (bool)0,   /* enable_stencil_test */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        shad__color_target_descriptions_info_kitchensink,   /* color_target_descriptions */
+        (Uint32)3,   /* num_color_targets */
+        SDL_GPU_TEXTUREFORMAT_D24_UNORM,   /* depth_stencil_format */
+        (bool)1,   /* has_depth_stencil_target */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+};
+};
+} /* namespace shaders */
+template <> struct vertex_buffer<shaders::kitchensink, 0> {typedef shad_vertex_kitchensink_0 type;};
+template <> struct vertex_buffer<shaders::kitchensink, 3> {typedef shad_vertex_kitchensink_3 type;};
+template <> struct vertex_storage_buffer<shaders::kitchensink, 0> {typedef shad_vertex_buffer_kitchensink_0 type;};
+template <> struct vertex_uniform<shaders::kitchensink, 0> {typedef shad_vertex_uniform_kitchensink_0 type;};
+template <> struct fragment_storage_buffer<shaders::kitchensink, 0> {typedef shad_fragment_buffer_kitchensink_0 type;};
+template <> struct fragment_uniform<shaders::kitchensink, 0> {typedef shad_fragment_uniform_kitchensink_0 type;};
+} /* namespace shad */
+#endif
+static const unsigned shad__spirv_fragment_code_import[1] = {0};
+static const SDL_GPUShaderCreateInfo shad_sdl_vertex_shader_import = {
+    (size_t)1456, /* code_size */
+    (const Uint8*)shad__spirv_vertex_code_kitchensink,   /* code */
+    "main",                    /* entrypoint */
+    SDL_GPU_SHADERFORMAT_SPIRV,  /* format */
+    SDL_GPU_SHADERSTAGE_VERTEX,  /* stage */
+    (Uint32)1,                  /* num_samplers */
+    (Uint32)0,                  /* num_storage_textures */
+    (Uint32)1,                  /* num_storage_buffers */
+    (Uint32)0,                  /* num_uniform_buffers */
+    0,                  /* props */
+};
+static const SDL_GPUShaderCreateInfo shad_sdl_fragment_shader_import = {0};
+static const SDL_GPUVertexAttribute shad__vertex_attributes_info_import[1] = {{(Uint32)0}};
+static const SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_import[1] = {{(Uint32)0}};
+static const SDL_GPUColorTargetDescription shad__color_target_descriptions_info_import[1] = {{(SDL_GPUTextureFormat)0}};
+static const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_import = {
+    NULL,   /* vertex_shader */
+    NULL,   /* fragment_shader */
+    {
+        shad__vertex_buffer_descriptions_info_import,   /* vertex_buffer_descriptions */
+        (Uint32)0,                          /* num_vertex_buffers */
+        shad__vertex_attributes_info_import,   /* vertex_attributes */
+        (Uint32)0,                          /* num_vertex_attributes */
+    },
+    SDL_GPU_PRIMITIVETYPE_TRIANGLELIST, /* primitive_type */
+    {
+        SDL_GPU_FILLMODE_FILL,   /* fill_mode */
+        SDL_GPU_CULLMODE_NONE,   /* cull_mode */
+        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */
+        0.f,   /* depth_bias_constant_factor */
+        0.f,   /* depth_bias_clamp */
+        0.f,   /* depth_bias_slope_factor */
+        (bool)0,   /* enable_depth_bias */
+        (bool)0,   /* enable_depth_clip */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+    },
+    {
+        SDL_GPU_SAMPLECOUNT_1,   /* sample_count */
+        (Uint32)0,   /* sample_mask */
+        (bool)0,   /* enable_mask */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        SDL_GPU_COMPAREOP_INVALID,   /* compare_op */
+        {(SDL_GPUStencilOp)0}, /* back stencil state */
+        {(SDL_GPUStencilOp)0}, /* front stencil state */
+        (Uint8)0,   /* compare_mask */
+        (Uint8)0,   /* write_mask */
+        (bool)0,   /* enable_depth_test */
+        (bool)0,   /* enable_depth_write */
+        (bool)0,   /* enable_stencil_test */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        shad__color_target_descriptions_info_import,   /* color_target_descriptions */
+        (Uint32)0,   /* num_color_targets */
+        SDL_GPU_TEXTUREFORMAT_INVALID,   /* depth_stencil_format */
+        (bool)0,   /* has_depth_stencil_target */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+};
+static const Uint64 shad_hash_import = 0x324ec756934d1f6dull;
+static const Uint64 shad_vertex_spirv_hash_import = 0xbc3a9857f22463c8ull;
+static const Uint64 shad_fragment_spirv_hash_import = 0x0000000000000000ull;
+static const Uint64 shad_pipeline_hash_import = 0x646b5228979594e5ull;
+typedef struct shad_vertex_buffer_import_1 {
+    Sint32 b1;
+} shad_vertex_buffer_import_1;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_import_1_size, sizeof(shad_vertex_buffer_import_1) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_buffer_import_1_b1, offsetof(shad_vertex_buffer_import_1, b1) == 0);
+typedef struct shad_vertex_uniform_import_0 {
+    Sint32 u1;
+} shad_vertex_uniform_import_0;
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_import_0_size, sizeof(shad_vertex_uniform_import_0) == 4);
+SDL_COMPILE_TIME_ASSERT(shad_vertex_uniform_import_0_u1, offsetof(shad_vertex_uniform_import_0, u1) == 0);
+#ifdef __cplusplus
+#ifndef SHAD_CPP_DEFINED
+#define SHAD_CPP_DEFINED
+namespace shad {
+/* the C struct of a slot of a shader as ::type, e.g. vertex_uniform<shaders::mesh, 0>::type.
+   Only defined for the slots the shader has, so anything else doesn't compile */
+template <class Shader, Uint32 Slot> struct vertex_buffer;
+template <class Shader, Uint32 Slot> struct vertex_uniform;
+template <class Shader, Uint32 Slot> struct vertex_storage_buffer;
+template <class Shader, Uint32 Slot> struct fragment_uniform;
+template <class Shader, Uint32 Slot> struct fragment_storage_buffer;
+
+template <class Shader, Uint32 Slot>
+inline void push_vertex_uniform(SDL_GPUCommandBuffer *cmd, const typename vertex_uniform<Shader, Slot>::type &data) {
+    SDL_PushGPUVertexUniformData(cmd, Slot, &data, (Uint32)sizeof(data));
+}
+template <class Shader, Uint32 Slot>
+inline void push_fragment_uniform(SDL_GPUCommandBuffer *cmd, const typename fragment_uniform<Shader, Slot>::type &data) {
+    SDL_PushGPUFragmentUniformData(cmd, Slot, &data, (Uint32)sizeof(data));
+}
+/* a mapped transfer buffer as the vertices of a vertex buffer slot */
+template <class Shader, Uint32 Slot>
+inline typename vertex_buffer<Shader, Slot>::type* map_vertices(SDL_GPUDevice *device, SDL_GPUTransferBuffer *buffer, bool cycle) {
+    return (typename vertex_buffer<Shader, Slot>::type*)SDL_MapGPUTransferBuffer(device, buffer, cycle);
+}
+} /* namespace shad */
+#endif
+namespace shad {
+namespace shaders {
+struct import {
+    static constexpr const char *name = "import";
+    static constexpr Uint64 hash = 0x324ec756934d1f6dull;
+    static constexpr Uint32 num_vertex_buffers = 0;
+    static constexpr Uint32 num_vertex_samplers = 1;
+    static constexpr Uint32 num_vertex_storage_textures = 0;
+    static constexpr Uint32 num_vertex_storage_buffers = 1;
+    static constexpr Uint32 num_vertex_uniform_buffers = 0;
+    static constexpr Uint32 num_fragment_samplers = 0;
+    static constexpr Uint32 num_fragment_storage_textures = 0;
+    static constexpr Uint32 num_fragment_storage_buffers = 0;
+    static constexpr Uint32 num_fragment_uniform_buffers = 0;
+    static constexpr Uint32 num_color_targets = 0;
+static constexpr SDL_GPUVertexAttribute shad__vertex_attributes_info_import[1] = {};
+static constexpr SDL_GPUVertexBufferDescription shad__vertex_buffer_descriptions_info_import[1] = {};
+static constexpr SDL_GPUColorTargetDescription shad__color_target_descriptions_info_import[1] = {};
+static constexpr SDL_GPUGraphicsPipelineCreateInfo pipeline = {
+    NULL,   /* vertex_shader */
+    NULL,   /* fragment_shader */
+    {
+        shad__vertex_buffer_descriptions_info_import,   /* vertex_buffer_descriptions */
+        (Uint32)0,                          /* num_vertex_buffers */
+        shad__vertex_attributes_info_import,   /* vertex_attributes */
+        (Uint32)0,                          /* num_vertex_attributes */
+    },
+    SDL_GPU_PRIMITIVETYPE_TRIANGLELIST, /* primitive_type */
+    {
+        SDL_GPU_FILLMODE_FILL,   /* fill_mode */
+        SDL_GPU_CULLMODE_NONE,   /* cull_mode */
+        SDL_GPU_FRONTFACE_COUNTER_CLOCKWISE,   /* front_face */
+        0.f,   /* depth_bias_constant_factor */
+        0.f,   /* depth_bias_clamp */
+        0.f,   /* depth_bias_slope_factor */
+        (bool)0,   /* enable_depth_bias */
+        (bool)0,   /* enable_depth_clip */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+    },
+    {
+        SDL_GPU_SAMPLECOUNT_1,   /* sample_count */
+        (Uint32)0,   /* sample_mask */
+        (bool)0,   /* enable_mask */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        SDL_GPU_COMPAREOP_INVALID,   /* compare_op */
+        {(SDL_GPUStencilOp)0}, /* back stencil state */
+        {(SDL_GPUStencilOp)0}, /* front stencil state */
+        (Uint8)0,   /* compare_mask */
+        (Uint8)0,   /* write_mask */
+        (bool)0,   /* enable_depth_test */
+        (bool)0,   /* enable_depth_write */
+        (bool)0,   /* enable_stencil_test */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+    {
+        shad__color_target_descriptions_info_import,   /* color_target_descriptions */
+        (Uint32)0,   /* num_color_targets */
+        SDL_GPU_TEXTUREFORMAT_INVALID,   /* depth_stencil_format */
+        (bool)0,   /* has_depth_stencil_target */
+        (Uint8)0,   /* padding1 */
+        (Uint8)0,   /* padding2 */
+        (Uint8)0,   /* padding3 */
+    },
+};
+};
+} /* namespace shaders */
+template <> struct vertex_storage_buffer<shaders::import, 1> {typedef shad_vertex_buffer_import_1 type;};
+template <> struct vertex_uniform<shaders::import, 0> {typedef shad_vertex_uniform_import_0 type;};
+} /* namespace shad */
+#endif
+#ifndef SHAD_SHADER_ENTRY_DEFINED
+#define SHAD_SHADER_ENTRY_DEFINED
+#ifdef __cplusplus
+#define SHAD_CONSTEXPR_FN constexpr
+#define SHAD_CONSTEXPR_DATA constexpr
+#else
+#define SHAD_CONSTEXPR_FN inline
+#define SHAD_CONSTEXPR_DATA const
+#endif
+typedef struct ShadShaderEntry {
+    const char *name;
+    const SDL_GPUShaderCreateInfo *vertex_shader;
+    const SDL_GPUShaderCreateInfo *fragment_shader;
+    const SDL_GPUGraphicsPipelineCreateInfo *pipeline;
+    Uint64 hash; /* shad_hash_<name> */
+} ShadShaderEntry;
+/* FNV-1a of a name, what registries look names up by */
+static SHAD_CONSTEXPR_FN Uint64 shad_name_hash(const char *name) {
+    Uint64 h = 0xcbf29ce484222325ull;
+    while (*name) h = (h ^ (unsigned char)*name++) * 0x100000001b3ull;
+    return h;
+}
+/* what shad_sdl_create_all() made for an entry */
+typedef struct ShadSdlCreated {
+    SDL_GPUShader *vertex_shader;
+    SDL_GPUShader *fragment_shader;
+    SDL_GPUGraphicsPipeline *pipeline;
+} ShadSdlCreated;
+/* runs task(data, i) for every i in [0, count) on your thread pool, and returns when they're all done */
+typedef void (*ShadParallelFor)(void *pool, int count, void (*task)(void *data, int index), void *data);
+/* what shad_sdl_create_all() creates things with, SDL_CreateGPUShader() and SDL_CreateGPUGraphicsPipeline() if NULL */
+typedef struct ShadSdlCreateCallbacks {
+    SDL_GPUShader* (*create_shader)(SDL_GPUDevice *device, const SDL_GPUShaderCreateInfo *info);
+    SDL_GPUGraphicsPipeline* (*create_pipeline)(SDL_GPUDevice *device, const SDL_GPUGraphicsPipelineCreateInfo *info);
+} ShadSdlCreateCallbacks;
+typedef struct ShadSdlCreateJob {
+    SDL_GPUDevice *device;
+    const ShadShaderEntry *entries;
+    ShadSdlCreated *out;
+    ShadSdlCreateCallbacks callbacks;
+} ShadSdlCreateJob;
+/* a pipeline only needs its own two shaders, so an entry is a task of its own */
+static inline void shad_sdl_create_entry(void *data, int index) {
+    ShadSdlCreateJob *job = (ShadSdlCreateJob*)data;
+    const ShadShaderEntry *e = &job->entries[index];
+    ShadSdlCreated *out = &job->out[index];
+    SDL_GPUGraphicsPipelineCreateInfo info;
+    out->vertex_shader = job->callbacks.create_shader(job->device, e->vertex_shader);
+    out->fragment_shader = e->fragment_shader->code_size ? job->callbacks.create_shader(job->device, e->fragment_shader) : NULL;
+    out->pipeline = NULL;
+    if (!out->vertex_shader || (e->fragment_shader->code_size && !out->fragment_shader)) return;
+    info = *e->pipeline;
+    info.vertex_shader = out->vertex_shader;
+    info.fragment_shader = out->fragment_shader;
+    out->pipeline = job->callbacks.create_pipeline(job->device, &info);
+}
+/* creates the shaders and pipeline of each of the count entries into out[count], spread over parallel_for (or one by one if NULL).
+   Returns false if anything couldn't be created. What was created is in out either way, for you to release */
+static inline bool shad_sdl_create_all(SDL_GPUDevice *device, const ShadShaderEntry *entries, int count, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated *out) {
+    ShadSdlCreateJob job;
+    int i;
+    job.device = device;
+    job.entries = entries;
+    job.out = out;
+    job.callbacks.create_shader = callbacks && callbacks->create_shader ? callbacks->create_shader : SDL_CreateGPUShader;
+    job.callbacks.create_pipeline = callbacks && callbacks->create_pipeline ? callbacks->create_pipeline : SDL_CreateGPUGraphicsPipeline;
+    if (parallel_for) parallel_for(pool, count, shad_sdl_create_entry, &job);
+    else for (i = 0; i < count; ++i) shad_sdl_create_entry(&job, i);
+    for (i = 0; i < count; ++i)
+        if (!out[i].pipeline) return false;
+    return true;
+}
+#endif
+#define shad_test_shaders_COUNT 2
+static const ShadShaderEntry shad_test_shaders[2] = {
+    {"kitchensink", &shad_sdl_vertex_shader_kitchensink, &shad_sdl_fragment_shader_kitchensink, &shad_sdl_pipeline_kitchensink, 0x3ae6cdf71e77db89ull},
+    {"import", &shad_sdl_vertex_shader_import, &shad_sdl_fragment_shader_import, &shad_sdl_pipeline_import, 0x324ec756934d1f6dull},
+};
+static SHAD_CONSTEXPR_DATA Uint32 shad_test_shaders__displacements[8] = {
+    0x0u, 0x0u, 0x0u, 0x0u, 0x1u, 0x0u, 0x0u, 0x0u,
+};
+/* where the entry for name is, if there is one */
+static SHAD_CONSTEXPR_FN int shad_test_shaders_slot(const char *name) {
+    Uint64 h = shad_name_hash(name);
+    Uint32 d = shad_test_shaders__displacements[(Uint32)h % 8u];
+    return (int)((Uint32)(((Uint32)(h >> 32) ^ d) * 0x9e3779b1u) % 2u);
+}
+/* the entry for name, or NULL */
+static inline const ShadShaderEntry* shad_test_shaders_find(const char *name) {
+    const ShadShaderEntry *e = &shad_test_shaders[shad_test_shaders_slot(name)];
+    return SDL_strcmp(e->name, name) ? NULL : e;
+}
+/* creates every shader and pipeline in the table, out[i] is for shad_test_shaders[i], see shad_sdl_create_all() */
+static inline bool shad_test_shaders_create_all(SDL_GPUDevice *device, ShadParallelFor parallel_for, void *pool, const ShadSdlCreateCallbacks *callbacks, ShadSdlCreated out[2]) {
+    return shad_sdl_create_all(device, shad_test_shaders, 2, parallel_for, pool, callbacks, out);
+}
@@ -9,10 +9,10 @@
     @in(buffer=3, instanced) vec3 v1;
     @in(buffer=0, type=u8) vec4 v2;
 
-    @sampler sampler2D s1;
+    @sampler(per_frame) sampler2D s1;
     @buffer writeonly {int b1;};
-    @image(format=rgba8) readonly image2D t1;
-    @uniform {int u1;};
+    @image(format=rgba8, per_material) readonly image2D t1;
+    @uniform(per_frame) {int u1;};
 
     void main() {gl_Position = vec4(0,0,0,1);}
 
@@ -29,10 +29,10 @@
     @blend src_color dst_alpha max
     @out(format=r11g11b10f) vec4 f2;
 
-    @sampler sampler2D s2;
-    @buffer {int b2;};
+    @sampler(per_material) sampler2D s2;
+    @buffer(per_draw) {int b2;};
     @image(format=r16_snorm) image2D t2;
-    @uniform {int u2;};
+    @uniform(per_material) {int u2;};
 
     void main() {}
 
@@ -7,6 +7,49 @@
 
 #define ASSERT_EQ_INT(a, b) do {int _a = (a); int _b = (b); if (_a != _b) {fprintf(stderr, "Assertion failed: %s != %s (%i != %i)\n", #a, #b, _a, _b); return 1;}} while (0)
 
+/* stand-ins for the GPU and a thread pool, for shad_sdl_create_all() */
+int stub_shaders_created, stub_pipelines_created, stub_tasks_run, stub_fail_shaders;
+SDL_GPUShader* stub_create_shader(SDL_GPUDevice *device, const SDL_GPUShaderCreateInfo *info) {
+    (void)device;
+    ++stub_shaders_created;
+    return stub_fail_shaders ? NULL : (SDL_GPUShader*)info;
+}
+SDL_GPUGraphicsPipeline* stub_create_pipeline(SDL_GPUDevice *device, const SDL_GPUGraphicsPipelineCreateInfo *info) {
+    (void)device;
+    ++stub_pipelines_created;
+    /* the shaders have to be created first */
+    if (!info->vertex_shader || !info->fragment_shader) return NULL;
+    return (SDL_GPUGraphicsPipeline*)info->vertex_shader;
+}
+void stub_parallel_for(void *pool, int count, void (*task)(void *data, int index), void *data) {
+    int i;
+    (void)pool;
+    for (i = count-1; i >= 0; --i, ++stub_tasks_run)
+        task(data, i);
+}
+
+/* stand-ins for the registry's create/release callbacks, handing out distinct fake objects */
+size_t stub_next_object;
+int stub_objects_live;
+SDL_GPUShader* stub_registry_create_shader(void *userdata, const SDL_GPUShaderCreateInfo *info) {
+    (void)userdata; (void)info;
+    ++stub_objects_live;
+    return (SDL_GPUShader*)++stub_next_object;
+}
+SDL_GPUGraphicsPipeline* stub_registry_create_pipeline(void *userdata, const SDL_GPUGraphicsPipelineCreateInfo *info) {
+    (void)userdata; (void)info;
+    ++stub_objects_live;
+    return (SDL_GPUGraphicsPipeline*)++stub_next_object;
+}
+void stub_registry_release_shader(void *userdata, SDL_GPUShader *shader) {
+    (void)userdata; (void)shader;
+    --stub_objects_live;
+}
+void stub_registry_release_pipeline(void *userdata, SDL_GPUGraphicsPipeline *pipeline) {
+    (void)userdata; (void)pipeline;
+    --stub_objects_live;
+}
+
 int main(int argc, char const *argv[]) {
     ShadCompilation sc;
     int res;
@@ -18,6 +61,8 @@ int main(int argc, char const *argv[]) {
     ASSERT_EQ_INT(sc.num_vertex_inputs, 3);
     ASSERT_EQ_INT(sc.vertex_input_buffers[0].slot, 0);
     ASSERT_EQ_INT(sc.vertex_input_buffers[1].slot, 3);
+    ASSERT_EQ_INT(sc.vertex_input_buffers[0].stride, 16);
+    ASSERT_EQ_INT(sc.vertex_inputs[2].offset, 12);
     ASSERT_EQ_INT(sc.num_vertex_samplers, 1);
     ASSERT_EQ_INT(sc.num_vertex_buffers, 1);
     ASSERT_EQ_INT(sc.num_vertex_images, 1);
@@ -28,6 +73,452 @@ int main(int argc, char const *argv[]) {
     ASSERT_EQ_INT(sc.num_fragment_uniforms, 1);
     ASSERT_EQ_INT(sc.num_vertex_input_buffers, 2);
 
+    /* serialize round trip, copying and in place */
+    {
+        ShadCompilation copy, view;
+        char *bytes;
+        int num_bytes;
+        shad_compilation_serialize(&sc, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize(bytes, num_bytes, &copy));
+        assert(shad_compilation_deserialize_view(bytes, num_bytes, &view));
+        assert(view.spirv_vertex_code > bytes && view.spirv_vertex_code < bytes + num_bytes);
+        assert(copy.spirv_vertex_code < bytes || copy.spirv_vertex_code >= bytes + num_bytes);
+        ASSERT_EQ_INT(copy.spirv_vertex_code_size, sc.spirv_vertex_code_size);
+        ASSERT_EQ_INT(memcmp(copy.spirv_vertex_code, sc.spirv_vertex_code, sc.spirv_vertex_code_size), 0);
+        ASSERT_EQ_INT(memcmp(view.spirv_fragment_code, sc.spirv_fragment_code, sc.spirv_fragment_code_size), 0);
+        ASSERT_EQ_INT(copy.num_vertex_inputs, 3);
+        ASSERT_EQ_INT(copy.vertex_inputs[1].instanced, 1);
+        ASSERT_EQ_INT(copy.vertex_inputs[2].format, SHAD_VERTEXELEMENTFORMAT_UBYTE4_NORM);
+        ASSERT_EQ_INT(copy.vertex_inputs[2].offset, 12);
+        ASSERT_EQ_INT(view.vertex_input_buffers[1].slot, 3);
+        ASSERT_EQ_INT(view.vertex_input_buffers[1].stride, 12);
+        ASSERT_EQ_INT(view.fragment_outputs[2].blend_op, SHAD_BLEND_OP_MAX);
+        ASSERT_EQ_INT(view.num_fragment_uniforms, 1);
+        ASSERT_EQ_INT(view.depth_format, sc.depth_format);
+        ASSERT_EQ_INT(view.multisample_count, 4);
+        ASSERT_EQ_INT(view.cull_mode, sc.cull_mode);
+        shad_compilation_free(&copy);
+        shad_compilation_free(&view);
+
+        /* corrupt data is rejected, views only check the checksum on request */
+        assert(shad_compilation_verify(bytes, num_bytes));
+        bytes[num_bytes-1] ^= 1;
+        assert(!shad_compilation_deserialize(bytes, num_bytes, &copy));
+        assert(!shad_compilation_verify(bytes, num_bytes));
+        bytes[num_bytes-1] ^= 1;
+
+        /* so are out of range values, even with a valid checksum */
+        {
+            unsigned cull_mode = shad__get_u32(bytes + 4*20);
+            shad__put_u32(bytes + 4*20, 100);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+            assert(!shad_compilation_deserialize(bytes, num_bytes, &copy));
+            assert(!shad_compilation_deserialize_view(bytes, num_bytes, &view));
+            shad__put_u32(bytes + 4*20, cull_mode);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+
+            /* the pretranslated SDL arrays too, the first color target's format here */
+            char *sdlp = (char*)shad__v2_find(bytes, "SDLP", NULL, NULL);
+            unsigned format = shad__get_u32(sdlp + 16 + 2*16 + 3*16);
+            shad__put_u32(sdlp + 16 + 2*16 + 3*16, 1);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+            assert(!shad_compilation_deserialize_view(bytes, num_bytes, &view));
+            shad__put_u32(sdlp + 16 + 2*16 + 3*16, format);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+            assert(shad_compilation_deserialize_view(bytes, num_bytes, &view));
+            shad_compilation_free(&view);
+        }
+    }
+
+    /* compressed SPIRV decodes to the original */
+    {
+        ShadArena arena;
+        ShadWriter encoded;
+        ShadCompilation copy;
+        unsigned *decoded = (unsigned*)malloc(sizeof(shad__spirv_vertex_code_kitchensink));
+        char *bytes;
+        int num_bytes;
+        memset(&arena, 0, sizeof(arena));
+        memset(&encoded, 0, sizeof(encoded));
+        encoded.arena = &arena;
+        shad__spirv_encode(&encoded, (const char*)shad__spirv_vertex_code_kitchensink, sizeof(shad__spirv_vertex_code_kitchensink));
+        assert(encoded.len < (int)sizeof(shad__spirv_vertex_code_kitchensink)/2);
+        ASSERT_EQ_INT(shad__spirv_decoded_words(encoded.buf, encoded.len), 364);
+        assert(shad__spirv_decode(encoded.buf, encoded.len, decoded));
+        ASSERT_EQ_INT(memcmp(decoded, shad__spirv_vertex_code_kitchensink, sizeof(shad__spirv_vertex_code_kitchensink)), 0);
+        assert(!shad__spirv_decode(encoded.buf, encoded.len-1, decoded));
+        free(decoded);
+        shad__arena_destroy(&arena);
+
+        /* a header can't claim more words than the data holds */
+        ASSERT_EQ_INT(shad__spirv_decoded_words("\xff\xff\xff\x7f\x01\x00", 6), -1);
+        ASSERT_EQ_INT(shad__spirv_decoded_words("\x02\x00\x00\x00\x00\x00", 6), -1);
+
+        /* large opcodes take 3 varint bytes */
+        {
+            unsigned words[64];
+            int w;
+            words[0] = SHAD__SPIRV_MAGIC;
+            for (w = 1; w < 64; ++w) words[w] = w < 5 ? 0 : (1u << 16) | 0xffff;
+            memset(&arena, 0, sizeof(arena));
+            memset(&encoded, 0, sizeof(encoded));
+            encoded.arena = &arena;
+            shad__spirv_encode(&encoded, (const char*)words, sizeof(words));
+            decoded = (unsigned*)malloc(sizeof(words));
+            ASSERT_EQ_INT(shad__spirv_decoded_words(encoded.buf, encoded.len), 64);
+            assert(shad__spirv_decode(encoded.buf, encoded.len, decoded));
+            ASSERT_EQ_INT(memcmp(decoded, words, sizeof(words)), 0);
+            free(decoded);
+            shad__arena_destroy(&arena);
+        }
+
+        shad_compilation_serialize_compressed(&sc, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize(bytes, num_bytes, &copy));
+        ASSERT_EQ_INT(copy.spirv_fragment_code_size, sc.spirv_fragment_code_size);
+        ASSERT_EQ_INT(memcmp(copy.spirv_fragment_code, sc.spirv_fragment_code, sc.spirv_fragment_code_size), 0);
+        ASSERT_EQ_INT(copy.num_vertex_inputs, 3);
+        shad_compilation_free(&copy);
+    }
+
+    /* hashes are stable across serialization and compaction, and split by what changed */
+    {
+        ShadCompilationHash hash, other;
+        ShadCompilation copy;
+        char *bytes;
+        int num_bytes;
+        uint64_t h = shad_compilation_hash(&sc, &hash);
+        assert(h == hash.all);
+        assert(hash.vertex_spirv != hash.fragment_spirv);
+        assert(hash.pipeline == shad_pipeline_hash_kitchensink);
+        shad_compilation_serialize_compressed(&sc, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize(bytes, num_bytes, &copy));
+        assert(shad_compilation_hash(&copy, &other) == h);
+
+        /* update frequencies only change the full hash */
+        copy.vertex_frequencies.samplers[SHAD_FREQUENCY_PER_FRAME] = 0;
+        copy.vertex_frequencies.samplers[SHAD_FREQUENCY_PER_DRAW] = 1;
+        assert(shad_compilation_hash(&copy, &other) != h);
+        assert(other.pipeline == hash.pipeline);
+        copy.vertex_frequencies = sc.vertex_frequencies;
+
+        /* and a frequency count can't exceed the resource count, even if the total matches */
+        {
+            char *freq = (char*)shad__v2_find(bytes, "FREQ", NULL, NULL);
+            unsigned count = shad__get_u32(freq), next = shad__get_u32(freq + 4);
+            ShadCompilation bad;
+            shad__put_u32(freq, 0xffffffffu);
+            shad__put_u32(freq + 4, next + count + 1);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+            assert(!shad_compilation_deserialize(bytes, num_bytes, &bad));
+            shad__put_u32(freq, count);
+            shad__put_u32(freq + 4, next);
+            shad__put_u32(bytes + 12, shad__v2_checksum(bytes, num_bytes));
+        }
+
+        copy.fragment_outputs[0].blend_op = SHAD_BLEND_OP_MIN;
+        assert(shad_compilation_hash(&copy, &other) != h);
+        assert(other.pipeline != hash.pipeline);
+        assert(other.vertex_spirv == hash.vertex_spirv && other.fragment_spirv == hash.fragment_spirv);
+        shad_compilation_free(&copy);
+    }
+
+    /* embed modes only change how the SPIRV is declared */
+    {
+        char *code, *embedded;
+        int len, embedded_len;
+        char first[32];
+        const unsigned char *v = (const unsigned char*)sc.spirv_vertex_code;
+        shad_sdl_serialize_to_c(&sc, "kitchensink", &code, &len);
+        shad_sdl_serialize_to_c_embed(&sc, "kitchensink", SHAD_EMBED_ARRAY, "", &embedded, &embedded_len);
+        assert(len == embedded_len && !memcmp(code, embedded, len));
+        shad_sdl_serialize_to_c_embed(&sc, "kitchensink", SHAD_EMBED_STRING, "", &embedded, &embedded_len);
+        snprintf(first, sizeof(first), "\"\\x%02x\\x%02x\\x%02x\\x%02x", v[0], v[1], v[2], v[3]);
+        assert(strstr(embedded, "SHAD_SPIRV_ALIGN static const char shad__spirv_vertex_code_kitchensink[] =\n    ") && strstr(embedded, first));
+        assert(!strcmp(strstr(embedded, "static const SDL_GPUShaderCreateInfo"), strstr(code, "static const SDL_GPUShaderCreateInfo")));
+        shad_sdl_serialize_to_c_embed(&sc, "kitchensink", SHAD_EMBED_C23, "spv/", &embedded, &embedded_len);
+        assert(strstr(embedded, "SHAD_SPIRV_ALIGN static const unsigned char shad__spirv_fragment_code_kitchensink[] = {\n#embed \"spv/kitchensink.frag.spv\""));
+        shad_serialize_to_asm(&sc, "kitchensink", "spv/", &embedded, &embedded_len);
+        assert(strstr(embedded, ".incbin \"spv/kitchensink.vert.spv\""));
+    }
+
+    /* split into extern declarations and definitions */
+    {
+        char *declarations, *definitions;
+        int declarations_len, definitions_len;
+        shad_sdl_serialize_to_c_split(&sc, "kitchensink", SHAD_EMBED_ARRAY, "", &declarations, &declarations_len, &definitions, &definitions_len);
+        assert(strstr(declarations, "extern const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_kitchensink;\n"));
+        assert(strstr(declarations, "static const Uint64 shad_hash_kitchensink = "));
+        assert(!strstr(declarations, "shad__spirv_vertex_code_kitchensink"));
+        assert(!strncmp(definitions, "static const unsigned shad__spirv_vertex_code_kitchensink[", 58));
+        assert(strstr(definitions, "\nconst SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_kitchensink = {\n"));
+        assert(!strstr(definitions, "shad_hash_kitchensink"));
+    }
+
+    /* the C writer shares identical SPIRV between compilations */
+    {
+        ShadSdlCWriter writer;
+        char *code, *definitions;
+        int len, definitions_len;
+        shad_sdl_c_writer_begin(&writer);
+        shad_sdl_c_writer_add(&writer, "a", &sc, &code, &len, NULL, NULL);
+        assert(strstr(code, "static const unsigned shad__spirv_vertex_code_a["));
+        shad_sdl_c_writer_add(&writer, "b", &sc, &code, &len, NULL, NULL);
+        assert(!strstr(code, "shad__spirv_vertex_code_b") && strstr(code, "(const Uint8*)shad__spirv_fragment_code_a,"));
+        ASSERT_EQ_INT(writer.num_modules, 2);
+        ASSERT_EQ_INT(writer.bytes_deduplicated, sc.spirv_vertex_code_size + sc.spirv_fragment_code_size);
+
+        /* split, the array can be in another file */
+        writer.split = 1;
+        shad_sdl_c_writer_add(&writer, "c", &sc, &code, &len, &definitions, &definitions_len);
+        assert(strstr(code, "extern const SDL_GPUGraphicsPipelineCreateInfo shad_sdl_pipeline_c;"));
+        assert(strstr(definitions, "extern const unsigned shad__spirv_vertex_code_a[];"));
+
+        /* the C++ type only refers to the create infos when they're extern */
+        writer.cpp = 1;
+        shad_sdl_c_writer_add(&writer, "d", &sc, &code, &len, &definitions, &definitions_len);
+        assert(strstr(code, "    static constexpr const SDL_GPUShaderCreateInfo &vertex_shader = shad_sdl_vertex_shader_d;\n"));
+        writer.split = 0;
+        shad_sdl_c_writer_add(&writer, "e", &sc, &code, &len, NULL, NULL);
+        assert(strstr(code, "struct e {\n") && !strstr(code, "&vertex_shader"));
+        shad_sdl_c_writer_end(&writer);
+    }
+
+    /* the generated vertex structs can be written straight into a vertex buffer */
+    {
+        shad_vertex_kitchensink_0 v = {{1, 2, 3}, {255, 0, 0, 255}};
+        ASSERT_EQ_INT(sizeof(v), shad_sdl_pipeline_kitchensink.vertex_input_state.vertex_buffer_descriptions[0].pitch);
+        ASSERT_EQ_INT(offsetof(shad_vertex_kitchensink_0, v2), shad_sdl_pipeline_kitchensink.vertex_input_state.vertex_attributes[2].offset);
+        ASSERT_EQ_INT(((unsigned char*)&v)[12], 255);
+        ASSERT_EQ_INT(sizeof(shad_vertex_kitchensink_3), 12);
+    }
+
+    /* block structs follow the std140 offsets in the SPIRV. This module is
+         layout(std140, set = 1, binding = 0) uniform Uniform0 {vec3 a; float b; float c[2]; mat4 m; S s[2];};  struct S {vec2 x;};
+         layout(std140, set = 0, binding = 0) buffer Buffer0 {vec4 d[];}; */
+    {
+        static const unsigned spirv[] = {
+            0x07230203, 0x00010000, 0, 18, 0,
+            (4<<16)|6, 11, 0, 'a', (4<<16)|6, 11, 1, 'b', (4<<16)|6, 11, 2, 'c', (4<<16)|6, 11, 3, 'm', (4<<16)|6, 11, 4, 's', (4<<16)|6, 9, 0, 'x',
+            (4<<16)|71, 8, 6, 16, (4<<16)|71, 10, 6, 16, (4<<16)|71, 14, 6, 16,
+            (5<<16)|72, 9, 0, 35, 0,
+            (5<<16)|72, 11, 0, 35, 0, (5<<16)|72, 11, 1, 35, 12, (5<<16)|72, 11, 2, 35, 16, (5<<16)|72, 11, 3, 35, 48, (5<<16)|72, 11, 4, 35, 112,
+            (4<<16)|72, 11, 3, 5, (5<<16)|72, 11, 3, 7, 16,
+            (5<<16)|72, 15, 0, 35, 0,
+            (3<<16)|71, 11, 2, (4<<16)|71, 13, 34, 1, (4<<16)|71, 13, 33, 0,
+            (3<<16)|71, 15, 2, (4<<16)|71, 17, 34, 0, (4<<16)|71, 17, 33, 0,
+            (3<<16)|22, 1, 32, (4<<16)|23, 2, 1, 2, (4<<16)|23, 3, 1, 3, (4<<16)|23, 4, 1, 4, (4<<16)|24, 5, 4, 4,
+            (4<<16)|21, 6, 32, 0, (4<<16)|43, 6, 7, 2,
+            (4<<16)|28, 8, 1, 7, (3<<16)|30, 9, 2, (4<<16)|28, 10, 9, 7, (7<<16)|30, 11, 3, 1, 8, 5, 10,
+            (4<<16)|32, 12, 2, 11, (4<<16)|59, 12, 13, 2,
+            (3<<16)|29, 14, 4, (3<<16)|30, 15, 14, (4<<16)|32, 16, 12, 15, (4<<16)|59, 16, 17, 12,
+        };
+        ShadCompilation blocks;
+        ShadArena arena;
+        ShadWriter w;
+        memset(&blocks, 0, sizeof(blocks));
+        memset(&arena, 0, sizeof(arena));
+        memset(&w, 0, sizeof(w));
+        w.arena = &arena;
+        blocks.spirv_vertex_code = (char*)spirv;
+        blocks.spirv_vertex_code_size = sizeof(spirv);
+        shad__sdl_write_c_block_structs(&w, &blocks, "t", NULL);
+        assert(strstr(w.buf, "typedef struct shad_vertex_uniform_t_0_s {\n    float x[2];\n    Uint8 _pad0[8];\n} shad_vertex_uniform_t_0_s;\n"));
+        assert(strstr(w.buf, "    float a[3];\n    float b;\n    float c[2][4];\n    float m[4][4];\n    shad_vertex_uniform_t_0_s s[2];\n} shad_vertex_uniform_t_0;\n"));
+        assert(strstr(w.buf, "sizeof(shad_vertex_uniform_t_0) == 144);"));
+        assert(strstr(w.buf, "offsetof(shad_vertex_uniform_t_0, s) == 112);"));
+        assert(strstr(w.buf, "typedef float shad_vertex_buffer_t_0[4];\n"));
+        shad__arena_destroy(&arena);
+    }
+
+    /* a pre-sized writer gets exactly what was reserved, appends past that grow it */
+    {
+        ShadArena arena;
+        ShadWriter w;
+        memset(&arena, 0, sizeof(arena));
+        memset(&w, 0, sizeof(w));
+        w.arena = &arena;
+        shad__writer_reserve(&w, 100);
+        ASSERT_EQ_INT(w.cap, 101);
+        shad__writer_print(&w, "%s", "hello");
+        ASSERT_EQ_INT(w.cap, 101);
+        shad__writer_reserve(&w, 100);
+        assert(w.cap >= 106 && !strcmp(w.buf, "hello"));
+        shad__arena_destroy(&arena);
+    }
+
+    /* malformed type info (say from a corrupt blob) is skipped: cyclic and undefined types, a truncated
+       OpTypeInt, a redefined id and a member name without a terminator */
+    {
+        static const unsigned spirv[] = {
+            0x07230203, 0x00010000, 0, 10, 0,
+            (4<<16)|6, 6, 0, 0x61616161,
+            (3<<16)|71, 5, 2, (3<<16)|71, 6, 2, (4<<16)|71, 7, 34, 1, (4<<16)|71, 7, 33, 0,
+            (4<<16)|23, 2, 3, 4, (4<<16)|23, 3, 2, 4, (3<<16)|21, 4, 32,
+            (3<<16)|22, 1, 32, (4<<16)|23, 1, 1, 4,
+            (4<<16)|30, 5, 2, 1, (3<<16)|30, 6, 1,
+            (4<<16)|32, 8, 2, 6, (4<<16)|59, 8, 7, 2,
+        };
+        ShadCompilation blocks;
+        ShadArena arena;
+        ShadWriter w;
+        memset(&blocks, 0, sizeof(blocks));
+        memset(&arena, 0, sizeof(arena));
+        memset(&w, 0, sizeof(w));
+        w.arena = &arena;
+        blocks.spirv_vertex_code = (char*)spirv;
+        blocks.spirv_vertex_code_size = sizeof(spirv);
+        shad__sdl_write_c_block_structs(&w, &blocks, "t", NULL);
+        assert(strstr(w.buf, "typedef struct shad_vertex_uniform_t_0 {\n    float member0;\n} shad_vertex_uniform_t_0;\n"));
+        shad__arena_destroy(&arena);
+    }
+
+    /* creating everything in the registry, with stubs instead of a GPU */
+    {
+        ShadSdlCreateCallbacks callbacks = {stub_create_shader, stub_create_pipeline};
+        ShadSdlCreated created[shad_test_shaders_COUNT];
+        assert(shad_test_shaders_create_all(NULL, stub_parallel_for, NULL, &callbacks, created));
+        ASSERT_EQ_INT(stub_tasks_run, 1);
+        ASSERT_EQ_INT(stub_shaders_created, 2);
+        ASSERT_EQ_INT(stub_pipelines_created, 1);
+        assert(created[0].vertex_shader == (SDL_GPUShader*)&shad_sdl_vertex_shader_kitchensink);
+        assert(created[0].fragment_shader == (SDL_GPUShader*)&shad_sdl_fragment_shader_kitchensink);
+        assert(created[0].pipeline);
+
+        /* no pipeline without its shaders */
+        stub_fail_shaders = 1;
+        assert(!shad_test_shaders_create_all(NULL, NULL, NULL, &callbacks, created));
+        assert(!created[0].vertex_shader && !created[0].pipeline);
+        ASSERT_EQ_INT(stub_pipelines_created, 1);
+    }
+
+    /* the generated registry, and its perfect hash for lots of names */
+    {
+        uint64_t hashes[1000];
+        char name[32], seen[1000] = {0};
+        unsigned *displacements;
+        int num_buckets, i;
+        assert(shad_test_shaders_find("kitchensink")->pipeline == &shad_sdl_pipeline_kitchensink);
+        assert(shad_test_shaders_find("kitchensink")->hash == shad_hash_kitchensink);
+        assert(!shad_test_shaders_find("kitchen"));
+        for (i = 0; i < 1000; ++i) {
+            snprintf(name, sizeof(name), "shader_%i", i);
+            hashes[i] = shad__name_hash(name);
+        }
+        displacements = shad__registry_build(hashes, 1000, &num_buckets);
+        assert(displacements);
+        for (i = 0; i < 1000; ++i) {
+            int slot = shad__registry_slot(hashes[i], displacements, num_buckets, 1000);
+            assert(!seen[slot]);
+            seen[slot] = 1;
+        }
+        free(displacements);
+    }
+
+    /* compact keeps everything needed at runtime */
+    {
+        char *spirv = (char*)malloc(sc.spirv_fragment_code_size);
+        int spirv_size = sc.spirv_fragment_code_size;
+        uint64_t h = shad_compilation_hash(&sc, NULL);
+        memcpy(spirv, sc.spirv_fragment_code, spirv_size);
+        shad_compilation_compact(&sc);
+        assert(shad_compilation_hash(&sc, NULL) == h);
+        assert(!sc.vertex_code && !sc.fragment_code);
+        assert(!sc.vertex_inputs[0].name);
+        ASSERT_EQ_INT(sc.num_vertex_inputs, 3);
+        ASSERT_EQ_INT(sc.vertex_inputs[2].format, SHAD_VERTEXELEMENTFORMAT_UBYTE4_NORM);
+        ASSERT_EQ_INT(sc.vertex_input_buffers[1].stride, 12);
+        ASSERT_EQ_INT(sc.fragment_outputs[1].blend_op, SHAD_BLEND_OP_SUBTRACT);
+        ASSERT_EQ_INT(sc.spirv_fragment_code_size, spirv_size);
+        ASSERT_EQ_INT(memcmp(sc.spirv_fragment_code, spirv, spirv_size), 0);
+        free(spirv);
+    }
+
+    /* filling into caller storage matches the generated pipeline */
+    {
+        ShadSdlPipelineStorage storage;
+        SDL_GPUGraphicsPipelineCreateInfo pinfo;
+        assert(shad_sdl_fill_pipeline_storage(&pinfo, &storage, &sc));
+        assert(pinfo.vertex_input_state.vertex_buffer_descriptions == storage.vertex_buffer_descriptions);
+        assert(pinfo.target_info.color_target_descriptions == storage.color_target_descriptions);
+        ASSERT_EQ_INT(pinfo.vertex_input_state.num_vertex_buffers, 2);
+        ASSERT_EQ_INT(pinfo.vertex_input_state.num_vertex_attributes, 3);
+        ASSERT_EQ_INT(pinfo.vertex_input_state.vertex_buffer_descriptions[1].slot, 3);
+        ASSERT_EQ_INT(pinfo.vertex_input_state.vertex_buffer_descriptions[1].input_rate, SDL_GPU_VERTEXINPUTRATE_INSTANCE);
+        ASSERT_EQ_INT(pinfo.vertex_input_state.vertex_attributes[2].format, SDL_GPU_VERTEXELEMENTFORMAT_UBYTE4_NORM);
+        ASSERT_EQ_INT(pinfo.target_info.num_color_targets, 3);
+        ASSERT_EQ_INT(pinfo.target_info.color_target_descriptions[2].format, SDL_GPU_TEXTUREFORMAT_R11G11B10_UFLOAT);
+        ASSERT_EQ_INT(pinfo.target_info.depth_stencil_format, SDL_GPU_TEXTUREFORMAT_D24_UNORM);
+    }
+
+    /* the pretranslated SDLP arrays are the same as translating on the fly */
+    {
+        ShadSdlPipelineStorage translated, pretranslated;
+        SDL_GPUGraphicsPipelineCreateInfo tinfo, pinfo;
+        ShadCompilation view;
+        char *bytes;
+        int num_bytes;
+        memset(&translated, 0, sizeof(translated));
+        memset(&pretranslated, 0, sizeof(pretranslated));
+        shad_compilation_serialize(&sc, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize_view(bytes, num_bytes, &view));
+        assert(!sc.sdl_pipeline && view.sdl_pipeline);
+        assert(shad_sdl_fill_pipeline_storage(&tinfo, &translated, &sc));
+        assert(shad_sdl_fill_pipeline_storage(&pinfo, &pretranslated, &view));
+        ASSERT_EQ_INT(memcmp(&translated, &pretranslated, sizeof(translated)), 0);
+        ASSERT_EQ_INT(pinfo.target_info.num_color_targets, 3);
+        assert(pinfo.target_info.color_target_descriptions == pretranslated.color_target_descriptions);
+        ASSERT_EQ_INT(pinfo.target_info.color_target_descriptions[2].blend_state.enable_blend, true);
+        shad_compilation_free(&view);
+    }
+
+    /* the registry shares identical pipelines and shader stages */
+    {
+        ShadSdlRegistry reg;
+        ShadCompilation copy;
+        SDL_GPUGraphicsPipeline *a, *b, *c;
+        char *bytes;
+        int num_bytes;
+        shad_sdl_registry_init(&reg, NULL);
+        reg.create_shader = stub_registry_create_shader;
+        reg.create_pipeline = stub_registry_create_pipeline;
+        reg.release_shader = stub_registry_release_shader;
+        reg.release_pipeline = stub_registry_release_pipeline;
+        shad_compilation_serialize(&sc, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize(bytes, num_bytes, &copy));
+        a = shad_sdl_registry_acquire(&reg, &sc);
+        b = shad_sdl_registry_acquire(&reg, &copy);
+        assert(a && a == b);
+        copy.cull_mode = SHAD_CULL_MODE_BACK;
+        c = shad_sdl_registry_acquire(&reg, &copy);
+        assert(c && c != a);
+        ASSERT_EQ_INT(reg.num_pipelines, 2);
+        ASSERT_EQ_INT(reg.num_shaders, 2);
+        ASSERT_EQ_INT(reg.num_reused_pipelines, 1);
+        ASSERT_EQ_INT(reg.num_reused_shaders, 2);
+        shad_sdl_registry_release(&reg, a);
+        shad_sdl_registry_release(&reg, c);
+        ASSERT_EQ_INT(reg.num_pipelines, 1);
+        ASSERT_EQ_INT(reg.num_shaders, 2);
+        shad_sdl_registry_release(&reg, b);
+        ASSERT_EQ_INT(reg.num_pipelines, 0);
+        ASSERT_EQ_INT(reg.num_shaders, 0);
+
+        /* lots of distinct pipelines coming and going */
+        copy.sdl_pipeline = NULL;
+        for (res = 0; res < 1000; ++res) {
+            copy.vertex_input_buffers[0].stride = 16 + res;
+            a = shad_sdl_registry_acquire(&reg, &copy);
+            assert(a);
+            if (res % 3) shad_sdl_registry_release(&reg, a);
+        }
+        ASSERT_EQ_INT(reg.num_pipelines, 334);
+        ASSERT_EQ_INT(reg.num_shaders, 2);
+        ASSERT_EQ_INT(stub_objects_live, 336);
+        shad_sdl_registry_destroy(&reg);
+        ASSERT_EQ_INT(stub_objects_live, 0);
+        shad_compilation_free(&copy);
+    }
+
     ASSERT_EQ_INT(shad_sdl_pipeline_kitchensink.vertex_input_state.num_vertex_buffers, 2);
     ASSERT_EQ_INT(shad_sdl_pipeline_kitchensink.vertex_input_state.num_vertex_attributes, 3);
     ASSERT_EQ_INT(shad_sdl_pipeline_kitchensink.vertex_input_state.vertex_buffer_descriptions[0].slot, 0);
@@ -60,11 +551,224 @@ int main(int argc, char const *argv[]) {
     ASSERT_EQ_INT(shad_sdl_vertex_shader_kitchensink.num_storage_textures, 1);
     ASSERT_EQ_INT(shad_sdl_vertex_shader_kitchensink.num_uniform_buffers, 1);
 
+    /* slots go by update frequency, then declaration order */
+    {
+        ShadCompilation freq, copy;
+        char *bytes;
+        int num_bytes;
+        assert(shad_compile("frequency.shader", SHAD_OUTPUT_FORMAT_SDL, &freq));
+        assert(strstr(freq.vertex_code, "layout(std140, set = 1, binding = 0) uniform Uniform0 {mat4 view_projection;}"));
+        assert(strstr(freq.vertex_code, "layout(std140, set = 1, binding = 1) uniform Uniform1 {mat4 model;}"));
+        assert(strstr(freq.fragment_code, "layout(set = 2, binding = 0) uniform sampler2D shadow_map;"));
+        assert(strstr(freq.fragment_code, "layout(set = 2, binding = 1) uniform sampler2D albedo;"));
+        assert(strstr(freq.fragment_code, "layout(set = 2, binding = 2) uniform sampler2D detail;"));
+        assert(strstr(freq.fragment_code, "layout(set = 2, binding = 3, rgba8) uniform readonly image2D lut;"));
+        assert(strstr(freq.fragment_code, "layout(set = 2, binding = 4, rgba8) uniform readonly image2D mask;"));
+        assert(strstr(freq.fragment_code, "layout(std140, set = 2, binding = 5) buffer readonly Buffer5 {vec4 palette[];}"));
+        ASSERT_EQ_INT(freq.vertex_frequencies.uniforms[SHAD_FREQUENCY_PER_FRAME], 1);
+        ASSERT_EQ_INT(freq.vertex_frequencies.uniforms[SHAD_FREQUENCY_PER_DRAW], 1);
+        ASSERT_EQ_INT(freq.fragment_frequencies.samplers[SHAD_FREQUENCY_PER_FRAME], 1);
+        ASSERT_EQ_INT(freq.fragment_frequencies.samplers[SHAD_FREQUENCY_PER_MATERIAL], 1);
+        ASSERT_EQ_INT(freq.fragment_frequencies.samplers[SHAD_FREQUENCY_PER_DRAW], 1);
+        ASSERT_EQ_INT(freq.fragment_frequencies.images[SHAD_FREQUENCY_PER_MATERIAL], 0);
+        ASSERT_EQ_INT(freq.fragment_frequencies.buffers[SHAD_FREQUENCY_PER_MATERIAL], 1);
+        ASSERT_EQ_INT(freq.fragment_frequencies.uniforms[SHAD_FREQUENCY_PER_MATERIAL], 1);
+
+        /* and survive serialization */
+        shad_compilation_serialize(&freq, &bytes, &num_bytes);
+        assert(shad_compilation_deserialize(bytes, num_bytes, &copy));
+        ASSERT_EQ_INT(memcmp(&copy.vertex_frequencies, &freq.vertex_frequencies, sizeof(freq.vertex_frequencies)), 0);
+        ASSERT_EQ_INT(memcmp(&copy.fragment_frequencies, &freq.fragment_frequencies, sizeof(freq.fragment_frequencies)), 0);
+        shad_compilation_free(&copy);
+        shad_compilation_free(&freq);
+    }
+
+    /* generated bind helpers skip what's already pushed and bound. There's no GPU, SDL just rejects the NULL pass */
+    {
+        ShadSdlBindCache cache;
+        shad_vertex_uniform_kitchensink_0 u = {42};
+        SDL_GPUTextureSamplerBinding s1 = {(SDL_GPUTexture*)&u, NULL};
+        SDL_GPUTextureSamplerBinding bindings[3] = {{(SDL_GPUTexture*)&u, NULL}, {(SDL_GPUTexture*)&s1, NULL}, {(SDL_GPUTexture*)&cache, NULL}};
+
+        shad_sdl_bind_cache_begin(&cache, NULL, NULL);
+        shad_bind_kitchensink_per_frame(&cache, s1, &u);
+        ASSERT_EQ_INT(cache.num_skipped, 0);
+        shad_bind_kitchensink_per_frame(&cache, s1, &u);
+        ASSERT_EQ_INT(cache.num_skipped, 2);
+        u.u1 = 43;
+        shad_bind_kitchensink_per_frame(&cache, s1, &u);
+        ASSERT_EQ_INT(cache.num_skipped, 3);
+        ASSERT_EQ_INT(memcmp(cache.uniforms[0][0], &u, sizeof(u)), 0);
+
+        /* only what changed is rebound */
+        shad_sdl_bind_samplers(&cache, 1, 0, bindings, 3);
+        bindings[1].sampler = (SDL_GPUSampler*)&u;
+        shad_sdl_bind_samplers(&cache, 1, 0, bindings, 3);
+        assert(cache.samplers[1][1].sampler == (SDL_GPUSampler*)&u);
+        shad_sdl_bind_samplers(&cache, 1, 0, bindings, 3);
+        ASSERT_EQ_INT(cache.num_skipped, 4);
+
+        /* a new render pass starts with nothing bound */
+        shad_sdl_bind_cache_begin(&cache, NULL, NULL);
+        shad_bind_kitchensink_per_frame(&cache, s1, &u);
+        ASSERT_EQ_INT(cache.num_skipped, 0);
+    }
+
     assert(shad_compile("import.shader", SHAD_OUTPUT_FORMAT_SDL, &sc));
     assert(!sc.has_fragment_shader);
     ASSERT_EQ_INT(sc.num_vertex_samplers, 1);
     ASSERT_EQ_INT(sc.num_vertex_buffers, 1);
 
+    /* packs, with the same shader stored twice */
+    {
+        ShadPackWriter writer;
+        ShadPack pack;
+        ShadCompilation ks, a, b;
+        assert(shad_compile("kitchensink.shader", SHAD_OUTPUT_FORMAT_SDL, &ks));
+        assert(shad_pack_writer_begin(&writer, "test.shadpack"));
+        assert(shad_pack_writer_add(&writer, "kitchensink", &ks));
+        assert(shad_pack_writer_add(&writer, "import", &sc));
+        assert(shad_pack_writer_add(&writer, "kitchensink2", &ks));
+        ASSERT_EQ_INT(writer.bytes_deduplicated, ks.spirv_vertex_code_size + ks.spirv_fragment_code_size);
+        assert(shad_pack_writer_end(&writer));
+
+        assert(shad_pack_open("test.shadpack", &pack));
+        ASSERT_EQ_INT(pack.num_entries, 3);
+        ASSERT_EQ_INT(shad_pack_find(&pack, "kitchensink2"), 2);
+        ASSERT_EQ_INT(shad_pack_find(&pack, "missing"), -1);
+        assert(SHAD_STREQ(shad_pack_name(&pack, 1), "import"));
+        assert(shad_pack_get(&pack, "kitchensink", &a));
+        assert(shad_pack_get(&pack, "kitchensink2", &b));
+        assert(a.spirv_vertex_code == b.spirv_vertex_code);
+        ASSERT_EQ_INT(a.spirv_vertex_code_size, ks.spirv_vertex_code_size);
+        ASSERT_EQ_INT(memcmp(a.spirv_vertex_code, ks.spirv_vertex_code, ks.spirv_vertex_code_size), 0);
+        ASSERT_EQ_INT(memcmp(b.spirv_fragment_code, ks.spirv_fragment_code, ks.spirv_fragment_code_size), 0);
+        ASSERT_EQ_INT(b.num_vertex_inputs, 3);
+        ASSERT_EQ_INT(b.vertex_input_buffers[1].stride, 12);
+        ASSERT_EQ_INT(b.fragment_outputs[1].blend_op, SHAD_BLEND_OP_SUBTRACT);
+        shad_compilation_free(&a);
+        shad_compilation_free(&b);
+        assert(shad_pack_get(&pack, "import", &a));
+        assert(!a.has_fragment_shader);
+        ASSERT_EQ_INT(a.num_vertex_samplers, 1);
+        shad_compilation_free(&a);
+
+        /* background loading */
+        {
+            ShadPackLoader loader;
+            ShadPackLoadResult result;
+            int loaded = 0;
+            assert(shad_pack_loader_start(&loader, &pack));
+            assert(!shad_pack_loader_request(&loader, "missing", 0, NULL));
+            assert(shad_pack_loader_request(&loader, "import", 0, &pack));
+            assert(shad_pack_loader_request(&loader, "kitchensink", 1, &writer));
+            while (shad_pack_loader_wait(&loader, &result)) {
+                assert(result.ok);
+                if (result.userdata == &writer) {
+                    ASSERT_EQ_INT(result.index, 0);
+                    ASSERT_EQ_INT(result.compilation.num_vertex_inputs, 3);
+                } else {
+                    assert(result.userdata == &pack);
+                    assert(!result.compilation.has_fragment_shader);
+                }
+                shad_compilation_free(&result.compilation);
+                ++loaded;
+            }
+            ASSERT_EQ_INT(loaded, 2);
+            assert(!shad_pack_loader_poll(&loader, &result));
+            shad_pack_loader_stop(&loader);
+        }
+
+        /* loader queue order: highest priority first, then oldest */
+        {
+            ShadPackLoader loader;
+            ShadPackLoaderRequest r;
+            int priorities[] = {0, 5, 1, 5, 3};
+            int expected[] = {1, 3, 4, 2, 0};
+            int i;
+            memset(&loader, 0, sizeof(loader));
+            for (i = 0; i < 5; ++i) {
+                r.priority = priorities[i];
+                r.seq = loader.seq++;
+                r.index = i;
+                r.userdata = NULL;
+                shad__loader_heap_push(&loader, r);
+            }
+            for (i = 0; i < 5; ++i)
+                ASSERT_EQ_INT(shad__loader_heap_pop(&loader).index, expected[i]);
+            free(loader.requests);
+        }
+
+        /* an index without empty slots would make lookups of missing names probe forever */
+        {
+            ShadPack full;
+            char *data = (char*)malloc(pack.size);
+            unsigned i;
+            memcpy(data, pack.data, pack.size);
+            assert(shad_pack_open_memory(data, pack.size, &full));
+            for (i = 0; i < shad__get_u32(data + 24); ++i)
+                shad__put_u32(data + shad__get_u32(data + 20) + i*4, 1);
+            assert(!shad_pack_open_memory(data, pack.size, &full));
+            free(data);
+        }
+        shad_pack_close(&pack);
+
+        /* compressed */
+        assert(shad_pack_writer_begin(&writer, "test.shadpack"));
+        writer.compress_spirv = 1;
+        assert(shad_pack_writer_add(&writer, "kitchensink", &ks));
+        assert(shad_pack_writer_end(&writer));
+        assert(shad_pack_open("test.shadpack", &pack));
+        assert(shad_pack_get(&pack, "kitchensink", &a));
+        ASSERT_EQ_INT(a.spirv_fragment_code_size, ks.spirv_fragment_code_size);
+        ASSERT_EQ_INT(memcmp(a.spirv_fragment_code, ks.spirv_fragment_code, ks.spirv_fragment_code_size), 0);
+        shad_compilation_free(&a);
+        shad_pack_close(&pack);
+
+        shad_compilation_free(&ks);
+        remove("test.shadpack");
+    }
+
+    /* ELF objects, the symbols point at the SPIRV */
+    {
+        ShadElfWriter writer;
+        ShadCompilation ks;
+        static char obj[1 << 16];
+        const char *sections, *symtab, *strtab;
+        int size, i, found = 0;
+        FILE *f;
+
+        assert(shad_compile("kitchensink.shader", SHAD_OUTPUT_FORMAT_SDL, &ks));
+        assert(shad_elf_writer_begin(&writer, "test.o"));
+        writer.machine = SHAD_ELF_MACHINE_AARCH64;
+        assert(shad_elf_writer_add(&writer, "kitchensink", &ks));
+        assert(shad_elf_writer_add(&writer, "copy", &ks));
+        ASSERT_EQ_INT(writer.num_symbols, 4);
+        ASSERT_EQ_INT(writer.bytes_deduplicated, ks.spirv_vertex_code_size + ks.spirv_fragment_code_size);
+        assert(shad_elf_writer_end(&writer));
+
+        f = fopen("test.o", "rb");
+        size = (int)fread(obj, 1, sizeof(obj), f);
+        fclose(f);
+        assert(size < (int)sizeof(obj) && !memcmp(obj, "\x7f" "ELF\x02\x01", 6));
+        ASSERT_EQ_INT(obj[18] & 0xff, 183);
+        sections = obj + shad__get_u32(obj + 40);
+        symtab = obj + shad__get_u32(sections + 2*64 + 24);
+        strtab = obj + shad__get_u32(sections + 3*64 + 24);
+        for (i = 2; i < (int)shad__get_u32(sections + 2*64 + 32) / 24; ++i) {
+            const char *sym = symtab + i*24;
+            const char *data = obj + shad__get_u32(sections + 64 + 24) + shad__get_u32(sym + 8);
+            if (strcmp(strtab + shad__get_u32(sym), "shad__spirv_fragment_code_kitchensink")) continue;
+            ASSERT_EQ_INT((int)shad__get_u32(sym + 16), ks.spirv_fragment_code_size);
+            ASSERT_EQ_INT(memcmp(data, ks.spirv_fragment_code, ks.spirv_fragment_code_size), 0);
+            found = 1;
+        }
+        assert(found);
+
+        shad_compilation_free(&ks);
+        remove("test.o");
+    }
+
     fprintf(stderr, "\n\nTests passed!");
     return 0;
 }
@@ -0,0 +1,73 @@
+#include <SDL3/SDL.h>
+#include "shad.hpp"
+#include "shad.c"
+#include "kitchensink.hpp"
+#include <assert.h>
+#include <type_traits>
+
+static_assert(!std::is_copy_constructible_v<shad::Compilation>);
+static_assert(std::is_nothrow_move_constructible_v<shad::Compilation>);
+
+/* registry lookups can happen at compile time */
+static_assert(shad_name_hash("kitchensink") == 0x12684790abd01f00ull);
+static_assert(shad_test_shaders_slot("kitchensink") == 0);
+
+/* the pipeline is known at compile time, and so are the structs of each slot */
+using Kitchensink = shad::shaders::kitchensink;
+static_assert(Kitchensink::pipeline.vertex_input_state.num_vertex_attributes == 3);
+static_assert(Kitchensink::pipeline.vertex_input_state.vertex_attributes[2].offset == 12);
+static_assert(Kitchensink::pipeline.target_info.color_target_descriptions[1].blend_state.color_blend_op == SDL_GPU_BLENDOP_SUBTRACT);
+static_assert(Kitchensink::num_fragment_uniform_buffers == 1);
+static_assert(std::is_same_v<shad::vertex_buffer<Kitchensink, 3>::type, shad_vertex_kitchensink_3>);
+static_assert(std::is_same_v<shad::fragment_uniform<Kitchensink, 0>::type, shad_fragment_uniform_kitchensink_0>);
+
+/* a vertex-only shader has empty placeholders for the rest, which C++ needs initialized */
+static_assert(shad::shaders::import::pipeline.target_info.num_color_targets == 0);
+static_assert(shad::shaders::import::num_fragment_samplers == 0);
+
+template <class T, class = void> struct has_type : std::false_type {};
+template <class T> struct has_type<T, std::void_t<typename T::type>> : std::true_type {};
+static_assert(has_type<shad::vertex_uniform<Kitchensink, 0>>::value);
+static_assert(!has_type<shad::vertex_uniform<Kitchensink, 1>>::value);
+static_assert(!has_type<shad::vertex_buffer<Kitchensink, 1>>::value);
+
+int main() {
+    auto sc = shad::Compilation::compile("kitchensink.shader");
+    assert(sc && *sc);
+    assert(sc->vertex_inputs().size() == 3);
+    assert(sc->vertex_inputs()[2].format == SHAD_VERTEXELEMENTFORMAT_UBYTE4_NORM);
+    assert(sc->vertex_input_buffers()[1].stride == 12);
+    assert(sc->fragment_outputs().size() == 3);
+    assert(sc->vertex_spirv().size() * 4 == (size_t)(*sc)->spirv_vertex_code_size);
+    assert(sc->vertex_spirv()[0] == 0x07230203u);
+    assert(!shad::Compilation::compile("instancing.shader"));
+    assert(shad_test_shaders_find("kitchensink")->vertex_shader == &shad_sdl_vertex_shader_kitchensink);
+    assert(shad_test_shaders_find("import")->fragment_shader->code_size == 0);
+    shad::push_vertex_uniform<Kitchensink, 0>(nullptr, shad_vertex_uniform_kitchensink_0{42});
+
+    /* moving transfers ownership, the moved-from compilation is empty */
+    shad::Compilation moved = std::move(*sc);
+    assert(moved && !*sc);
+    assert(sc->vertex_inputs().empty());
+
+    /* serialize round trip */
+    {
+        std::span<const char> bytes = moved.serialize();
+        auto copy = shad::Compilation::deserialize(bytes);
+        auto view = shad::Compilation::deserialize_view(bytes);
+        assert(copy && view);
+        assert(copy->hash() == moved.hash());
+        assert(view->fragment_spirv().data() > (const uint32_t*)bytes.data());
+        assert(!shad::Compilation::deserialize(bytes.first(bytes.size() - 4)));
+    }
+
+    /* handing a compilation to C code */
+    {
+        ShadCompilation c = moved.release();
+        assert(!moved);
+        shad_compilation_free(&c);
+    }
+
+    printf("C++ tests passed!\n");
+    return 0;
+}